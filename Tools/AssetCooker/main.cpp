@@ -0,0 +1,97 @@
+#include "Assets/AssetCooker.h"
+#include "Assets/CookDatabase.h"
+#include "Jobs/JobSystem.h"
+#include "Logging/Logger.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+static void WriteReport(std::ostream& stream, const CHIKU::CookSummary& summary)
+{
+	for (const auto& rebuild : CHIKU::CookDatabase::GetRebuilds())
+	{
+		stream << rebuild.Output << ": " << CHIKU::CookDatabase::ToString(rebuild.Reason);
+		if (!rebuild.Detail.empty())
+			stream << " (" << rebuild.Detail << ")";
+		stream << "\n";
+	}
+
+	stream << summary.Cooked << " cooked, " << summary.UpToDate << " up to date, " << summary.Failed << " failed" << std::endl;
+}
+
+static int Cook(const std::string& directory, const std::string& packPath, const std::string& reportPath)
+{
+	CHIKU::CookDatabase::Load();
+
+	auto start = std::chrono::high_resolution_clock::now();
+	CHIKU::CookSummary summary = CHIKU::AssetCooker::CookDirectory(directory);
+	float elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	//Saved before the registry, whatever cooked stays cooked even when the index fails
+	CHIKU::CookDatabase::Save();
+
+	WriteReport(std::cout, summary);
+	std::cout << "Took " << elapsed << " ms on " << CHIKU::JobSystem::GetWorkerCount() + 1 << " threads" << std::endl;
+
+	if (!reportPath.empty())
+	{
+		std::ofstream report(reportPath, std::ios::trunc);
+		if (!report)
+		{
+			std::cerr << "Failed to write the cook report: " << reportPath << std::endl;
+			return 1;
+		}
+
+		WriteReport(report, summary);
+	}
+
+	//Written even when something failed, the index only points at files and stays usable for everything that did cook
+	try
+	{
+		CHIKU::AssetCooker::WriteRegistry(packPath);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Failed to write the asset registry: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return summary.Failed == 0 ? 0 : 1;
+}
+
+//Does all import work ahead of time, compiles shaders, converts FBX models, cooks materials and rebuilds the registry index.
+//Only steps whose inputs, tool or settings changed since the last cook run, the report lists them and why.
+//Usage: AssetCooker [directory] [--pack <Assets.pak>] [--report <report.txt>]
+//The directory is relative to the engine source directory and defaults to all of it.
+int main(int argc, char** argv)
+{
+	std::string directory;
+	std::string packPath;
+	std::string reportPath;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--pack" && i + 1 < argc)
+			packPath = argv[++i];
+		else if (argument == "--report" && i + 1 < argc)
+			reportPath = argv[++i];
+		else if (directory.empty() && !argument.starts_with("--"))
+			directory = argument;
+		else
+		{
+			std::cerr << "Usage: AssetCooker [directory] [--pack <Assets.pak>] [--report <report.txt>]" << std::endl;
+			return 1;
+		}
+	}
+
+	CHIKU::Logger::Init("AssetCooker");
+	//One job per asset, every core cooks
+	CHIKU::JobSystem::Init();
+
+	int result = Cook(directory, packPath, reportPath);
+
+	CHIKU::JobSystem::CleanUp();
+	CHIKU::Logger::Shutdown();
+	return result;
+}
@@ -0,0 +1,92 @@
+#include "Assets/AssetRegistry.h"
+#include "IO/PackFile.h"
+#include "Jobs/JobSystem.h"
+#include "Logging/Logger.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+static int Build(const std::string& jsonPath, const std::string& outputPath, const std::string& sourceDirectory, const std::string& packPath)
+{
+	try
+	{
+		CHIKU::AssetRegistry::Build(jsonPath, outputPath, sourceDirectory, packPath);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Failed to build the asset registry index: " << e.what() << std::endl;
+		return 1;
+	}
+
+	//Read it back the way the engine does, a broken index fails the build instead of the next run
+	auto start = std::chrono::high_resolution_clock::now();
+	if (!CHIKU::AssetRegistry::Load(outputPath))
+	{
+		std::cerr << "Failed to map the index that was just written: " << outputPath << std::endl;
+		return 1;
+	}
+
+	auto entries = CHIKU::AssetRegistry::GetEntries();
+	for (const auto& entry : entries)
+	{
+		if (CHIKU::AssetRegistry::Find(entry.GUID) != &entry)
+		{
+			std::cerr << "Lookup failed for GUID " << entry.GUID << std::endl;
+			return 1;
+		}
+	}
+	float elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	std::cout << "Wrote " << entries.size() << " assets to " << outputPath << ", mapped and looked up in " << elapsed << " ms" << std::endl;
+	CHIKU::AssetRegistry::Unload();
+
+	if (!packPath.empty())
+	{
+		CHIKU::PackFile pack;
+		if (!pack.Open(packPath))
+		{
+			std::cerr << "Failed to map the pack that was just written: " << packPath << std::endl;
+			return 1;
+		}
+
+		std::cout << "Packed " << pack.GetFiles().size() << " files to " << packPath << std::endl;
+	}
+
+	return 0;
+}
+
+//Cooks AssetRegistry.json into the binary index the engine maps at startup, and optionally packs every registered file.
+//Usage: AssetRegistryBuilder <AssetRegistry.json> <AssetRegistry.bin> [source directory] [--pack <Assets.pak>]
+//Paths in the registry are relative to the source directory, the folder of the JSON when it is not given.
+int main(int argc, char** argv)
+{
+	std::vector<std::string> arguments;
+	std::string packPath;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--pack" && i + 1 < argc)
+			packPath = argv[++i];
+		else
+			arguments.push_back(argument);
+	}
+
+	if (arguments.size() < 2)
+	{
+		std::cerr << "Usage: AssetRegistryBuilder <AssetRegistry.json> <AssetRegistry.bin> [source directory] [--pack <Assets.pak>]" << std::endl;
+		return 1;
+	}
+
+	std::string sourceDirectory = arguments.size() > 2 ? arguments[2] : std::filesystem::path(arguments[0]).parent_path().string() + "/";
+
+	CHIKU::Logger::Init("AssetRegistryBuilder");
+	//Pack blocks are compressed on the workers
+	CHIKU::JobSystem::Init();
+
+	int result = Build(arguments[0], arguments[1], sourceDirectory, packPath);
+
+	CHIKU::JobSystem::CleanUp();
+	CHIKU::Logger::Shutdown();
+	return result;
+}
@@ -1,8 +1,17 @@
 #include "Application.h"
 #include <Vulkan/Utils/VulkanShaderUtils.h>
 #include <Assets/AssetManager.h>
+#include <Assets/ResidencyManager.h>
+#include <Assets/AssetGraph.h>
+#include <Assets/AssetRegistry.h>
+#include <IO/FileSystem.h>
+#include <Assets/CookDatabase.h>
 #include <Renderer/GraphicsPipeline.h>
+#include <Renderer/RenderQueue.h>
+#include <Renderer/UploadQueue.h>
+#include <Jobs/JobSystem.h>
 #include <Vulkan/Renderer/OpenXR.h>
+#include <chrono>
 
 namespace CHIKU
 {
@@ -28,9 +37,19 @@ namespace CHIKU
 		rendererData.type = VULKAN_RENDERER; // or OPENXR_RENDERER for OpenXR
 		rendererData.window = m_Window.GetWindow();
 
+		JobSystem::Init();
 		OpenXR::Init();
 		Renderer::Init(&rendererData);
 		AssetManager::Init();
+		ResidencyManager::Init();
+		//Optional, without it every asset is read as a loose file
+		FileSystem::Mount(ASSET_PACK);
+		//Tells loads what was edited since the last AssetCooker run. Read only here, only the cooker saves it
+		CookDatabase::Load();
+		if (!AssetRegistry::Load(ASSET_REGISTRY_INDEX))
+		{
+			LOG_WARN("No asset registry index, run AssetRegistryBuilder. Reading " + std::string(ASSET_REGISTRY) + " instead");
+		}
 		GraphicsPipeline::Init();
 
 		s_Data.eventHandler = [this](Event& event) -> void
@@ -38,11 +57,20 @@ namespace CHIKU
 				Publish(event);
 			};
 
-		AssetManager::AddShader({ "src/Shaders/Unlit/unlit.vert", "src/Shaders/Unlit/unlit.frag" });
-		AssetManager::AddShader({ "src/Shaders/Defaultlit/defaultlit.vert", "src/Shaders/Defaultlit/defaultlit.frag" });
+		//Streams in while the window is already rendering, the registry orders shaders before the models whose materials use them
+		AssetGraph scene = AssetRegistry::IsLoaded() ? AssetGraph::FromRegistryIndex() : AssetGraph::FromRegistry(ASSET_REGISTRY);
+
+		//The scene draws the first model the registry lists, it is picked up by GUID once the batch finished
+		for (uint32_t i = 0; i < scene.GetNodeCount(); i++)
+		{
+			if (scene.GetNode(i).Type == AssetType::Model)
+			{
+				m_SceneModel = scene.GetNode(i).GUID;
+				break;
+			}
+		}
 
-		auto assetHandle = AssetManager::AddModel({ "Models/Y Bot/Y Bot.gltf" });
-		m_Model = std::dynamic_pointer_cast<ModelAsset>(AssetManager::GetAsset(assetHandle));
+		m_SceneLoad = AssetBatch::Load(scene);
 	}
 
 	void Application::Run()
@@ -62,6 +90,8 @@ namespace CHIKU
 
 		OpenXR::Run();
 
+		auto startTime = std::chrono::high_resolution_clock::now();
+
 		while (!m_Window.WindowShouldClose())
 		{
 			FrameMark;
@@ -71,8 +101,24 @@ namespace CHIKU
 				Renderer::RecreateSwapChain();
 				s_Data.framebufferResized = false;
 			}
+			//Evicts and starts restores, then finishes asset loads waiting on the GPU before the frame starts recording
+			ResidencyManager::Update();
+			UploadQueue::Pump();
+			if (m_SceneLoad && m_SceneLoad->IsDone())
+			{
+				m_Model = std::static_pointer_cast<ModelAsset>(AssetManager::GetAsset(m_SceneLoad->FindHandle(m_SceneModel)));
+				m_SceneLoad = nullptr;
+			}
+
 			Renderer::BeginFrame();
-			m_Model->Draw();
+			GraphicsPipeline::Update();
+
+			auto currentTime = std::chrono::high_resolution_clock::now();
+			float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+
+			if (m_Model)
+				m_Model->Draw(glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+			RenderQueue::Flush();
 			Renderer::EndFrame();
 		}
 	}
@@ -81,12 +127,17 @@ namespace CHIKU
 	{
 		ZoneScoped;
 
-		m_Model->CleanUp();
+		if (m_Model)
+			m_Model->CleanUp();
 		Renderer::Wait();
 		OpenXR::CleanUp();
+		ResidencyManager::CleanUp();
 		AssetManager::CleanUp();
+		AssetRegistry::Unload();
+		FileSystem::UnmountAll();
 		GraphicsPipeline::CleanUp();
 		Renderer::CleanUp();
+		JobSystem::CleanUp();
 #ifdef CHIKU_ENABLE_LOGGING
 		Logger::Shutdown();
 #endif
@@ -2,6 +2,7 @@
 #include "Renderer/Renderer.h"
 #include "Window.h"
 #include "Assets/ModelAsset.h"
+#include "Assets/AssetGraph.h"
 #include "Core/Events/EventBus.h"
 
 namespace CHIKU
@@ -44,6 +45,8 @@ namespace CHIKU
 	protected:
 		static EventBus m_EventBus;
 		static ApplicationData s_Data;
+		SHARED<AssetBatch> m_SceneLoad;
+		AssetGUID m_SceneModel = 0;
 		SHARED<ModelAsset> m_Model;
 
 
@@ -1,10 +1,15 @@
 #pragma once
 #include <string>
 #include <filesystem>
+#include <cstdint>
+#include <limits>
+#include <functional>
 
 namespace CHIKU
 {
-	using AssetHandle = uint64_t;
+	//Persistent identity of an asset, derived from its source path so it is the same on every run.
+	//Only used for serialization and for finding an asset again by name, runtime lookups go through AssetHandle.
+	using AssetGUID = uint64_t;
 	using AssetPath = std::string;
 	using ReadableHandle = std::string;
 
@@ -20,6 +25,35 @@ namespace CHIKU
 		Sound,
 	};
 
+	static constexpr size_t AssetTypeCount = static_cast<size_t>(AssetType::Sound) + 1;
+
+	//Runtime handle into the AssetManager slot maps, only valid for the current run.
+	//The index carries the asset type in the top 8 bits and the slot in the lower 24,
+	//the generation changes every time a slot is reused so stale handles miss instead of aliasing a new asset.
+	struct AssetHandle
+	{
+		static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+		static constexpr uint32_t SlotBits = 24;
+		static constexpr uint32_t SlotMask = (1u << SlotBits) - 1;
+		static constexpr uint32_t MaxSlots = SlotMask; //The all ones slot is kept for InvalidIndex
+
+		uint32_t Index = InvalidIndex;
+		uint32_t Generation = 0;
+
+		AssetHandle() = default;
+		AssetHandle(AssetType type, uint32_t slot, uint32_t generation)
+			: Index((static_cast<uint32_t>(type) << SlotBits) | (slot & SlotMask)), Generation(generation) {}
+
+		AssetType GetType() const { return static_cast<AssetType>(Index >> SlotBits); }
+		uint32_t GetSlot() const { return Index & SlotMask; }
+		bool IsValid() const { return Index != InvalidIndex; }
+
+		uint64_t Pack() const { return (static_cast<uint64_t>(Generation) << 32) | Index; }
+		std::string ToString() const { return std::to_string(GetSlot()) + ":" + std::to_string(Generation); }
+
+		bool operator==(const AssetHandle& other) const = default;
+	};
+
 	inline AssetType AssetTypeFromString(const std::string& str) 
 	{		
 		if (str == "None"		)	return AssetType::None;
@@ -51,10 +85,24 @@ namespace CHIKU
 		return "None";
 	}
 
+	struct AssetMemoryUsage
+	{
+		uint64_t CPU = 0;
+		uint64_t GPU = 0;
+	};
+
+	//Bookkeeping for the ResidencyManager, only touched from the main thread
+	struct AssetResidency
+	{
+		uint64_t LastUsedFrame = 0;
+		uint64_t EvictedFrame = 0;
+		bool Restoring = false;
+	};
+
 	class Asset
 	{
 	public:
-		static constexpr uint64_t InvalidHandle = std::numeric_limits<uint64_t>::max();
+		static constexpr AssetHandle InvalidHandle{};
 
 		Asset() : m_Handle(InvalidHandle), m_Type(AssetType::None) {}
 		Asset(AssetType type) : m_Type(type), m_Handle(InvalidHandle) {}
@@ -64,12 +112,27 @@ namespace CHIKU
 
 		virtual AssetHandle GetHandle() const final { return m_Handle; }
 		virtual AssetType GetType() const final { return m_Type; }
+		virtual AssetGUID GetGUID() const final { return m_GUID; }
 
 		virtual void Init() {}
 
+		//Residency, assets that can drop their data and bring it back later override these.
+		//CPU data only lives while a restore carries it from the source to the GPU, resident assets keep none.
+		virtual AssetMemoryUsage GetMemoryUsage() const { return {}; }
+		virtual bool IsEvictable() const { return false; }
+		virtual bool IsCPUResident() const { return true; }
+		virtual bool IsGPUResident() const { return true; }
+		//Runs on a job worker
+		virtual bool LoadCPUData() { return true; }
+		//Run on the main thread
+		virtual void LoadGPUData() {}
+		virtual void UnloadCPUData() {}
+		virtual void UnloadGPUData() {}
+
 		virtual void CleanUp()
 		{ 
 			m_Handle = InvalidHandle; 
+			m_GUID = 0;
 			m_Type = AssetType::None; 
 			m_SourcePath.clear(); 
 		}
@@ -85,6 +148,8 @@ namespace CHIKU
 
 		AssetType m_Type;
 		AssetHandle m_Handle;
+		AssetGUID m_GUID = 0;
+		AssetResidency m_Residency;
 		AssetPath m_SourcePath;
 		AssetPath m_ExportPath; // Path where the asset is exported
 	};
@@ -96,4 +161,15 @@ namespace CHIKU
 		SoundAsset(AssetHandle handle) : Asset(handle, AssetType::Sound) {}
 		SoundAsset(AssetHandle handle, AssetPath path) : Asset(handle, AssetType::Sound, path) {}
 	};
-}
\ No newline at end of file
+}
+
+namespace std {
+	template <>
+	struct hash<CHIKU::AssetHandle>
+	{
+		std::size_t operator()(const CHIKU::AssetHandle& handle) const
+		{
+			return std::hash<uint64_t>()(handle.Pack());
+		}
+	};
+}
@@ -0,0 +1,314 @@
+#include "AssetCooker.h"
+#include "AssetRegistry.h"
+#include "CookDatabase.h"
+#include "MaterialAsset.h"
+#include "IO/FileSystem.h"
+#include "Jobs/JobSystem.h"
+#include "Vulkan/Utils/VulkanModelUtils.h"
+#include "Vulkan/Utils/VulkanShaderUtils.h"
+#include "Utils/Utils.h"
+
+namespace CHIKU
+{
+	std::unordered_map<AssetPath, UNIQUE<std::mutex>> AssetCooker::m_OutputMutexes;
+	std::mutex AssetCooker::m_OutputMutexesMutex;
+
+	std::mutex& AssetCooker::GetOutputMutex(const AssetPath& output)
+	{
+		std::lock_guard<std::mutex> lock(m_OutputMutexesMutex);
+
+		//Never erased, the mutex has to outlive every thread that may still wait on it
+		UNIQUE<std::mutex>& mutex = m_OutputMutexes[output];
+		if (!mutex)
+			mutex = std::make_unique<std::mutex>();
+
+		return *mutex;
+	}
+
+	AssetType AssetCooker::GetSourceType(const std::filesystem::path& path)
+	{
+		std::string ext = path.extension().string();
+		std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+		if (ext == ".vert" || ext == ".frag" || ext == ".geom" || ext == ".tesc" || ext == ".tese" || ext == ".comp")
+			return AssetType::Shader;
+
+		if (ext == ".gltf" || ext == ".glb" || ext == ".fbx")
+			return AssetType::Model;
+
+		//Materials are the JSON files kept in a Materials folder, any other JSON is configuration
+		if (ext == ".json" && path.parent_path().filename() == "Materials")
+			return AssetType::Material;
+
+		return AssetType::None;
+	}
+
+	CookSummary AssetCooker::CookDirectory(const std::string& directory)
+	{
+		ZoneScoped;
+
+		const std::filesystem::path sourceRoot = SOURCE_DIR;
+		std::vector<std::pair<AssetType, AssetPath>> sources;
+
+		std::error_code error;
+		for (auto it = std::filesystem::recursive_directory_iterator(sourceRoot / directory, error);
+			it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+		{
+			if (error)
+				break;
+
+			const std::filesystem::path& path = it->path();
+			std::error_code statusError;
+			if (it->is_directory(statusError))
+			{
+				//Third party code and hidden folders carry their own samples, they are not engine assets
+				std::string name = path.filename().string();
+				if (name == "vendor" || name.starts_with("."))
+					it.disable_recursion_pending();
+				continue;
+			}
+
+			AssetType type = GetSourceType(path);
+			if (type == AssetType::None)
+				continue;
+
+			//A glTF with an FBX next to it is that FBX's conversion output, it gets cooked through the FBX
+			if (type == AssetType::Model && Utils::IsGLTFFormat(path.string()) &&
+				std::filesystem::exists(std::filesystem::path(path).replace_extension(".fbx")))
+			{
+				continue;
+			}
+
+			sources.emplace_back(type, path.lexically_relative(sourceRoot).generic_string());
+		}
+
+		if (error)
+		{
+			LOG_WARN("Stopped scanning " + directory + " early: " + error.message());
+		}
+
+		//Shader and FBX conversions are external processes, running them side by side is where the time goes
+		std::vector<CookResult> results(sources.size(), CookResult::Failed);
+		JobSystem::Dispatch(static_cast<uint32_t>(sources.size()), [&](uint32_t index)
+			{
+				const auto& [type, path] = sources[index];
+				try
+				{
+					switch (type)
+					{
+					case AssetType::Shader:		results[index] = CookShader(path); break;
+					case AssetType::Model:		results[index] = CookModel(path); break;
+					case AssetType::Material:	results[index] = CookMaterial(path); break;
+					default: break;
+					}
+				}
+				catch (const std::exception& e)
+				{
+					LOG_WARN("Failed to cook " + path + ": " + e.what());
+				}
+			});
+
+		CookSummary summary;
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			switch (results[i])
+			{
+			case CookResult::Cooked:	summary.Cooked++; break;
+			case CookResult::UpToDate:	summary.UpToDate++; break;
+			case CookResult::Failed:
+				summary.Failed++;
+				LOG_WARN("Cook failed: " + sources[i].second);
+				break;
+			}
+		}
+
+		return summary;
+	}
+
+	void AssetCooker::WriteRegistry(const std::string& packPath)
+	{
+		ZoneScoped;
+
+		AssetRegistry::Build(ASSET_REGISTRY, ASSET_REGISTRY_INDEX, SOURCE_DIR, packPath);
+	}
+
+	//FBX2glTF has no version flag, its size and write time stand in for one
+	static std::string GetToolStamp(const std::string& path)
+	{
+		std::error_code sizeError, timeError;
+		uintmax_t size = std::filesystem::file_size(path, sizeError);
+		auto time = std::filesystem::last_write_time(path, timeError);
+		if (sizeError || timeError)
+			return "missing";
+
+		return std::to_string(size) + ":" + std::to_string(time.time_since_epoch().count());
+	}
+
+	CookResult AssetCooker::CookShader(const AssetPath& path)
+	{
+		ZoneScoped;
+
+		CookStep step;
+		//Same name the runtime looks for next to the source
+		step.Output = path + ".spv";
+		step.Inputs = { path };
+		step.Tool = Utils::GetShaderCompilerVersion();
+
+		std::lock_guard<std::mutex> lock(GetOutputMutex(step.Output));
+
+		std::string detail;
+		RebuildReason reason = CookDatabase::Check(step, &detail);
+		if (reason == RebuildReason::UpToDate)
+			return CookResult::UpToDate;
+
+		if (!Utils::CompileShaderToSPIRV(path, step.Output))
+			return CookResult::Failed;
+
+		//Editing an included file compiles every shader using it
+		std::vector<AssetPath> includes = Utils::GetShaderIncludes(path);
+		step.Inputs.insert(step.Inputs.end(), includes.begin(), includes.end());
+
+		CookDatabase::Record(step, reason, detail);
+		return CookResult::Cooked;
+	}
+
+	CookStep AssetCooker::GetModelStep(const AssetPath& path)
+	{
+		bool convert = !Utils::IsGLTFFormat(path);
+
+		CookStep step;
+		step.Output = convert ? std::filesystem::path(path).replace_extension(".gltf").generic_string() : path;
+		step.Inputs = { path };
+		step.Tool = "AssetCooker " + std::to_string(Version);
+		if (convert)
+			step.Tool += ", FBX2glTF " + GetToolStamp(SOURCE_DIR + "tools/FBX2glTF.exe");
+		return step;
+	}
+
+	CookStep AssetCooker::GetConversionStep(const AssetPath& path)
+	{
+		CookStep step;
+		step.Output = std::filesystem::path(path).replace_extension(".gltf").generic_string();
+		step.Inputs = { path };
+		step.Tool = "FBX2glTF " + GetToolStamp(SOURCE_DIR + "tools/FBX2glTF.exe");
+		return step;
+	}
+
+	CookResult AssetCooker::CookModel(const AssetPath& path)
+	{
+		ZoneScoped;
+
+		bool convert = !Utils::IsGLTFFormat(path);
+		CookStep step = GetModelStep(path);
+
+		std::lock_guard<std::mutex> lock(GetOutputMutex(step.Output));
+
+		std::string detail;
+		RebuildReason reason = CookDatabase::Check(step, &detail);
+		if (reason == RebuildReason::UpToDate)
+			return CookResult::UpToDate;
+
+		if (convert && Utils::ConvertToGLTF(SOURCE_DIR + path).empty())
+			return CookResult::Failed;
+
+		tinygltf::Model model;
+		Utils::GLTFBuffers buffers;
+		if (!Utils::LoadGLTFMapped(SOURCE_DIR + step.Output, model, buffers))
+			return CookResult::Failed;
+
+		//External buffers and images are inputs too, a re-exported .bin cooks the model again
+		std::filesystem::path directory = std::filesystem::path(step.Output).parent_path();
+		auto addInput = [&](const std::string& uri)
+			{
+				if (!uri.empty() && !uri.starts_with("data:"))
+					step.Inputs.push_back((directory / Utils::DecodeURI(uri)).lexically_normal().generic_string());
+			};
+		for (const auto& buffer : model.buffers)
+			addInput(buffer.uri);
+		for (const auto& image : model.images)
+			addInput(image.uri);
+
+		//Imported the way the runtime does it, so a model that would fail to load fails the cook instead
+		Utils::ImportedModel imported;
+		if (!Utils::ImportModel(model, buffers, imported))
+		{
+			LOG_WARN("Meshes of " + path + " do not import");
+			return CookResult::Failed;
+		}
+
+		CookDatabase::Record(step, reason, detail);
+		return CookResult::Cooked;
+	}
+
+	CookStep AssetCooker::GetMaterialStep(const AssetPath& path)
+	{
+		CookStep step;
+		step.Output = std::filesystem::path(path).replace_extension(COOKED_MATERIAL_EXTENSION).generic_string();
+		step.Inputs = { path };
+		step.Tool = "AssetCooker " + std::to_string(Version);
+		step.Settings = "cmat " + std::to_string(COOKED_MATERIAL_VERSION);
+		return step;
+	}
+
+	CookResult AssetCooker::CookMaterial(const AssetPath& path)
+	{
+		ZoneScoped;
+
+		CookStep step = GetMaterialStep(path);
+
+		std::lock_guard<std::mutex> lock(GetOutputMutex(step.Output));
+
+		std::string detail;
+		RebuildReason reason = CookDatabase::Check(step, &detail);
+		if (reason == RebuildReason::UpToDate)
+			return CookResult::UpToDate;
+
+		Material material = MaterialAsset::ReadMaterialSource(path);
+		if (!MaterialAsset::CookMaterial(material, step.Output))
+			return CookResult::Failed;
+
+		CookDatabase::Record(step, reason, detail);
+		return CookResult::Cooked;
+	}
+
+	bool AssetCooker::IsMaterialCooked(const AssetPath& path)
+	{
+		ZoneScoped;
+
+		return CookDatabase::Check(GetMaterialStep(path)) == RebuildReason::UpToDate;
+	}
+
+	AssetPath AssetCooker::GetGLTFPath(const AssetPath& path)
+	{
+		ZoneScoped;
+
+		//Validating a glTF is the cooker's job, a broken one fails the load that reads it
+		if (Utils::IsGLTFFormat(path))
+			return SOURCE_DIR + path;
+
+		CookStep conversion = GetConversionStep(path);
+		std::lock_guard<std::mutex> lock(GetOutputMutex(conversion.Output));
+
+		//Cooked by the AssetCooker, or already converted by this run
+		if (CookDatabase::Check(GetModelStep(path)) == RebuildReason::UpToDate)
+			return SOURCE_DIR + conversion.Output;
+
+		std::string detail;
+		RebuildReason reason = CookDatabase::Check(conversion, &detail);
+		if (reason == RebuildReason::UpToDate)
+			return SOURCE_DIR + conversion.Output;
+
+		if (Utils::ConvertToGLTF(SOURCE_DIR + path).empty())
+		{
+			if (!FileSystem::Exists(conversion.Output))
+				return "";
+
+			LOG_WARN("Converting " + path + " failed, loading the last converted " + conversion.Output);
+			return SOURCE_DIR + conversion.Output;
+		}
+
+		//Kept for the rest of the run only, the database is saved by the AssetCooker
+		CookDatabase::Record(conversion, reason, detail);
+		return SOURCE_DIR + conversion.Output;
+	}
+}
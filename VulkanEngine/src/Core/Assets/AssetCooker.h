@@ -0,0 +1,68 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Asset.h"
+#include "CookDatabase.h"
+#include <mutex>
+
+namespace CHIKU
+{
+	enum class CookResult : uint8_t
+	{
+		UpToDate,
+		Cooked,
+		Failed,
+	};
+
+	struct CookSummary
+	{
+		uint32_t Cooked = 0;
+		uint32_t UpToDate = 0;
+		uint32_t Failed = 0;
+	};
+
+	//Does the import work ahead of time so startup only loads: GLSL to SPIR-V, FBX to glTF and
+	//JSON materials to .cmat. Needs no device or window, the AssetCooker tool drives it.
+	//Materials inside a model are not cooked, the runtime builds them from the glTF keyed by model path and index.
+	//Every step asks the CookDatabase first. The runtime only checks the records, compiles shaders and converts models
+	//edited since the last cook and never validates, writes .cmat files or saves the database.
+	class AssetCooker
+	{
+	public:
+		//Part of every step's tool version, bump it when cooking code changes what it writes
+		static constexpr uint32_t Version = 1;
+
+		//Cooks every asset under a directory relative to the source directory, one job per asset
+		static CookSummary CookDirectory(const std::string& directory = "");
+		//Rebuilds the registry index, and the pack when a path is given, from the freshly cooked files. Throws on failure
+		static void WriteRegistry(const std::string& packPath = "");
+
+		//Paths are relative to the source directory
+		static CookResult CookShader(const AssetPath& path);
+		//Converts non glTF sources and test imports every primitive
+		static CookResult CookModel(const AssetPath& path);
+		static CookResult CookMaterial(const AssetPath& path);
+
+		//True when the .cmat next to a JSON material was cooked from its current source
+		static bool IsMaterialCooked(const AssetPath& path);
+
+		//The glTF a model loads from with the source directory in front, non glTF sources are converted when stale.
+		//Empty when there is none, a failed conversion falls back to the last one that worked
+		static AssetPath GetGLTFPath(const AssetPath& path);
+
+		//Which cook step handles a file, None for anything that is not an asset source
+		static AssetType GetSourceType(const std::filesystem::path& path);
+
+	private:
+		static CookStep GetModelStep(const AssetPath& path);
+		//Conversion alone, what the runtime records when it had to convert a model the cooker did not
+		static CookStep GetConversionStep(const AssetPath& path);
+		static CookStep GetMaterialStep(const AssetPath& path);
+
+		//Held while an output is checked, written and recorded, so two loads of the same asset never run the same tool on one file
+		static std::mutex& GetOutputMutex(const AssetPath& output);
+
+	private:
+		static std::unordered_map<AssetPath, UNIQUE<std::mutex>> m_OutputMutexes;
+		static std::mutex m_OutputMutexesMutex;
+	};
+}
@@ -0,0 +1,392 @@
+#include "AssetGraph.h"
+#include "AssetManager.h"
+#include "AssetRegistry.h"
+#include "ModelAsset.h"
+#include "MaterialAsset.h"
+#include "ShaderAsset.h"
+#include "Vulkan/Utils/VulkanModelUtils.h"
+
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+namespace CHIKU
+{
+	uint32_t AssetGraph::AddNode(AssetType type, const std::vector<AssetPath>& paths)
+	{
+		//Shaders are named by all of their stages, everything else by its one path
+		AssetGUID guid = type == AssetType::Shader ? AssetManager::MakeGUID(type, paths) : AssetManager::MakeGUID(type, paths[0]);
+
+		auto it = m_Lookup.find(guid);
+		if (it != m_Lookup.end())
+			return it->second;
+
+		uint32_t index = static_cast<uint32_t>(m_Nodes.size());
+		Node& node = m_Nodes.emplace_back();
+		node.GUID = guid;
+		node.Type = type;
+		node.Paths = paths;
+
+		m_Lookup[guid] = index;
+		return index;
+	}
+
+	void AssetGraph::AddDependency(uint32_t node, uint32_t dependency)
+	{
+		std::vector<uint32_t>& dependencies = m_Nodes[node].Dependencies;
+		if (std::find(dependencies.begin(), dependencies.end(), dependency) == dependencies.end())
+			dependencies.push_back(dependency);
+	}
+
+	uint32_t AssetGraph::FindNode(AssetGUID guid) const
+	{
+		auto it = m_Lookup.find(guid);
+		return it != m_Lookup.end() ? it->second : InvalidNode;
+	}
+
+	bool AssetGraph::Sort(std::vector<uint32_t>& order) const
+	{
+		ZoneScoped;
+
+		//Kahn's algorithm on the reversed edges, a node is ready once every dependency was emitted
+		std::vector<uint32_t> pending(m_Nodes.size(), 0);
+		std::vector<std::vector<uint32_t>> dependents(m_Nodes.size());
+		for (uint32_t i = 0; i < m_Nodes.size(); i++)
+		{
+			pending[i] = static_cast<uint32_t>(m_Nodes[i].Dependencies.size());
+			for (uint32_t dependency : m_Nodes[i].Dependencies)
+				dependents[dependency].push_back(i);
+		}
+
+		order.clear();
+		order.reserve(m_Nodes.size());
+		for (uint32_t i = 0; i < m_Nodes.size(); i++)
+		{
+			if (pending[i] == 0)
+				order.push_back(i);
+		}
+
+		for (size_t next = 0; next < order.size(); next++)
+		{
+			for (uint32_t dependent : dependents[order[next]])
+			{
+				if (--pending[dependent] == 0)
+					order.push_back(dependent);
+			}
+		}
+
+		return order.size() == m_Nodes.size();
+	}
+
+	void AssetGraph::AddMaterialDependencies()
+	{
+		ZoneScoped;
+
+		//Materials refer to shaders by the name in their sources, a name can have a node per variant
+		std::unordered_map<ReadableHandle, std::vector<uint32_t>> shaders;
+		for (uint32_t i = 0; i < m_Nodes.size(); i++)
+		{
+			if (m_Nodes[i].Type != AssetType::Shader)
+				continue;
+
+			try
+			{
+				ReadableHandle name;
+				ShaderStages stage;
+				ShaderAsset::GetShaderNameAndStage(m_Nodes[i].Paths[0], name, stage);
+				shaders[name].push_back(i);
+			}
+			catch (const std::exception& e)
+			{
+				LOG_WARN("Cannot read the name of shader " + m_Nodes[i].Paths[0] + ": " + e.what());
+			}
+		}
+
+		for (uint32_t i = 0; i < m_Nodes.size(); i++)
+		{
+			if (m_Nodes[i].Type != AssetType::Model)
+				continue;
+
+			//Non glTF sources are read through the glTF they are converted to
+			const AssetPath& path = m_Nodes[i].Paths[0];
+			AssetPath gltfPath = Utils::IsGLTFFormat(path) ? path : std::filesystem::path(path).replace_extension(".gltf").generic_string();
+
+			tinygltf::Model model;
+			Utils::GLTFBuffers buffers;
+			if (!Utils::LoadGLTFMapped(SOURCE_DIR + gltfPath, model, buffers))
+			{
+				LOG_WARN("Cannot read the materials of " + path + ", it loads without waiting for its shaders");
+				continue;
+			}
+
+			//The same choice the import makes, so the batch loads exactly the shaders the model's materials look up
+			for (const auto& material : model.materials)
+			{
+				ReadableHandle shader = Utils::SelectShaderFromMaterial(material);
+				auto it = shaders.find(shader);
+				if (it == shaders.end())
+				{
+					LOG_WARN("Model " + path + " uses shader " + shader + " which is not in the registry");
+					continue;
+				}
+
+				for (uint32_t dependency : it->second)
+					AddDependency(i, dependency);
+			}
+		}
+	}
+
+	static AssetType StringToAssetType(const std::string& name)
+	{
+		for (size_t i = 0; i < AssetTypeCount; i++)
+		{
+			AssetType type = static_cast<AssetType>(i);
+			if (AssetTypeToString(type) == name)
+				return type;
+		}
+
+		return AssetType::None;
+	}
+
+	AssetGraph AssetGraph::FromRegistry(const std::string& path)
+	{
+		ZoneScoped;
+
+		AssetGraph graph;
+
+		std::ifstream file(path);
+		if (!file.is_open())
+		{
+			LOG_ERROR("Failed to open the asset registry: " + path);
+			return graph;
+		}
+
+		nlohmann::json registry = nlohmann::json::parse(file, nullptr, false);
+		if (registry.is_discarded() || !registry.is_object())
+		{
+			LOG_ERROR("Asset registry is not valid JSON: " + path);
+			return graph;
+		}
+
+		//Nodes first so dependencies can name entries further down the file
+		std::unordered_map<std::string, uint32_t> keys;
+		for (auto& [key, entry] : registry.items())
+		{
+			AssetType type = StringToAssetType(entry.value("Type", ""));
+			if (type == AssetType::None)
+			{
+				LOG_WARN("Skipping registry entry " + key + " with an unknown type");
+				continue;
+			}
+
+			std::vector<AssetPath> paths;
+			if (entry.contains("Paths"))
+				paths = entry["Paths"].get<std::vector<AssetPath>>();
+			else if (entry.contains("Path"))
+				paths.push_back(entry["Path"].get<AssetPath>());
+
+#ifdef ENABLE_VERTEX_PULLING
+			if (entry.contains("PulledPaths"))
+				paths = entry["PulledPaths"].get<std::vector<AssetPath>>();
+#endif
+
+			if (paths.empty())
+			{
+				LOG_WARN("Skipping registry entry " + key + " without a path");
+				continue;
+			}
+
+			keys[key] = graph.AddNode(type, paths);
+		}
+
+		graph.AddMaterialDependencies();
+
+		for (auto& [key, entry] : registry.items())
+		{
+			auto node = keys.find(key);
+			if (node == keys.end() || !entry.contains("Dependencies"))
+				continue;
+
+			for (const auto& dependency : entry["Dependencies"])
+			{
+				auto it = keys.find(dependency.get<std::string>());
+				if (it == keys.end())
+				{
+					LOG_WARN("Registry entry " + key + " depends on missing entry " + dependency.get<std::string>());
+					continue;
+				}
+
+				graph.AddDependency(node->second, it->second);
+			}
+		}
+
+		return graph;
+	}
+
+	AssetGraph AssetGraph::FromRegistryIndex()
+	{
+		ZoneScoped;
+
+		AssetGraph graph;
+
+		std::span<const AssetRegistryEntry> entries = AssetRegistry::GetEntries();
+		graph.m_Nodes.reserve(entries.size());
+		graph.m_Lookup.reserve(entries.size());
+
+		//The index is deduplicated already, node i is entry i
+		for (const auto& entry : entries)
+		{
+			graph.AddNode(entry.Type, AssetRegistry::GetPaths(entry));
+		}
+
+		for (uint32_t i = 0; i < entries.size(); i++)
+		{
+			for (uint32_t dependency : AssetRegistry::GetDependencies(entries[i]))
+				graph.AddDependency(i, dependency);
+		}
+
+		return graph;
+	}
+
+	//Resumes once a node of the batch finished, either way
+	struct NodeAwaiter
+	{
+		AssetLoadState& State;
+
+		bool await_ready() const { return State.GetStatus() != AssetLoadStatus::Loading; }
+		bool await_suspend(std::coroutine_handle<> waiter) { return State.AddWaiter(waiter); }
+		AssetLoadStatus await_resume() const { return State.GetStatus(); }
+	};
+
+	static AssetRequest<Asset> StartLoad(const AssetGraph::Node& node)
+	{
+		switch (node.Type)
+		{
+		case AssetType::Model:		return AssetManager::LoadAsync<ModelAsset>(node.Paths[0]);
+		case AssetType::Material:	return AssetManager::LoadAsync<MaterialAsset>(node.Paths[0]);
+		case AssetType::Shader:		return AssetManager::LoadAsync<ShaderAsset>(node.Paths);
+		default:
+			break;
+		}
+
+		//Textures and sounds only order other loads for now, they have no loader of their own yet
+		LOG_WARN("No asynchronous loader for " + AssetTypeToString(node.Type) + " assets: " + node.Paths[0]);
+		return {};
+	}
+
+	SHARED<AssetBatch> AssetBatch::Load(const AssetGraph& graph)
+	{
+		ZoneScoped;
+
+		SHARED<AssetBatch> batch = std::make_shared<AssetBatch>();
+		batch->m_Done = std::make_shared<AssetLoadState>(Asset::InvalidHandle);
+
+		uint32_t count = graph.GetNodeCount();
+		batch->m_Nodes.resize(count);
+		batch->m_Remaining.store(count, std::memory_order_relaxed);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			batch->m_Nodes[i].GUID = graph.GetNode(i).GUID;
+			batch->m_Nodes[i].Done = std::make_shared<AssetLoadState>(Asset::InvalidHandle);
+		}
+
+		if (count == 0)
+		{
+			batch->m_Done->Complete(AssetLoadStatus::Ready);
+			return batch;
+		}
+
+		std::vector<uint32_t> order;
+		if (!graph.Sort(order))
+		{
+			LOG_ERROR("Asset graph has a dependency cycle, nothing in it is loaded");
+			batch->m_Failed.store(count, std::memory_order_relaxed);
+			batch->m_Remaining.store(0, std::memory_order_relaxed);
+			batch->m_Done->Complete(AssetLoadStatus::Failed);
+			return batch;
+		}
+
+		//Leaves first so the loads nothing waits on are the first ones on the workers
+		for (uint32_t index : order)
+		{
+			LoadNode(batch, graph.GetNode(index), index);
+		}
+
+		return batch;
+	}
+
+	AssetHandle AssetBatch::GetHandle(uint32_t node) const
+	{
+		const NodeState& state = m_Nodes[node];
+		return state.Done->GetStatus() == AssetLoadStatus::Ready ? state.Handle : Asset::InvalidHandle;
+	}
+
+	AssetHandle AssetBatch::FindHandle(AssetGUID guid) const
+	{
+		for (uint32_t i = 0; i < m_Nodes.size(); i++)
+		{
+			if (m_Nodes[i].GUID == guid)
+				return GetHandle(i);
+		}
+
+		return Asset::InvalidHandle;
+	}
+
+	//Parameters are taken by value, the coroutine frame outlives the graph it was started from
+	DetachedTask AssetBatch::LoadNode(SHARED<AssetBatch> batch, AssetGraph::Node node, uint32_t index)
+	{
+		//Resumes on whichever thread finished the dependency, starting a load from there only reserves it
+		bool dependenciesReady = true;
+		for (uint32_t dependency : node.Dependencies)
+		{
+			if (co_await NodeAwaiter{ *batch->m_Nodes[dependency].Done } != AssetLoadStatus::Ready)
+				dependenciesReady = false;
+		}
+
+		AssetHandle handle = Asset::InvalidHandle;
+		AssetLoadStatus status = AssetLoadStatus::Failed;
+		if (dependenciesReady)
+		{
+			AssetRequest<Asset> request;
+			try
+			{
+				request = StartLoad(node);
+			}
+			catch (const std::exception& e)
+			{
+				LOG_ERROR("Failed to start loading " + node.Paths[0] + ": " + e.what());
+			}
+
+			co_await request;
+			if (request.IsReady())
+			{
+				handle = request.GetHandle();
+				status = AssetLoadStatus::Ready;
+			}
+		}
+		else
+		{
+			LOG_WARN("Not loading " + node.Paths[0] + ", one of its dependencies failed");
+		}
+
+		batch->Finish(index, handle, status);
+	}
+
+	void AssetBatch::Finish(uint32_t index, const AssetHandle& handle, AssetLoadStatus status)
+	{
+		NodeState& state = m_Nodes[index];
+		state.Handle = handle;
+
+		if (status == AssetLoadStatus::Failed)
+			m_Failed.fetch_add(1, std::memory_order_acq_rel);
+
+		//Dependents resume inside this call
+		state.Done->Complete(status);
+
+		if (m_Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			m_Done->Complete(m_Failed.load(std::memory_order_acquire) ? AssetLoadStatus::Failed : AssetLoadStatus::Ready);
+		}
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Asset.h"
+#include "AssetRequest.h"
+#include "Jobs/Async.h"
+#include <atomic>
+
+namespace CHIKU
+{
+	//What has to be loaded before what. Nodes are deduplicated by GUID so a shader shared by many models is one node.
+	//Edges point from an asset to the assets it needs, a model to the shaders its materials are built with.
+	class AssetGraph
+	{
+	public:
+		static constexpr uint32_t InvalidNode = UINT32_MAX;
+
+		struct Node
+		{
+			AssetGUID GUID = 0;
+			AssetType Type = AssetType::None;
+			std::vector<AssetPath> Paths;
+			std::vector<uint32_t> Dependencies;
+		};
+
+		//Returns the existing node when the asset is already in the graph
+		uint32_t AddNode(AssetType type, const std::vector<AssetPath>& paths);
+		uint32_t AddNode(AssetType type, const AssetPath& path) { return AddNode(type, std::vector<AssetPath>{ path }); }
+		void AddDependency(uint32_t node, uint32_t dependency);
+
+		uint32_t FindNode(AssetGUID guid) const;
+		const Node& GetNode(uint32_t node) const { return m_Nodes[node]; }
+		uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_Nodes.size()); }
+
+		//Dependencies come before the nodes that need them. False on a cycle
+		bool Sort(std::vector<uint32_t>& order) const;
+
+		//Every entry of the registry becomes a node. Models depend on the shaders their materials pick,
+		//read from the glTF, further dependencies can be named by registry key
+		static AssetGraph FromRegistry(const std::string& path);
+		//Same graph out of the mapped AssetRegistry index, no JSON is parsed
+		static AssetGraph FromRegistryIndex();
+
+	private:
+		void AddMaterialDependencies();
+
+	private:
+		std::vector<Node> m_Nodes;
+		std::unordered_map<AssetGUID, uint32_t> m_Lookup;
+	};
+
+	//Loads a whole graph at once. Every node starts the moment its dependencies are done,
+	//independent nodes load on the job workers side by side so a batch takes as long as its longest chain.
+	//Poll it every frame or co_await it, it is done once every node finished or failed.
+	class AssetBatch
+	{
+	public:
+		static SHARED<AssetBatch> Load(const AssetGraph& graph);
+
+		bool IsDone() const { return m_Done->GetStatus() != AssetLoadStatus::Loading; }
+		bool IsFailed() const { return m_Done->GetStatus() == AssetLoadStatus::Failed; }
+		uint32_t GetFailedCount() const { return m_Failed.load(std::memory_order_acquire); }
+
+		//Invalid until the node is ready
+		AssetHandle GetHandle(uint32_t node) const;
+		AssetHandle FindHandle(AssetGUID guid) const;
+
+		bool await_ready() const { return IsDone(); }
+		bool await_suspend(std::coroutine_handle<> waiter) { return m_Done->AddWaiter(waiter); }
+		void await_resume() const {}
+
+	private:
+		struct NodeState
+		{
+			AssetGUID GUID = 0;
+			//Written before Done completes, read only after it did
+			AssetHandle Handle = Asset::InvalidHandle;
+			//Dependents wait on it
+			SHARED<AssetLoadState> Done;
+		};
+
+		static DetachedTask LoadNode(SHARED<AssetBatch> batch, AssetGraph::Node node, uint32_t index);
+		void Finish(uint32_t index, const AssetHandle& handle, AssetLoadStatus status);
+
+	private:
+		std::vector<NodeState> m_Nodes;
+		std::atomic<uint32_t> m_Remaining = 0;
+		std::atomic<uint32_t> m_Failed = 0;
+		SHARED<AssetLoadState> m_Done;
+	};
+}
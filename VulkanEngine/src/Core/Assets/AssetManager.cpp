@@ -3,105 +3,431 @@
 #include "MeshAsset.h"
 #include "ShaderAsset.h"
 #include "MaterialAsset.h"
+#include "AssetCooker.h"
 #include "Utils/Utils.h"
+#include "Renderer/UploadQueue.h"
+#include "Jobs/JobSystem.h"
+#include "Vulkan/Utils/VulkanModelUtils.h"
 
 #include <stdexcept>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <mutex>
 
 namespace CHIKU
 {
-	std::unordered_map<AssetHandle, SHARED<Asset>> AssetManager::m_Assets;
+	std::array<AssetSlotMap, AssetTypeCount> AssetManager::m_Registry;
+	std::unordered_map<AssetGUID, AssetHandle> AssetManager::m_GUIDs;
+	std::unordered_map<AssetGUID, SHARED<AssetLoadState>> AssetManager::m_Loading;
 	std::unordered_map<ReadableHandle,AssetHandle> AssetManager::m_Shaders;
+	std::shared_mutex AssetManager::m_NameMutex;
 
 	void AssetManager::Init()
 	{
 		ZoneScoped;
 	}
 
+	static AssetPath GetShaderName(const std::vector<AssetPath>& paths)
+	{
+		AssetPath name;
+		for (const auto& stage : paths)
+		{
+			name += stage + ";";
+		}
+		return name;
+	}
+
+	SHARED<AssetLoadState> AssetManager::Reserve(AssetType type, AssetGUID guid, bool& reserved)
+	{
+		ZoneScoped;
+		std::unique_lock lock(m_NameMutex);
+
+		reserved = false;
+
+		auto loading = m_Loading.find(guid);
+		if (loading != m_Loading.end())
+		{
+			return loading->second;
+		}
+
+		auto it = m_GUIDs.find(guid);
+		if (it != m_GUIDs.end())
+		{
+			return std::make_shared<AssetLoadState>(it->second, AssetLoadStatus::Ready);
+		}
+
+		AssetHandle handle = GetSlotMap(type).Allocate(type);
+		m_GUIDs[guid] = handle;
+
+		SHARED<AssetLoadState> state = std::make_shared<AssetLoadState>(handle);
+		m_Loading[guid] = state;
+		reserved = true;
+
+		return state;
+	}
+
+	void AssetManager::Publish(AssetLoadState& state, AssetGUID guid, SHARED<Asset> asset)
+	{
+		ZoneScoped;
+
+		asset->m_GUID = guid;
+		//Names are registered only once the slot is published, a lookup by name never hands out a handle GetAsset cannot resolve yet
+		SHARED<ShaderAsset> shaderAsset = state.GetHandle().GetType() == AssetType::Shader ? std::static_pointer_cast<ShaderAsset>(asset) : nullptr;
+		GetSlotMap(state.GetHandle().GetType()).Publish(state.GetHandle(), std::move(asset));
+		if (shaderAsset)
+			RegisterShaderName(*shaderAsset, state.GetHandle());
+
+		{
+			std::unique_lock lock(m_NameMutex);
+			m_Loading.erase(guid);
+		}
+
+		state.Complete(AssetLoadStatus::Ready);
+	}
+
+	void AssetManager::Abandon(AssetLoadState& state, AssetGUID guid)
+	{
+		ZoneScoped;
+
+		GetSlotMap(state.GetHandle().GetType()).Remove(state.GetHandle());
+		{
+			std::unique_lock lock(m_NameMutex);
+			m_GUIDs.erase(guid);
+			m_Loading.erase(guid);
+		}
+
+		state.Complete(AssetLoadStatus::Failed);
+	}
+
+	//Model and material loads finish on the UploadQueue, a waiting main thread has to keep pumping it or the load never completes
+	static void WaitForLoad(const AssetLoadState& state)
+	{
+		ZoneScoped;
+
+		while (state.GetStatus() == AssetLoadStatus::Loading)
+		{
+			if (JobSystem::IsWorkerThread())
+				std::this_thread::yield();
+			else
+				UploadQueue::Pump();
+		}
+	}
+
+	template<typename Factory>
+	AssetHandle AssetManager::Register(AssetType type, AssetGUID guid, Factory&& create)
+	{
+		ZoneScoped;
+
+		bool reserved = false;
+		SHARED<AssetLoadState> state = Reserve(type, guid, reserved);
+		if (!reserved)
+		{
+			//The handle of a load in flight only resolves once it is published, sync callers get it after that or not at all
+			WaitForLoad(*state);
+			if (state->GetStatus() != AssetLoadStatus::Ready)
+			{
+				throw std::runtime_error("the load this asset was already requested by failed");
+			}
+
+			return state->GetHandle();
+		}
+
+		//Built outside of any lock, loading an asset usually adds or looks up others
+		SHARED<Asset> asset;
+		try
+		{
+			asset = create(state->GetHandle());
+		}
+		catch (...)
+		{
+			Abandon(*state, guid);
+			throw;
+		}
+
+		Publish(*state, guid, std::move(asset));
+
+		return state->GetHandle();
+	}
+
+	template<>
+	AssetRequest<ModelAsset> AssetManager::LoadAsync<ModelAsset>(const AssetPath& path)
+	{
+		ZoneScoped;
+
+		AssetGUID guid = MakeGUID(AssetType::Model, path);
+		bool reserved = false;
+		SHARED<AssetLoadState> state = Reserve(AssetType::Model, guid, reserved);
+		if (reserved)
+		{
+			LoadModelAsync(state, guid, path);
+		}
+
+		return AssetRequest<ModelAsset>(state);
+	}
+
+	template<>
+	AssetRequest<MaterialAsset> AssetManager::LoadAsync<MaterialAsset>(const AssetPath& path)
+	{
+		ZoneScoped;
+
+		AssetGUID guid = MakeGUID(AssetType::Material, path);
+		bool reserved = false;
+		SHARED<AssetLoadState> state = Reserve(AssetType::Material, guid, reserved);
+		if (reserved)
+		{
+			LoadMaterialAsync(state, guid, path);
+		}
+
+		return AssetRequest<MaterialAsset>(state);
+	}
+
+	template<>
+	AssetRequest<ShaderAsset> AssetManager::LoadAsync<ShaderAsset>(const std::vector<AssetPath>& paths)
+	{
+		ZoneScoped;
+
+		AssetGUID guid = MakeGUID(AssetType::Shader, paths);
+		bool reserved = false;
+		SHARED<AssetLoadState> state = Reserve(AssetType::Shader, guid, reserved);
+		if (reserved)
+		{
+			LoadShaderAsync(state, guid, paths);
+		}
+
+		return AssetRequest<ShaderAsset>(state);
+	}
+
+	//Parameters are taken by value, the coroutine frame outlives the caller's arguments
+	DetachedTask AssetManager::LoadModelAsync(SHARED<AssetLoadState> state, AssetGUID guid, AssetPath path)
+	{
+		SHARED<ModelAsset> modelAsset;
+		try
+		{
+			co_await ResumeOnWorker();
+
+			//Non glTF sources go through an external converter unless the cooker already did, that blocks a worker instead of the caller
+			AssetPath gltfPath = AssetCooker::GetGLTFPath(path);
+
+			//Buffers are mapped rather than read, the interleaving jobs fault in only the pages they touch
+			tinygltf::Model model;
+			Utils::GLTFBuffers buffers;
+			if (!Utils::LoadGLTFMapped(gltfPath, model, buffers))
+			{
+				throw std::runtime_error("failed to parse model: " + gltfPath);
+			}
+
+			//Interleaving fans out over the workers, the main thread only creates the buffers
+			Utils::ImportedModel imported;
+			bool imports = Utils::ImportModel(model, buffers, imported);
+			//The upload only needs the imported copy, the files are unmapped before waiting on the main thread
+			buffers = Utils::GLTFBuffers();
+
+			modelAsset = std::make_shared<ModelAsset>(state->GetHandle());
+			modelAsset->m_SourcePath = path;
+
+			//Meshes and materials create GPU buffers through the graphics queue, that only happens on the main thread
+			co_await ResumeOnUploadQueue();
+
+			if (!modelAsset->LoadModel(model, imported, path) || !imports)
+			{
+				LOG_WARN("Model loaded with errors: " + path);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR("Failed to load model " + path + ": " + e.what());
+			modelAsset = nullptr;
+		}
+
+		if (modelAsset)
+			Publish(*state, guid, modelAsset);
+		else
+			Abandon(*state, guid);
+	}
+
+	DetachedTask AssetManager::LoadMaterialAsync(SHARED<AssetLoadState> state, AssetGUID guid, AssetPath path)
+	{
+		SHARED<MaterialAsset> materialAsset;
+		try
+		{
+			co_await ResumeOnWorker();
+
+			materialAsset = MaterialAsset::Create(state->GetHandle());
+			materialAsset->m_SourcePath = path;
+			Material material = materialAsset->LoadMaterialFromFile(path);
+
+			co_await ResumeOnUploadQueue();
+
+			materialAsset->CreateMaterial(material);
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR("Failed to load material " + path + ": " + e.what());
+			materialAsset = nullptr;
+		}
+
+		if (materialAsset)
+			Publish(*state, guid, materialAsset);
+		else
+			Abandon(*state, guid);
+	}
+
+	DetachedTask AssetManager::LoadShaderAsync(SHARED<AssetLoadState> state, AssetGUID guid, std::vector<AssetPath> paths)
+	{
+		SHARED<ShaderAsset> shaderAsset;
+		try
+		{
+			//Compiling, reflection and shader module creation are all safe off the main thread, the whole load stays on the worker
+			co_await ResumeOnWorker();
+
+			shaderAsset = ShaderAsset::Create(state->GetHandle());
+			shaderAsset->CreateShader(paths);
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR("Failed to load shader " + GetShaderName(paths) + ": " + e.what());
+			shaderAsset = nullptr;
+		}
+
+		if (shaderAsset)
+			Publish(*state, guid, shaderAsset);
+		else
+			Abandon(*state, guid);
+	}
+
 	SHARED<Asset> AssetManager::LoadAsset(const AssetHandle& handle)
 	{
 		ZoneScoped;
-		if (m_Assets.find(handle) != m_Assets.end())
+		SHARED<Asset> asset = GetAsset(handle);
+		if (asset)
 		{
-			return m_Assets[handle];
+			return asset;
 		}
 		
-		LOG_ERROR("Asset with handle not found! handle: " + handle);
+		LOG_ERROR("Asset with handle not found! handle: " + handle.ToString());
 		return nullptr;
 	}
 
 	AssetHandle AssetManager::AddModel(const AssetPath& path)
 	{
 		ZoneScoped;
-		AssetHandle newHandle = Utils::GetRandomNumber<AssetHandle>();
-		m_Assets[newHandle] = std::make_shared<ModelAsset>( newHandle, path);
-
-		return newHandle;
+		return Register(AssetType::Model, MakeGUID(AssetType::Model, path), [&](AssetHandle handle) -> SHARED<Asset>
+			{
+				return std::make_shared<ModelAsset>(handle, path);
+			});
 	}
 
-	AssetHandle AssetManager::AddMesh(const VertexBufferMetaData& metaData ,const std::vector<uint8_t>& data, const std::vector<uint32_t>& indices)
+	AssetHandle AssetManager::AddMesh(const MeshSource& source, const VertexBufferMetaData& metaData, std::span<const uint8_t> data, std::span<const uint32_t> indices, const MeshBounds& bounds)
 	{
 		ZoneScoped;
+		return Register(AssetType::Mesh, MakeGUID(AssetType::Mesh, source.GetName()), [&](AssetHandle handle) -> SHARED<Asset>
+			{
+				SHARED<MeshAsset> meshAsset = MeshAsset::Create(handle);
+				meshAsset->SetSource(source);
+				meshAsset->SetBounds(bounds);
 
-		AssetHandle newHandle = Utils::GetRandomNumber<AssetHandle>();
-		SHARED<MeshAsset> meshAsset = MeshAsset::Create(newHandle);
-		m_Assets[newHandle] = meshAsset;
+				meshAsset->SetMetaData(metaData);
+				meshAsset->SetData(data);
 
-		meshAsset->SetMetaData(metaData);
-		meshAsset->SetData(data);
+				if (!indices.empty())
+					meshAsset->SetIndexData(indices);
 
-		if(!indices.empty())
-			meshAsset->SetIndexData(indices);
-		
-		return newHandle;
+				return meshAsset;
+			});
 	}
 
 	AssetHandle AssetManager::AddMaterial(const AssetPath& path)
 	{
 		ZoneScoped;
-		AssetHandle newHandle = Utils::GetRandomNumber<AssetHandle>();
-		m_Assets[newHandle] = MaterialAsset::Create(newHandle, path);
+		return Register(AssetType::Material, MakeGUID(AssetType::Material, path), [&](AssetHandle handle) -> SHARED<Asset>
+			{
+				return MaterialAsset::Create(handle, path);
+			});
+	}
 
-		return newHandle;
+	AssetHandle AssetManager::AddMaterial(const AssetPath& name, const Material& material)
+	{
+		ZoneScoped;
+		return Register(AssetType::Material, MakeGUID(AssetType::Material, name), [&](AssetHandle handle) -> SHARED<Asset>
+			{
+				SHARED<MaterialAsset> materialAsset = MaterialAsset::Create(handle);
+				materialAsset->CreateMaterial(material);
+				return materialAsset;
+			});
 	}
 
 	AssetHandle AssetManager::AddShader(const std::vector<AssetPath>& path)
 	{
 		ZoneScoped;
-		AssetHandle newHandle = Utils::GetRandomNumber<AssetHandle>();
-		SHARED<ShaderAsset> shaderAsset = ShaderAsset::Create(newHandle);
-		shaderAsset->CreateShader(path);
-		m_Assets[newHandle] = shaderAsset;
 
-		if (m_Shaders.find(shaderAsset->GetShaderHandle()) != m_Shaders.end()) 
+		return Register(AssetType::Shader, MakeGUID(AssetType::Shader, path), [&](AssetHandle handle) -> SHARED<Asset>
+			{
+				SHARED<ShaderAsset> shaderAsset = ShaderAsset::Create(handle);
+				shaderAsset->CreateShader(path);
+
+				return shaderAsset;
+			});
+	}
+
+	void AssetManager::RegisterShaderName(const ShaderAsset& shaderAsset, const AssetHandle& handle)
+	{
+		std::unique_lock lock(m_NameMutex);
+		if (m_Shaders.find(shaderAsset.GetShaderHandle()) != m_Shaders.end()) 
+		{
+			LOG_ERROR("Shader already exists with handle: " + shaderAsset.GetShaderHandle());
+		}
+
+		m_Shaders[shaderAsset.GetShaderHandle()] = handle;
+	}
+
+	bool AssetManager::RemoveAsset(const AssetHandle& assetHandle)
+	{
+		ZoneScoped;
+
+		SHARED<Asset> asset = GetAsset(assetHandle);
+		if (!asset || !GetSlotMap(assetHandle.GetType()).Remove(assetHandle))
 		{
-			LOG_ERROR("Shader already exists with handle: " + shaderAsset->GetShaderHandle());
+			return false;
 		}
 
-		m_Shaders[shaderAsset->GetShaderHandle()] = newHandle;
+		{
+			std::unique_lock lock(m_NameMutex);
+			m_GUIDs.erase(asset->GetGUID());
+			std::erase_if(m_Shaders, [&](const auto& shader) { return shader.second == assetHandle; });
+		}
 
-		return newHandle;
+		asset->CleanUp();
+		return true;
 	}
 
 	void AssetManager::CleanUp()
 	{
 		ZoneScoped;
-		for (auto& asset : m_Assets)
+		for (auto& slotMap : m_Registry)
 		{
-			asset.second->CleanUp();
+			for (auto& asset : slotMap.Release())
+			{
+				if (asset)
+					asset->CleanUp();
+			}
 		}
-		m_Assets.clear();
+
+		std::unique_lock lock(m_NameMutex);
+		m_GUIDs.clear();
+		m_Loading.clear();
+		m_Shaders.clear();
 	}
 
 	AssetHandle AssetManager::GetShaderAssetHandle(const ReadableHandle& shaderHandle) 
 	{
 		ZoneScoped;
+		std::shared_lock lock(m_NameMutex);
 
-		if (m_Shaders.find(shaderHandle) != m_Shaders.end())
+		auto it = m_Shaders.find(shaderHandle);
+		if (it != m_Shaders.end())
 		{
-			return m_Shaders[shaderHandle];
+			return it->second;
 		}
 		
 		return Asset::InvalidHandle;
@@ -111,11 +437,35 @@ namespace CHIKU
 	{
 		ZoneScoped;
 
-		auto it = m_Assets.find(assetHandle);
-		if (assetHandle == Asset::InvalidHandle || it == m_Assets.end())
+		if (!assetHandle.IsValid() || static_cast<size_t>(assetHandle.GetType()) >= AssetTypeCount)
 		{
 			return nullptr;
 		}
-		return it->second;
+
+		return GetSlotMap(assetHandle.GetType()).Get(assetHandle);
+	}
+
+	AssetGUID AssetManager::MakeGUID(AssetType type, const AssetPath& name)
+	{
+		return Utils::HashString(name, Utils::HashString(AssetTypeToString(type)));
+	}
+
+	AssetGUID AssetManager::MakeGUID(AssetType type, const std::vector<AssetPath>& paths)
+	{
+		return MakeGUID(type, GetShaderName(paths));
+	}
+
+	AssetHandle AssetManager::GetHandleFromGUID(AssetGUID guid)
+	{
+		ZoneScoped;
+		std::shared_lock lock(m_NameMutex);
+
+		auto it = m_GUIDs.find(guid);
+		if (it != m_GUIDs.end())
+		{
+			return it->second;
+		}
+
+		return Asset::InvalidHandle;
 	}
-}
\ No newline at end of file
+}
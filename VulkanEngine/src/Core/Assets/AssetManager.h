@@ -1,20 +1,45 @@
 #pragma once
 #include "EngineHeader.h"
 #include "Asset.h"
+#include "AssetSlotMap.h"
+#include "AssetRequest.h"
+#include "Jobs/Async.h"
 #include <memory.h>
+#include <array>
+#include <shared_mutex>
 
 namespace CHIKU
 {
 	struct VertexBufferMetaData;
+	struct MeshSource;
+	struct MeshBounds;
+	struct Material;
+	class ModelAsset;
+	class MaterialAsset;
+	class ShaderAsset;
 
+	//Every asset lives in the slot map of its type, handles resolve without hashing and can be used from any thread.
+	//Adding an asset whose GUID is already registered returns the existing handle, when it is still loading
+	//the add waits for that load and throws if it fails.
 	class AssetManager
 	{
 	public:
 		static SHARED<Asset> LoadAsset(const AssetHandle& assetHandle);
 		static AssetHandle AddModel(const AssetPath& path);
-		static AssetHandle AddMesh(const VertexBufferMetaData& metaData, const std::vector<uint8_t>& data, const std::vector<uint32_t>& indices);
+		//Meshes and materials built from a model are named by the model path and their index inside it
+		static AssetHandle AddMesh(const MeshSource& source, const VertexBufferMetaData& metaData, std::span<const uint8_t> data, std::span<const uint32_t> indices, const MeshBounds& bounds);
 		static AssetHandle AddMaterial(const AssetPath& path);
+		static AssetHandle AddMaterial(const AssetPath& name, const Material& material);
 		static AssetHandle AddShader(const std::vector<AssetPath>& path);
+		static bool RemoveAsset(const AssetHandle& assetHandle);
+
+		//Loads without blocking the caller, file reads and decoding run on job workers and GPU uploads
+		//resume on the UploadQueue. The handle is reserved immediately, asking again for the same asset returns the same load.
+		//Specialized for ModelAsset and MaterialAsset, shaders take their stage sources.
+		template<typename T>
+		static AssetRequest<T> LoadAsync(const AssetPath& path);
+		template<typename T>
+		static AssetRequest<T> LoadAsync(const std::vector<AssetPath>& paths);
 		
 		static void Init();
 		static void CleanUp();
@@ -22,8 +47,46 @@ namespace CHIKU
 		static AssetHandle GetShaderAssetHandle(const ReadableHandle& assetHandle);	
 		static SHARED<Asset> GetAsset(const AssetHandle& assetHandle);
 
+		//Serialization side, GUIDs are stable across runs while handles are not
+		static AssetGUID MakeGUID(AssetType type, const AssetPath& name);
+		//Shaders are named by all of their stage sources
+		static AssetGUID MakeGUID(AssetType type, const std::vector<AssetPath>& paths);
+		static AssetHandle GetHandleFromGUID(AssetGUID guid);
+		//Null while the asset is not loaded or still loading
+		static SHARED<Asset> FindAsset(AssetType type, const AssetPath& name) { return GetAsset(GetHandleFromGUID(MakeGUID(type, name))); }
+
+		//Visits every published asset of a type under a shared lock, the callback must not add or remove assets
+		template<typename Function>
+		static void ForEachAsset(AssetType type, Function&& function) { GetSlotMap(type).ForEach(function); }
+
 	private:
-		static std::unordered_map<AssetHandle, SHARED<Asset>> m_Assets;
+		template<typename Factory>
+		static AssetHandle Register(AssetType type, AssetGUID guid, Factory&& create);
+
+		//Claims the GUID and a slot for a new asset. When the GUID is taken it returns the load that owns it and reserved stays false
+		static SHARED<AssetLoadState> Reserve(AssetType type, AssetGUID guid, bool& reserved);
+		static void Publish(AssetLoadState& state, AssetGUID guid, SHARED<Asset> asset);
+		static void Abandon(AssetLoadState& state, AssetGUID guid);
+
+		static void RegisterShaderName(const ShaderAsset& shaderAsset, const AssetHandle& handle);
+
+		static DetachedTask LoadModelAsync(SHARED<AssetLoadState> state, AssetGUID guid, AssetPath path);
+		static DetachedTask LoadMaterialAsync(SHARED<AssetLoadState> state, AssetGUID guid, AssetPath path);
+		static DetachedTask LoadShaderAsync(SHARED<AssetLoadState> state, AssetGUID guid, std::vector<AssetPath> paths);
+
+		static AssetSlotMap& GetSlotMap(AssetType type) { return m_Registry[static_cast<size_t>(type)]; }
+
+	private:
+		static std::array<AssetSlotMap, AssetTypeCount> m_Registry;
+
+		//Name lookups, only touched when assets are added or found by name
+		static std::unordered_map<AssetGUID, AssetHandle> m_GUIDs;
+		static std::unordered_map<AssetGUID, SHARED<AssetLoadState>> m_Loading;
 		static std::unordered_map<ReadableHandle,AssetHandle> m_Shaders;
+		static std::shared_mutex m_NameMutex;
 	};
-}
\ No newline at end of file
+
+	template<> AssetRequest<ModelAsset> AssetManager::LoadAsync<ModelAsset>(const AssetPath& path);
+	template<> AssetRequest<MaterialAsset> AssetManager::LoadAsync<MaterialAsset>(const AssetPath& path);
+	template<> AssetRequest<ShaderAsset> AssetManager::LoadAsync<ShaderAsset>(const std::vector<AssetPath>& paths);
+}
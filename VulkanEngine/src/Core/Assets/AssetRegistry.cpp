@@ -0,0 +1,299 @@
+#include "AssetRegistry.h"
+#include "AssetGraph.h"
+#include "Utils/Utils.h"
+#include "IO/PackFile.h"
+
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace CHIKU
+{
+	MappedFile AssetRegistry::m_File;
+	const AssetRegistryHeader* AssetRegistry::m_Header = nullptr;
+	const AssetRegistryEntry* AssetRegistry::m_Entries = nullptr;
+	const uint32_t* AssetRegistry::m_Dependencies = nullptr;
+	const char* AssetRegistry::m_Strings = nullptr;
+
+	//Every range an entry points at has to lie inside its table, lookups and the graph index into them unchecked
+	static bool ValidateEntries(const AssetRegistryHeader& header, const AssetRegistryEntry* entries, const uint32_t* dependencies, const char* strings)
+	{
+		for (uint32_t i = 0; i < header.EntryCount; i++)
+		{
+			const AssetRegistryEntry& entry = entries[i];
+
+			if (i > 0 && entries[i - 1].GUID >= entry.GUID)
+				return false;
+
+			if (uint64_t(entry.PathOffset) + entry.PathSize > header.StringsSize)
+				return false;
+
+			//GetPaths reads each path up to its terminator, the last one must not run past the range
+			if (entry.PathSize > 0 && strings[entry.PathOffset + entry.PathSize - 1] != '\0')
+				return false;
+
+			if (uint64_t(entry.FirstDependency) + entry.DependencyCount > header.DependencyCount)
+				return false;
+
+			for (uint32_t d = 0; d < entry.DependencyCount; d++)
+			{
+				if (dependencies[entry.FirstDependency + d] >= header.EntryCount)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool AssetRegistry::Load(const std::string& path)
+	{
+		ZoneScoped;
+
+		Unload();
+		if (!m_File.Open(path))
+			return false;
+
+		const uint8_t* data = m_File.GetData();
+		size_t size = m_File.GetSize();
+
+		if (size < sizeof(AssetRegistryHeader))
+		{
+			LOG_WARN("Asset registry index is truncated: " + path);
+			m_File.Close();
+			return false;
+		}
+
+		const AssetRegistryHeader* header = reinterpret_cast<const AssetRegistryHeader*>(data);
+		if (header->Magic != Magic || header->Version != Version)
+		{
+			LOG_WARN("Asset registry index was written by another version, rebuild it: " + path);
+			m_File.Close();
+			return false;
+		}
+
+		size_t entriesOffset = sizeof(AssetRegistryHeader);
+		size_t dependenciesOffset = entriesOffset + sizeof(AssetRegistryEntry) * header->EntryCount;
+		size_t stringsOffset = dependenciesOffset + sizeof(uint32_t) * header->DependencyCount;
+		if (stringsOffset > size || header->StringsSize > size - stringsOffset)
+		{
+			LOG_WARN("Asset registry index is truncated: " + path);
+			m_File.Close();
+			return false;
+		}
+
+		const AssetRegistryEntry* entries = reinterpret_cast<const AssetRegistryEntry*>(data + entriesOffset);
+		const uint32_t* dependencies = reinterpret_cast<const uint32_t*>(data + dependenciesOffset);
+		const char* strings = reinterpret_cast<const char*>(data + stringsOffset);
+		if (!ValidateEntries(*header, entries, dependencies, strings))
+		{
+			LOG_WARN("Asset registry index is corrupt, rebuild it: " + path);
+			m_File.Close();
+			return false;
+		}
+
+		m_Header = header;
+		m_Entries = entries;
+		m_Dependencies = dependencies;
+		m_Strings = strings;
+
+		TracyPlot("Registered Assets", static_cast<int64_t>(header->EntryCount));
+		return true;
+	}
+
+	void AssetRegistry::Unload()
+	{
+		m_File.Close();
+		m_Header = nullptr;
+		m_Entries = nullptr;
+		m_Dependencies = nullptr;
+		m_Strings = nullptr;
+	}
+
+	const AssetRegistryEntry* AssetRegistry::Find(AssetGUID guid)
+	{
+		std::span<const AssetRegistryEntry> entries = GetEntries();
+		auto it = std::lower_bound(entries.begin(), entries.end(), guid, [](const AssetRegistryEntry& entry, AssetGUID value)
+			{
+				return entry.GUID < value;
+			});
+
+		return it != entries.end() && it->GUID == guid ? &*it : nullptr;
+	}
+
+	std::vector<AssetPath> AssetRegistry::GetPaths(const AssetRegistryEntry& entry)
+	{
+		std::vector<AssetPath> paths;
+
+		const char* path = m_Strings + entry.PathOffset;
+		const char* end = path + entry.PathSize;
+		while (path < end)
+		{
+			AssetPath& added = paths.emplace_back(path);
+			path += added.size() + 1;
+		}
+
+		return paths;
+	}
+
+	static std::vector<char> ReadSourceFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+		{
+			throw std::runtime_error("missing source file: " + path);
+		}
+
+		std::vector<char> data(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(data.data(), data.size());
+		return data;
+	}
+
+	//Every file loading the entry touches: its paths, the buffers and images of a glTF, the compiled SPIR-V of a shader
+	static std::vector<AssetPath> GetSourceFiles(const AssetGraph::Node& node, const std::string& sourceDirectory)
+	{
+		std::vector<AssetPath> files;
+		for (const auto& path : node.Paths)
+		{
+			files.push_back(path);
+
+			if (node.Type == AssetType::Shader && std::filesystem::exists(sourceDirectory + path + ".spv"))
+			{
+				files.push_back(path + ".spv");
+			}
+
+			if (std::filesystem::path(path).extension() == ".gltf")
+			{
+				std::vector<char> json = ReadSourceFile(sourceDirectory + path);
+				nlohmann::json gltf = nlohmann::json::parse(json.begin(), json.end());
+				std::filesystem::path directory = std::filesystem::path(path).parent_path();
+
+				for (const char* section : { "buffers", "images" })
+				{
+					if (!gltf.contains(section))
+						continue;
+
+					for (const auto& item : gltf[section])
+					{
+						std::string uri = item.value("uri", "");
+						if (!uri.empty() && !uri.starts_with("data:"))
+							files.push_back((directory / Utils::DecodeURI(uri)).lexically_normal().generic_string());
+					}
+				}
+			}
+		}
+
+		return files;
+	}
+
+	void AssetRegistry::Build(const std::string& jsonPath, const std::string& outputPath, const std::string& sourceDirectory, const std::string& packPath)
+	{
+		ZoneScoped;
+
+		if (!std::filesystem::exists(jsonPath))
+		{
+			throw std::runtime_error("missing asset registry: " + jsonPath);
+		}
+
+		AssetGraph graph = AssetGraph::FromRegistry(jsonPath);
+
+		//Sorted by GUID so lookups can binary search, dependencies are remapped to the sorted positions
+		std::vector<uint32_t> order(graph.GetNodeCount());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+			{
+				return graph.GetNode(a).GUID < graph.GetNode(b).GUID;
+			});
+
+		std::vector<uint32_t> position(order.size());
+		for (uint32_t i = 0; i < order.size(); i++)
+			position[order[i]] = i;
+
+		UNIQUE<PackWriter> pack = packPath.empty() ? nullptr : std::make_unique<PackWriter>();
+
+		std::vector<AssetRegistryEntry> entries(order.size());
+		std::vector<uint32_t> dependencies;
+		std::string strings;
+
+		for (uint32_t i = 0; i < order.size(); i++)
+		{
+			const AssetGraph::Node& node = graph.GetNode(order[i]);
+			AssetRegistryEntry& entry = entries[i];
+
+			entry.GUID = node.GUID;
+			entry.Type = node.Type;
+			entry.Pack = LoosePack;
+
+			entry.PathOffset = static_cast<uint32_t>(strings.size());
+			for (const auto& path : node.Paths)
+			{
+				strings += path;
+				strings.push_back('\0');
+			}
+			entry.PathSize = static_cast<uint32_t>(strings.size()) - entry.PathOffset;
+
+			entry.FirstDependency = static_cast<uint32_t>(dependencies.size());
+			entry.DependencyCount = static_cast<uint32_t>(node.Dependencies.size());
+			for (uint32_t dependency : node.Dependencies)
+				dependencies.push_back(position[dependency]);
+
+			//Content hash and size cover every file of the entry, the pack range is where its files landed
+			entry.ContentHash = Utils::HashString(AssetTypeToString(entry.Type));
+			uint64_t packStart = pack ? pack->GetOffset() : 0;
+			for (const auto& path : GetSourceFiles(node, sourceDirectory))
+			{
+				std::vector<char> data = ReadSourceFile(sourceDirectory + path);
+				entry.ContentHash = Utils::HashBytes(data.data(), data.size(), entry.ContentHash);
+
+				if (pack)
+				{
+					//Keyed the way FileSystem looks files up
+					pack->Add(Utils::HashString(std::filesystem::path(path).lexically_normal().generic_string()), std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data.data()), data.size()));
+				}
+				else
+				{
+					entry.PackSize += data.size();
+				}
+			}
+
+			if (pack)
+			{
+				entry.Pack = 0;
+				entry.PackOffset = packStart;
+				entry.PackSize = pack->GetOffset() - packStart;
+			}
+		}
+
+		if (pack)
+		{
+			pack->Write(packPath);
+		}
+
+		AssetRegistryHeader header;
+		header.Magic = Magic;
+		header.Version = Version;
+		header.EntryCount = static_cast<uint32_t>(entries.size());
+		header.DependencyCount = static_cast<uint32_t>(dependencies.size());
+		header.StringsSize = strings.size();
+
+		std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			throw std::runtime_error("failed to open for writing: " + outputPath);
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(entries.data()), sizeof(AssetRegistryEntry) * entries.size());
+		file.write(reinterpret_cast<const char*>(dependencies.data()), sizeof(uint32_t) * dependencies.size());
+		file.write(strings.data(), strings.size());
+
+		if (!file.good())
+		{
+			throw std::runtime_error("failed to write: " + outputPath);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Asset.h"
+#include "IO/MappedFile.h"
+#include <span>
+
+namespace CHIKU
+{
+	//On disk layout: header, entries sorted by GUID, dependency indices, path strings.
+	//Everything is read in place from the mapping, nothing is parsed or copied at startup.
+	struct AssetRegistryHeader
+	{
+		uint32_t Magic = 0;
+		uint32_t Version = 0;
+		uint32_t EntryCount = 0;
+		uint32_t DependencyCount = 0;
+		uint64_t StringsSize = 0;
+	};
+
+	struct AssetRegistryEntry
+	{
+		AssetGUID GUID = 0;
+		//Hash of the source files, tells a cook whether the asset changed
+		uint64_t ContentHash = 0;
+		uint64_t PackOffset = 0;
+		uint64_t PackSize = 0;
+		//Paths are null separated, shaders have one per stage
+		uint32_t PathOffset = 0;
+		uint32_t PathSize = 0;
+		//Indices of other entries in the index
+		uint32_t FirstDependency = 0;
+		uint32_t DependencyCount = 0;
+		uint32_t Pack = 0;
+		AssetType Type = AssetType::None;
+		uint8_t Padding[3] = {};
+	};
+
+	static_assert(sizeof(AssetRegistryHeader) == 24, "AssetRegistryHeader is written to disk as is");
+	static_assert(sizeof(AssetRegistryEntry) == 56, "AssetRegistryEntry is written to disk as is");
+
+	//Binary index of every asset the engine knows about, built from AssetRegistry.json by the AssetRegistryBuilder tool.
+	//It is mapped at startup and looked up by binary search over the sorted GUIDs.
+	class AssetRegistry
+	{
+	public:
+		static constexpr uint32_t Magic = 0x52414843; //CHAR
+		static constexpr uint32_t Version = 1;
+		//Entry whose data is still a loose file under the source directory
+		static constexpr uint32_t LoosePack = UINT32_MAX;
+
+		//False when the index is missing, corrupt or was written by another version, the registry stays empty then
+		static bool Load(const std::string& path);
+		static void Unload();
+		static bool IsLoaded() { return m_Header != nullptr; }
+
+		static const AssetRegistryEntry* Find(AssetGUID guid);
+		static std::span<const AssetRegistryEntry> GetEntries() { return { m_Entries, m_Header ? m_Header->EntryCount : 0 }; }
+		static std::span<const uint32_t> GetDependencies(const AssetRegistryEntry& entry) { return { m_Dependencies + entry.FirstDependency, entry.DependencyCount }; }
+		static std::vector<AssetPath> GetPaths(const AssetRegistryEntry& entry);
+
+		//Cooks the JSON registry into an index, source files are read relative to sourceDirectory to hash them.
+		//With a pack path every file an entry needs is compressed into that archive as well. Throws on failure
+		static void Build(const std::string& jsonPath, const std::string& outputPath, const std::string& sourceDirectory, const std::string& packPath = "");
+
+	private:
+		static MappedFile m_File;
+		static const AssetRegistryHeader* m_Header;
+		static const AssetRegistryEntry* m_Entries;
+		static const uint32_t* m_Dependencies;
+		static const char* m_Strings;
+	};
+}
@@ -0,0 +1,37 @@
+#include "AssetRequest.h"
+#include "AssetManager.h"
+
+namespace CHIKU
+{
+	bool AssetLoadState::AddWaiter(std::coroutine_handle<> waiter)
+	{
+		std::lock_guard<std::mutex> lock(m_WaiterMutex);
+		if (GetStatus() != AssetLoadStatus::Loading)
+			return false;
+
+		m_Waiters.push_back(waiter);
+		return true;
+	}
+
+	void AssetLoadState::Complete(AssetLoadStatus status)
+	{
+		ZoneScoped;
+
+		std::vector<std::coroutine_handle<>> waiters;
+		{
+			std::lock_guard<std::mutex> lock(m_WaiterMutex);
+			m_Status.store(status, std::memory_order_release);
+			waiters.swap(m_Waiters);
+		}
+
+		for (auto waiter : waiters)
+		{
+			waiter.resume();
+		}
+	}
+
+	SHARED<Asset> GetLoadedAsset(const AssetHandle& handle)
+	{
+		return AssetManager::GetAsset(handle);
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Asset.h"
+#include <atomic>
+#include <coroutine>
+#include <mutex>
+#include <type_traits>
+
+namespace CHIKU
+{
+	enum class AssetLoadStatus : uint8_t
+	{
+		Loading,
+		Ready,
+		Failed,
+	};
+
+	//Shared between a load in flight and everyone who asked for it.
+	//The handle is reserved up front, the asset behind it is published right before the status turns Ready.
+	class AssetLoadState
+	{
+	public:
+		explicit AssetLoadState(const AssetHandle& handle, AssetLoadStatus status = AssetLoadStatus::Loading)
+			: m_Handle(handle), m_Status(status) {}
+
+		const AssetHandle& GetHandle() const { return m_Handle; }
+		AssetLoadStatus GetStatus() const { return m_Status.load(std::memory_order_acquire); }
+
+		//False when the load already finished and the caller should not suspend
+		bool AddWaiter(std::coroutine_handle<> waiter);
+		//Resumes every waiter on the calling thread
+		void Complete(AssetLoadStatus status);
+
+	private:
+		AssetHandle m_Handle;
+		std::atomic<AssetLoadStatus> m_Status;
+		std::mutex m_WaiterMutex;
+		std::vector<std::coroutine_handle<>> m_Waiters;
+	};
+
+	//AssetManager::GetAsset, kept out of line so this header does not need the AssetManager
+	SHARED<Asset> GetLoadedAsset(const AssetHandle& handle);
+
+	//What AssetManager::LoadAsync hands back. Poll it every frame or co_await it from another coroutine,
+	//a coroutine awaiting it resumes on whichever thread finished the load, the main thread for GPU assets.
+	template<typename T>
+	class AssetRequest
+	{
+	public:
+		AssetRequest() = default;
+		explicit AssetRequest(SHARED<AssetLoadState> state) : m_State(std::move(state)) {}
+
+		//A request for a derived asset can be watched as a request for its base
+		template<typename U> requires std::is_base_of_v<T, U>
+		AssetRequest(const AssetRequest<U>& other) : m_State(other.GetState()) {}
+
+		const SHARED<AssetLoadState>& GetState() const { return m_State; }
+
+		bool IsValid() const { return m_State != nullptr; }
+		bool IsReady() const { return m_State && m_State->GetStatus() == AssetLoadStatus::Ready; }
+		bool IsFailed() const { return !m_State || m_State->GetStatus() == AssetLoadStatus::Failed; }
+		bool IsDone() const { return !m_State || m_State->GetStatus() != AssetLoadStatus::Loading; }
+
+		AssetHandle GetHandle() const { return m_State ? m_State->GetHandle() : Asset::InvalidHandle; }
+
+		//Null until the request is ready. The handle carries the asset type so the cast is always right
+		SHARED<T> Get() const
+		{
+			return IsReady() ? std::static_pointer_cast<T>(GetLoadedAsset(m_State->GetHandle())) : nullptr;
+		}
+
+		bool await_ready() const { return IsDone(); }
+		bool await_suspend(std::coroutine_handle<> waiter) { return m_State->AddWaiter(waiter); }
+		SHARED<T> await_resume() const { return Get(); }
+
+	private:
+		SHARED<AssetLoadState> m_State;
+	};
+}
@@ -0,0 +1,139 @@
+#include "AssetSlotMap.h"
+
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace CHIKU
+{
+	static uint32_t NextGeneration(uint32_t generation)
+	{
+		//Zero is never handed out so a default constructed generation can not match a live slot
+		return generation == std::numeric_limits<uint32_t>::max() ? 1 : generation + 1;
+	}
+
+	AssetHandle AssetSlotMap::Allocate(AssetType type)
+	{
+		ZoneScoped;
+		std::unique_lock lock(m_Mutex);
+
+		uint32_t slotIndex = m_FreeSlot;
+		if (slotIndex != AssetHandle::InvalidIndex)
+		{
+			m_FreeSlot = m_Slots[slotIndex].Next;
+		}
+		else
+		{
+			if (m_Slots.size() >= AssetHandle::MaxSlots)
+			{
+				throw std::runtime_error("too many assets of type " + AssetTypeToString(type) + "!");
+			}
+
+			slotIndex = static_cast<uint32_t>(m_Slots.size());
+			m_Slots.emplace_back();
+		}
+
+		Slot& slot = m_Slots[slotIndex];
+		slot.Next = static_cast<uint32_t>(m_Assets.size());
+		m_Assets.emplace_back(nullptr);
+		m_AssetSlots.push_back(slotIndex);
+
+		return AssetHandle(type, slotIndex, slot.Generation);
+	}
+
+	void AssetSlotMap::Publish(const AssetHandle& handle, SHARED<Asset> asset)
+	{
+		ZoneScoped;
+		std::unique_lock lock(m_Mutex);
+
+		if (!IsLive(handle))
+		{
+			LOG_ERROR("Publishing to a stale asset handle: " + handle.ToString());
+			return;
+		}
+
+		m_Assets[m_Slots[handle.GetSlot()].Next] = std::move(asset);
+	}
+
+	bool AssetSlotMap::Remove(const AssetHandle& handle)
+	{
+		ZoneScoped;
+		std::unique_lock lock(m_Mutex);
+
+		if (!IsLive(handle))
+			return false;
+
+		Slot& slot = m_Slots[handle.GetSlot()];
+		uint32_t removed = slot.Next;
+		uint32_t last = static_cast<uint32_t>(m_Assets.size()) - 1;
+
+		if (removed != last)
+		{
+			m_Assets[removed] = std::move(m_Assets[last]);
+			m_AssetSlots[removed] = m_AssetSlots[last];
+			m_Slots[m_AssetSlots[removed]].Next = removed;
+		}
+
+		m_Assets.pop_back();
+		m_AssetSlots.pop_back();
+
+		slot.Generation = NextGeneration(slot.Generation);
+		slot.Next = m_FreeSlot;
+		m_FreeSlot = handle.GetSlot();
+
+		return true;
+	}
+
+	SHARED<Asset> AssetSlotMap::Get(const AssetHandle& handle) const
+	{
+		std::shared_lock lock(m_Mutex);
+
+		if (!IsLive(handle))
+			return nullptr;
+
+		return m_Assets[m_Slots[handle.GetSlot()].Next];
+	}
+
+	bool AssetSlotMap::Contains(const AssetHandle& handle) const
+	{
+		std::shared_lock lock(m_Mutex);
+		return IsLive(handle);
+	}
+
+	uint32_t AssetSlotMap::GetCount() const
+	{
+		std::shared_lock lock(m_Mutex);
+		return static_cast<uint32_t>(m_Assets.size());
+	}
+
+	std::vector<SHARED<Asset>> AssetSlotMap::Release()
+	{
+		ZoneScoped;
+		std::unique_lock lock(m_Mutex);
+
+		for (uint32_t slotIndex : m_AssetSlots)
+		{
+			Slot& slot = m_Slots[slotIndex];
+			slot.Generation = NextGeneration(slot.Generation);
+			slot.Next = m_FreeSlot;
+			m_FreeSlot = slotIndex;
+		}
+
+		m_AssetSlots.clear();
+		return std::exchange(m_Assets, {});
+	}
+
+	bool AssetSlotMap::IsLive(const AssetHandle& handle) const
+	{
+		if (!handle.IsValid())
+			return false;
+
+		uint32_t slotIndex = handle.GetSlot();
+		if (slotIndex >= m_Slots.size())
+			return false;
+
+		//Free slots already moved on to the next generation, the back reference catches a forged one
+		const Slot& slot = m_Slots[slotIndex];
+		return slot.Generation == handle.Generation && slot.Next < m_AssetSlots.size() && m_AssetSlots[slot.Next] == slotIndex;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Asset.h"
+#include <shared_mutex>
+
+namespace CHIKU
+{
+	//Dense slot map holding every asset of one type.
+	//Handles index a sparse slot array that points into a packed asset array, lookups are two array reads and a generation compare.
+	//Removal swaps the last asset into the hole so the packed array stays dense for iteration.
+	//Reads take a shared lock so worker threads can resolve handles while the main thread keeps adding assets.
+	class AssetSlotMap
+	{
+	public:
+		AssetSlotMap() = default;
+		AssetSlotMap(const AssetSlotMap&) = delete;
+		AssetSlotMap& operator=(const AssetSlotMap&) = delete;
+
+		//Reserves a slot, the asset stays null until Publish so it can be constructed outside the lock
+		AssetHandle Allocate(AssetType type);
+		void Publish(const AssetHandle& handle, SHARED<Asset> asset);
+		bool Remove(const AssetHandle& handle);
+
+		SHARED<Asset> Get(const AssetHandle& handle) const;
+		bool Contains(const AssetHandle& handle) const;
+		uint32_t GetCount() const;
+
+		//Calls function(const SHARED<Asset>&) for every published asset under the shared lock
+		template<typename Function>
+		void ForEach(Function&& function) const
+		{
+			std::shared_lock lock(m_Mutex);
+			for (const auto& asset : m_Assets)
+			{
+				if (asset)
+					function(asset);
+			}
+		}
+
+		//Empties the map and hands back every asset it held, slots are reset so old handles stay invalid
+		std::vector<SHARED<Asset>> Release();
+
+	private:
+		//Index of the packed entry for live slots, next free slot otherwise
+		struct Slot
+		{
+			uint32_t Generation = 1;
+			uint32_t Next = AssetHandle::InvalidIndex;
+		};
+
+		bool IsLive(const AssetHandle& handle) const;
+
+	private:
+		std::vector<Slot> m_Slots;
+		std::vector<SHARED<Asset>> m_Assets;
+		std::vector<uint32_t> m_AssetSlots; //Slot of every packed asset, used to patch the slot when an asset is moved on removal
+		uint32_t m_FreeSlot = AssetHandle::InvalidIndex;
+
+		mutable std::shared_mutex m_Mutex;
+	};
+}
@@ -0,0 +1,283 @@
+#include "CookDatabase.h"
+#include "IO/FileSystem.h"
+#include "Utils/Utils.h"
+
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+namespace CHIKU
+{
+	std::unordered_map<AssetPath, CookDatabase::CookRecord> CookDatabase::m_Records;
+	std::vector<CookRebuild> CookDatabase::m_Rebuilds;
+	bool CookDatabase::m_Dirty = false;
+	std::mutex CookDatabase::m_Mutex;
+
+	void CookDatabase::Load()
+	{
+		ZoneScoped;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Records.clear();
+		m_Rebuilds.clear();
+		m_Dirty = false;
+
+		std::ifstream file(COOK_DATABASE);
+		if (!file)
+			return;
+
+		try
+		{
+			nlohmann::json j;
+			file >> j;
+
+			if (j.value("Version", 0u) != Version)
+			{
+				LOG_WARN("Cook database was written by another version, everything cooks again");
+				return;
+			}
+
+			for (const auto& [output, value] : j.at("Records").items())
+			{
+				CookRecord& record = m_Records[output];
+				record.Tool = value.at("Tool");
+				record.Settings = value.at("Settings");
+				record.ExtraOutputs = value.at("ExtraOutputs").get<std::vector<AssetPath>>();
+
+				for (const auto& input : value.at("Inputs"))
+				{
+					InputStamp& stamp = record.Inputs.emplace_back();
+					stamp.Path = input.at("Path");
+					stamp.Hash = input.at("Hash");
+					stamp.Size = input.at("Size");
+					stamp.Time = input.at("Time");
+				}
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LOG_WARN("Cook database is unreadable, everything cooks again: " + std::string(e.what()));
+			m_Records.clear();
+		}
+	}
+
+	void CookDatabase::Save()
+	{
+		ZoneScoped;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_Dirty)
+			return;
+
+		//Objects keep their keys sorted, the file diffs cleanly between cooks
+		nlohmann::json j;
+		j["Version"] = Version;
+		nlohmann::json& records = j["Records"];
+		for (const auto& [output, record] : m_Records)
+		{
+			nlohmann::json& value = records[output];
+			value["Tool"] = record.Tool;
+			value["Settings"] = record.Settings;
+			value["ExtraOutputs"] = record.ExtraOutputs;
+
+			nlohmann::json& inputs = value["Inputs"] = nlohmann::json::array();
+			for (const auto& stamp : record.Inputs)
+			{
+				inputs.push_back({ { "Path", stamp.Path }, { "Hash", stamp.Hash }, { "Size", stamp.Size }, { "Time", stamp.Time } });
+			}
+		}
+
+		std::ofstream file(COOK_DATABASE, std::ios::trunc);
+		if (!file)
+		{
+			LOG_WARN("Failed to write the cook database, the next run cooks again");
+			return;
+		}
+
+		file << j.dump(1, '\t');
+		m_Dirty = false;
+	}
+
+	bool CookDatabase::Stamp(const AssetPath& path, InputStamp& stamp, bool hash)
+	{
+		ZoneScoped;
+
+		std::string loosePath = FileSystem::GetLoosePath(path);
+
+		std::error_code error;
+		uintmax_t size = std::filesystem::file_size(loosePath, error);
+		if (error)
+			return false;
+
+		auto time = std::filesystem::last_write_time(loosePath, error);
+		if (error)
+			return false;
+
+		stamp.Path = path;
+		stamp.Size = size;
+		stamp.Time = static_cast<int64_t>(time.time_since_epoch().count());
+		if (!hash)
+			return true;
+
+		std::ifstream file(loosePath, std::ios::binary);
+		if (!file)
+			return false;
+
+		uint64_t value = Utils::HashBytes(nullptr, 0);
+		std::vector<char> buffer(64 * 1024);
+		while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0)
+		{
+			value = Utils::HashBytes(buffer.data(), static_cast<size_t>(file.gcount()), value);
+		}
+
+		stamp.Hash = value;
+		return true;
+	}
+
+	RebuildReason CookDatabase::Check(const CookStep& step, std::string* detail)
+	{
+		ZoneScoped;
+
+		std::string unused;
+		std::string& reason = detail ? *detail : unused;
+		AssetPath output = FileSystem::GetRelativePath(step.Output);
+
+		//Packs ship cooked outputs without their sources, what is packed is what gets loaded
+		if (FileSystem::IsPacked(output))
+			return RebuildReason::UpToDate;
+
+		//Copied so the inputs are hashed without holding up every other worker
+		CookRecord record;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			auto it = m_Records.find(output);
+			if (it == m_Records.end())
+				return RebuildReason::NeverCooked;
+
+			record = it->second;
+		}
+
+		std::error_code error;
+		if (!std::filesystem::exists(FileSystem::GetLoosePath(output), error))
+			return RebuildReason::OutputMissing;
+
+		for (const auto& extra : record.ExtraOutputs)
+		{
+			if (!std::filesystem::exists(FileSystem::GetLoosePath(extra), error))
+			{
+				reason = extra;
+				return RebuildReason::OutputMissing;
+			}
+		}
+
+		if (record.Tool != step.Tool)
+		{
+			reason = record.Tool + " -> " + step.Tool;
+			return RebuildReason::ToolChanged;
+		}
+
+		if (record.Settings != step.Settings)
+		{
+			reason = record.Settings + " -> " + step.Settings;
+			return RebuildReason::SettingsChanged;
+		}
+
+		for (const auto& input : step.Inputs)
+		{
+			AssetPath path = FileSystem::GetRelativePath(input);
+			if (std::none_of(record.Inputs.begin(), record.Inputs.end(), [&](const InputStamp& stamp) { return stamp.Path == path; }))
+			{
+				reason = "new input " + path;
+				return RebuildReason::InputChanged;
+			}
+		}
+
+		bool restamped = false;
+		for (auto& recorded : record.Inputs)
+		{
+			InputStamp current;
+			if (!Stamp(recorded.Path, current, false))
+			{
+				reason = recorded.Path + " is missing";
+				return RebuildReason::InputChanged;
+			}
+
+			if (current.Size == recorded.Size && current.Time == recorded.Time)
+				continue;
+
+			//Touched, only the content decides whether it changed
+			if (!Stamp(recorded.Path, current, true) || current.Hash != recorded.Hash)
+			{
+				reason = recorded.Path;
+				return RebuildReason::InputChanged;
+			}
+
+			recorded = current;
+			restamped = true;
+		}
+
+		//Next time the size and write time match again and nothing has to be hashed
+		if (restamped)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			auto it = m_Records.find(output);
+			if (it != m_Records.end() && it->second.Tool == record.Tool && it->second.Settings == record.Settings)
+			{
+				it->second.Inputs = std::move(record.Inputs);
+				m_Dirty = true;
+			}
+		}
+
+		return RebuildReason::UpToDate;
+	}
+
+	void CookDatabase::Record(const CookStep& step, RebuildReason reason, const std::string& detail)
+	{
+		ZoneScoped;
+
+		CookRecord record;
+		record.Tool = step.Tool;
+		record.Settings = step.Settings;
+
+		for (const auto& extra : step.ExtraOutputs)
+			record.ExtraOutputs.push_back(FileSystem::GetRelativePath(extra));
+
+		for (const auto& input : step.Inputs)
+		{
+			InputStamp& stamp = record.Inputs.emplace_back();
+			if (!Stamp(FileSystem::GetRelativePath(input), stamp, true))
+			{
+				//Kept with an empty stamp, the next check sees it as changed and cooks again
+				LOG_WARN("Could not hash cook input " + input);
+				stamp.Path = FileSystem::GetRelativePath(input);
+			}
+		}
+
+		AssetPath output = FileSystem::GetRelativePath(step.Output);
+		LOG_INFO("Cooked " + output + ": " + ToString(reason) + (detail.empty() ? "" : " (" + detail + ")"));
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Records[output] = std::move(record);
+		m_Rebuilds.push_back({ output, reason, detail });
+		m_Dirty = true;
+	}
+
+	std::vector<CookRebuild> CookDatabase::GetRebuilds()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Rebuilds;
+	}
+
+	const char* CookDatabase::ToString(RebuildReason reason)
+	{
+		switch (reason)
+		{
+		case RebuildReason::UpToDate:			return "up to date";
+		case RebuildReason::NeverCooked:		return "never cooked";
+		case RebuildReason::OutputMissing:		return "output missing";
+		case RebuildReason::InputChanged:		return "input changed";
+		case RebuildReason::ToolChanged:		return "tool changed";
+		case RebuildReason::SettingsChanged:	return "settings changed";
+		default: return "unknown";
+		}
+	}
+}
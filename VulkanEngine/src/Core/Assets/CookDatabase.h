@@ -0,0 +1,86 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Asset.h"
+#include <mutex>
+
+namespace CHIKU
+{
+	//One cooked file and everything that went into it
+	struct CookStep
+	{
+		AssetPath Output;
+		//Further files the step wrote, they have to exist for the step to be up to date
+		std::vector<AssetPath> ExtraOutputs;
+		std::vector<AssetPath> Inputs;
+		//Name and version of whatever writes the output
+		std::string Tool;
+		//Anything else that changes the output, flags or format versions
+		std::string Settings;
+	};
+
+	enum class RebuildReason : uint8_t
+	{
+		UpToDate,
+		NeverCooked,
+		OutputMissing,
+		InputChanged,
+		ToolChanged,
+		SettingsChanged,
+	};
+
+	struct CookRebuild
+	{
+		AssetPath Output;
+		RebuildReason Reason = RebuildReason::UpToDate;
+		std::string Detail;
+	};
+
+	//Incremental build state shared by the AssetCooker tool and the runtime. For every cooked output it keeps
+	//the content hash of each input plus the tool and settings it was made with, a step is only redone when one of
+	//them changed. Inputs whose size and write time still match are not hashed again. Safe from any thread.
+	class CookDatabase
+	{
+	public:
+		static constexpr uint32_t Version = 1;
+
+		//A missing or outdated database starts empty, everything cooks once
+		static void Load();
+		//Only writes when something was cooked or re-stamped since the load
+		static void Save();
+
+		//UpToDate when the output exists and was cooked from these inputs, this tool and these settings.
+		//Inputs found while cooking, such as includes, are remembered and checked as well
+		static RebuildReason Check(const CookStep& step, std::string* detail = nullptr);
+		//After the step wrote its output, stores what it was made from and adds it to the rebuild report
+		static void Record(const CookStep& step, RebuildReason reason, const std::string& detail);
+
+		static std::vector<CookRebuild> GetRebuilds();
+		static const char* ToString(RebuildReason reason);
+
+	private:
+		struct InputStamp
+		{
+			AssetPath Path;
+			uint64_t Hash = 0;
+			uint64_t Size = 0;
+			int64_t Time = 0;
+		};
+
+		struct CookRecord
+		{
+			std::vector<AssetPath> ExtraOutputs;
+			std::vector<InputStamp> Inputs;
+			std::string Tool;
+			std::string Settings;
+		};
+
+		//Size and write time always, the content hash only when asked
+		static bool Stamp(const AssetPath& path, InputStamp& stamp, bool hash);
+
+	private:
+		static std::unordered_map<AssetPath, CookRecord> m_Records;
+		static std::vector<CookRebuild> m_Rebuilds;
+		static bool m_Dirty;
+		static std::mutex m_Mutex;
+	};
+}
@@ -1,7 +1,10 @@
 #include "MaterialAsset.h"
 #include "AssetManager.h"
+#include "AssetCooker.h"
+#include "IO/FileSystem.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
+#include <filesystem>
 
 #if defined(RENDERER_VULKAN) || defined(REQUIRED_VR_VULKAN)
 #include "Vulkan/Assets/VulkanMaterialAsset.h"
@@ -30,12 +33,91 @@ namespace CHIKU
         return std::make_shared<VulkanMaterialAsset>(handle,path);
     }
 
+    void MaterialAsset::SetBaseColor(const glm::vec4& color)
+    {
+        ZoneScoped;
+
+        if (m_Material.config.baseColor == color)
+            return;
+
+        m_Material.config.baseColor = color;
+        MarkDirty(Param_BaseColor);
+    }
+
+    void MaterialAsset::SetAlphaCutoff(float cutoff)
+    {
+        ZoneScoped;
+
+        if (m_Material.config.alphaCutoff == cutoff)
+            return;
+
+        m_Material.config.alphaCutoff = cutoff;
+        MarkDirty(Param_AlphaCutoff);
+    }
+
+    void MaterialAsset::MarkDirty(MaterialParameter parameter)
+    {
+        m_Generation++;
+        m_ParameterGenerations[parameter] = m_Generation;
+    }
+
+    MaterialParameterBits MaterialAsset::GetDirtyParameters(uint32_t currentFrame) const
+    {
+        MaterialParameterBits dirty;
+        if (m_UploadedGenerations[currentFrame] == 0)
+            return dirty.set();
+
+        for (uint32_t i = 0; i < Param_Count; i++)
+        {
+            dirty.set(i, m_ParameterGenerations[i] > m_UploadedGenerations[currentFrame]);
+        }
+
+        return dirty;
+    }
+
+    bool MaterialAsset::IsUploaded() const
+    {
+        for (uint64_t generation : m_UploadedGenerations)
+        {
+            if (generation != m_Generation)
+                return false;
+        }
+
+        return true;
+    }
+
     Material MaterialAsset::LoadMaterialFromFile(const AssetPath& filePath)
     {
         ZoneScoped;
 
-        std::string filePathStr = SOURCE_DIR + filePath;
-        std::ifstream file(filePathStr);
+        Material mat;
+        std::filesystem::path sourcePath = SOURCE_DIR + filePath;
+
+        if (sourcePath.extension() == COOKED_MATERIAL_EXTENSION)
+        {
+            if (!LoadCookedMaterial(filePath, mat))
+            {
+                throw std::runtime_error("Failed to load cooked material: " + filePath);
+            }
+
+            return mat;
+        }
+
+        //Only the AssetCooker writes .cmat files, a source edited since the last cook is parsed here instead
+        AssetPath cookedPath = std::filesystem::path(filePath).replace_extension(COOKED_MATERIAL_EXTENSION).generic_string();
+        if (AssetCooker::IsMaterialCooked(filePath) && LoadCookedMaterial(cookedPath, mat))
+        {
+            return mat;
+        }
+
+        return ReadMaterialSource(filePath);
+    }
+
+    Material MaterialAsset::ReadMaterialSource(const AssetPath& filePath)
+    {
+        ZoneScoped;
+
+        std::ifstream file(SOURCE_DIR + filePath);
         if (!file)
         {
             throw std::runtime_error("Failed to open file: " + filePath);
@@ -49,21 +131,100 @@ namespace CHIKU
         mat.shader = j["shader"];
 
         const auto& cfg = j["Config"];
-        mat.config.depthTest = cfg["depthTest"];
-        mat.config.depthWrite = cfg["depthWrite"];
-        mat.config.blendEnabled = cfg["blendEnabled"];
-        mat.config.cullMode = cfg["cullMode"];
-        mat.config.frontFace = cfg["frontFace"];
-        mat.config.polygonMode = cfg["polygonMode"];
-        mat.config.topology = cfg["topology"];
+        mat.state.Cull = CullModeFromString(cfg["cullMode"]);
+        mat.state.Front = FrontFaceFromString(cfg["frontFace"]);
+        mat.state.Polygon = PolygonModeFromString(cfg["polygonMode"]);
+        mat.state.Topology = PrimitiveTopologyFromString(cfg["topology"]);
+        mat.state.DepthTest = cfg["depthTest"];
+        mat.state.DepthWrite = cfg["depthWrite"];
+        mat.state.BlendEnabled = cfg["blendEnabled"];
 
         float r = j["baseColorFactor"][0];
         float g = j["baseColorFactor"][1];
         float b = j["baseColorFactor"][2];
         float w = j["baseColorFactor"][3];
 
-		mat.config.baseColor = glm::vec4(r,g,b,w);
+        mat.config.baseColor = glm::vec4(r,g,b,w);
+
+        //Optional like in glTF, materials without it use the default cutoff
+        if (j.contains("alphaCutoff"))
+        {
+            mat.config.alphaCutoff = j["alphaCutoff"];
+        }
+
+        //Optional, materials written before features existed build the default variant
+        if (j.contains("Features"))
+        {
+            const auto& features = j["Features"];
+            for (uint32_t i = 0; i < Feature_Count; i++)
+            {
+                const std::string key(ShaderFeatureMaterialNames[i]);
+                if (features.contains(key) && features[key].get<bool>())
+                {
+                    mat.features |= 1u << i;
+                }
+            }
+        }
 
         return mat;
     }
-}
\ No newline at end of file
+
+    bool MaterialAsset::CookMaterial(const Material& material, const AssetPath& filePath)
+    {
+        ZoneScoped;
+
+        //Written as raw bytes, padding included, so zero it to keep cooks of the same material identical
+        CookedMaterial cooked;
+        memset(static_cast<void*>(&cooked), 0, sizeof(CookedMaterial));
+        cooked.Magic = COOKED_MATERIAL_MAGIC;
+        cooked.Version = COOKED_MATERIAL_VERSION;
+
+        if (material.name.size() >= sizeof(cooked.Name) || material.shader.size() >= sizeof(cooked.Shader))
+        {
+            LOG_WARN("Material {} has names too long to cook, it will keep loading from source", material.name);
+            return false;
+        }
+
+        memcpy(cooked.Name, material.name.data(), material.name.size());
+        memcpy(cooked.Shader, material.shader.data(), material.shader.size());
+        cooked.State = material.state;
+        cooked.Features = material.features;
+        cooked.BaseColor = material.config.baseColor;
+        cooked.AlphaCutoff = material.config.alphaCutoff;
+
+        std::ofstream file(SOURCE_DIR + filePath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            LOG_WARN("Failed to write cooked material: {}", filePath);
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&cooked), sizeof(CookedMaterial));
+        return file.good();
+    }
+
+    bool MaterialAsset::LoadCookedMaterial(const AssetPath& filePath, Material& material)
+    {
+        ZoneScoped;
+
+        //Through the FileSystem, a pack ships the cooked material without its source
+        CookedMaterial cooked;
+        size_t size = 0;
+        if (!FileSystem::GetFileSize(filePath, size) || size != sizeof(CookedMaterial) ||
+            !FileSystem::ReadFile(filePath, std::span<uint8_t>(reinterpret_cast<uint8_t*>(&cooked), sizeof(CookedMaterial))) ||
+            cooked.Magic != COOKED_MATERIAL_MAGIC || cooked.Version != COOKED_MATERIAL_VERSION)
+        {
+            return false;
+        }
+
+        //Names are always written zero terminated, but do not trust the file for it
+        material.name.assign(cooked.Name, strnlen(cooked.Name, sizeof(cooked.Name)));
+        material.shader.assign(cooked.Shader, strnlen(cooked.Shader, sizeof(cooked.Shader)));
+        material.state = cooked.State;
+        material.features = cooked.Features;
+        material.config.baseColor = cooked.BaseColor;
+        material.config.alphaCutoff = cooked.AlphaCutoff;
+
+        return true;
+    }
+}
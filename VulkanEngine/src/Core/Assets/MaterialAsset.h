@@ -1,22 +1,26 @@
 #pragma once
 #include "Asset.h"
 #include "ShaderAsset.h"
+#include "Renderer/RenderState.h"
 #include <glm/glm.hpp>
 #include "Vulkan/Buffer/VulkanUniformBuffer.h"
 
 namespace CHIKU
 {
+	//Parameters a material uploads to the GPU, each one is dirty tracked on its own
+	enum MaterialParameter : uint32_t
+	{
+		Param_BaseColor,
+		Param_AlphaCutoff,
+		Param_Count
+	};
+
+	using MaterialParameterBits = std::bitset<Param_Count>;
 
 	struct Config
 	{
-		bool depthTest;
-		bool depthWrite;
-		bool blendEnabled;
-		std::string cullMode;
-		std::string frontFace;
-		std::string polygonMode;
-		std::string topology;
-		glm::vec4 baseColor;
+		glm::vec4 baseColor = glm::vec4(1.0f);
+		float alphaCutoff = 0.5f; // glTF default, only read by alpha masked variants
 	};
 
 	struct Material
@@ -24,8 +28,30 @@ namespace CHIKU
 		ReadableHandle name;
 		ReadableHandle shader;
 		Config config;
+		RenderState state; // resolved from the config strings once, cooked materials store it as is
+		ShaderFeatureMask features = 0; // specialization constants the shader is built with
+	};
+
+	#define COOKED_MATERIAL_MAGIC 0x54414D43 // "CMAT"
+	#define COOKED_MATERIAL_VERSION 2
+	#define COOKED_MATERIAL_EXTENSION ".cmat"
+
+	//On disk form of a material, read and written as a single block.
+	//Enums are stored resolved and names inline, so loading needs no parsing at all.
+	struct CookedMaterial
+	{
+		uint32_t Magic = COOKED_MATERIAL_MAGIC;
+		uint32_t Version = COOKED_MATERIAL_VERSION;
+		char Name[64] = {};
+		char Shader[64] = {};
+		RenderState State;
+		ShaderFeatureMask Features = 0;
+		glm::vec4 BaseColor = glm::vec4(1.0f);
+		float AlphaCutoff = 0.5f;
 	};
 
+	static_assert(std::is_trivially_copyable_v<CookedMaterial>, "CookedMaterial is copied as raw bytes");
+
 	class MaterialAsset : public Asset
 	{
 	public:
@@ -33,27 +59,58 @@ namespace CHIKU
 		MaterialAsset(AssetHandle handle) : Asset(handle, AssetType::Material) {}
 		MaterialAsset(AssetHandle handle, AssetPath path) : Asset(handle, AssetType::Material, path) {}
 
-		SHARED<ShaderAsset> GetShader() const { return m_Shader; }
+		const SHARED<ShaderAsset>& GetShader() const { return m_Shader; }
 
 		virtual void CreateMaterial() = 0;
+		virtual void CreateMaterial(const Material& material) = 0;
 		virtual void CreateUniformBuffer() = 0;
 		
+		//Accepts a cooked .cmat or a JSON source. For JSON the .cmat the AssetCooker wrote next to it
+		//is used while it is up to date, otherwise the source is parsed. Never writes anything.
 		virtual Material LoadMaterialFromFile(const AssetPath& filePath) final;
 
+		//Parses a JSON material without cooking it, throws when it cannot be read
+		static Material ReadMaterialSource(const AssetPath& filePath);
+		//False when the material could not be written
+		static bool CookMaterial(const Material& material, const AssetPath& filePath);
+		static bool LoadCookedMaterial(const AssetPath& filePath, Material& material);
+
 		virtual void CleanUp() = 0;
 
 		virtual ~MaterialAsset() = default;
 
-		Material GetMaterial() const { return m_Material; }
+		const Material& GetMaterial() const { return m_Material; }
+		const RenderState& GetRenderState() const { return m_Material.state; }
+		ShaderFeatureMask GetFeatures() const { return m_Material.features; }
+		//Index of the material's record in the material table, pushed per draw
+		uint32_t GetMaterialID() const { return m_MaterialID; }
+
+		void SetBaseColor(const glm::vec4& color);
+		void SetAlphaCutoff(float cutoff);
+
+		//Writes the parameters changed since this frame slot was last written
 		virtual void UpdateUniformBuffer(uint32_t currentFrame) = 0;
 
 		static SHARED<MaterialAsset> Create();
 		static SHARED<MaterialAsset> Create(AssetHandle handle);
 		static SHARED<MaterialAsset> Create(AssetHandle handle, AssetPath path);
 
+	protected:
+		virtual void MarkDirty(MaterialParameter parameter);
+
+		//Parameters whose generation is newer than the one uploaded to a frame slot are dirty for it
+		MaterialParameterBits GetDirtyParameters(uint32_t currentFrame) const;
+		bool IsUploaded() const;
+
 	protected:
 		SHARED<ShaderAsset> m_Shader = nullptr;	
 		std::map<uint32_t, UniformSetStorage> m_UniformSetStorage; //Key is the set Index
 		Material m_Material;
+		uint32_t m_MaterialID = UINT32_MAX;
+
+		//A frame slot that was never written (generation 0) gets the full block
+		uint64_t m_Generation = 1;
+		std::array<uint64_t, Param_Count> m_ParameterGenerations = {};
+		std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_UploadedGenerations = {};
 	};
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 #if defined(RENDERER_VULKAN) || defined(REQUIRED_VR_VULKAN)
 #include "Vulkan/Assets/VulkanMeshAsset.h"
 #endif // RENDERER_VULKAN
+#include "Vulkan/Utils/VulkanModelUtils.h"
+#include "Memory/Memory.h"
+#include "AssetCooker.h"
 
 
 namespace CHIKU
@@ -21,4 +24,102 @@ namespace CHIKU
 	{
 		return std::make_shared<VulkanMeshAsset>(handle,path);
 	}
-}
\ No newline at end of file
+
+	void MeshAsset::SetData(std::span<const uint8_t> data)
+	{
+		ZoneScoped;
+
+		m_VertexBuffer->CreateVertexBuffer(data);
+		m_GPUResident = true;
+	}
+
+	void MeshAsset::SetIndexData(std::span<const uint32_t> indices)
+	{
+		ZoneScoped;
+
+		m_IndexBuffer->CreateIndexBuffer(indices);
+	}
+
+	AssetMemoryUsage MeshAsset::GetMemoryUsage() const
+	{
+		AssetMemoryUsage usage;
+		usage.CPU = m_CookedVertices.capacity() + m_CookedIndices.capacity() * sizeof(uint32_t);
+		usage.GPU = m_VertexBuffer->GetSize() + m_IndexBuffer->GetSize();
+		return usage;
+	}
+
+	bool MeshAsset::LoadCPUData()
+	{
+		ZoneScoped;
+
+		if (m_CPUResident)
+			return true;
+
+		//No copy is kept while the mesh is resident, the only way back is importing the primitive from its model again.
+		//Mapped, so only the pages of this one primitive are read
+		tinygltf::Model model;
+		Utils::GLTFBuffers buffers;
+		AssetPath gltfPath = AssetCooker::GetGLTFPath(m_Source.ModelPath);
+		if (!Utils::LoadGLTFMapped(gltfPath, model, buffers))
+		{
+			LOG_ERROR("Failed to reload " + m_Source.GetName());
+			return false;
+		}
+
+		if (m_Source.MeshIndex >= model.meshes.size() || m_Source.PrimitiveIndex >= model.meshes[m_Source.MeshIndex].primitives.size())
+		{
+			LOG_ERROR("Mesh no longer exists in its model: " + m_Source.GetName());
+			return false;
+		}
+
+		ScratchScope scratch;
+		Utils::ImportedPrimitive imported;
+		const auto& primitive = model.meshes[m_Source.MeshIndex].primitives[m_Source.PrimitiveIndex];
+		if (!Utils::ImportPrimitive(model, buffers, primitive, scratch, imported) || !(imported.MetaData == m_VertexBuffer->GetMetaData()))
+		{
+			LOG_ERROR("Reimported mesh does not match the evicted one: " + m_Source.GetName());
+			return false;
+		}
+
+		m_CookedVertices.assign(imported.Vertices.begin(), imported.Vertices.end());
+		m_CookedIndices.assign(imported.Indices.begin(), imported.Indices.end());
+		m_CPUResident = true;
+
+		return true;
+	}
+
+	void MeshAsset::LoadGPUData()
+	{
+		ZoneScoped;
+
+		if (m_GPUResident || !m_CPUResident)
+			return;
+
+		m_VertexBuffer->CreateVertexBuffer(m_CookedVertices);
+		if (!m_CookedIndices.empty())
+			m_IndexBuffer->CreateIndexBuffer(m_CookedIndices);
+
+		m_GPUResident = true;
+
+		//The upload copied it, holding on would double the memory of every restored mesh
+		UnloadCPUData();
+	}
+
+	void MeshAsset::UnloadCPUData()
+	{
+		ZoneScoped;
+
+		std::vector<uint8_t>().swap(m_CookedVertices);
+		std::vector<uint32_t>().swap(m_CookedIndices);
+		m_CPUResident = false;
+	}
+
+	void MeshAsset::UnloadGPUData()
+	{
+		ZoneScoped;
+
+		m_VertexBuffer->CleanUp();
+		m_IndexBuffer->CleanUp();
+		m_GPUResident = false;
+	}
+}
@@ -4,9 +4,31 @@
 #include "Renderer/Buffer/IndexBuffer.h"
 #include <tiny_gltf.h>
 #include <iostream>
+#include <limits>
 
 namespace CHIKU
 {
+	//Where a mesh comes from inside its model, enough to import it again after its data was evicted
+	struct MeshSource
+	{
+		AssetPath ModelPath;
+		uint32_t MeshIndex = 0;
+		uint32_t PrimitiveIndex = 0;
+
+		//Named by position inside the model so the GUID is the same on every import
+		AssetPath GetName() const { return ModelPath + "#mesh" + std::to_string(MeshIndex) + "/" + std::to_string(PrimitiveIndex); }
+	};
+
+	//Axis aligned box around the mesh's positions, in model space. Starts out empty, a mesh whose positions
+	//could not be measured keeps the empty box and is never culled
+	struct MeshBounds
+	{
+		glm::vec3 Min = glm::vec3(std::numeric_limits<float>::max());
+		glm::vec3 Max = glm::vec3(std::numeric_limits<float>::lowest());
+
+		bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+	};
+
 	class MeshAsset : public Asset
 	{
 	public:
@@ -20,22 +42,42 @@ namespace CHIKU
 			m_IndexBuffer = IndexBuffer::Create();
 		}
 		void SetMetaData(VertexBufferMetaData metaData) { m_VertexBuffer->SetMetaData(metaData); }
-		void SetData(const std::vector<uint8_t>& data) { m_VertexBuffer->CreateVertexBuffer(data); }
-		void SetIndexData(const std::vector<uint32_t>& indices) { m_IndexBuffer->CreateIndexBuffer(indices); }
+		//Uploads the data without keeping a copy, an evicted mesh is imported again from its MeshSource
+		void SetData(std::span<const uint8_t> data);
+		void SetIndexData(std::span<const uint32_t> indices);
+		void SetSource(const MeshSource& source) { m_Source = source; }
+		void SetBounds(const MeshBounds& bounds) { m_Bounds = bounds; }
 
 		virtual void CleanUp() override
 		{
 			m_VertexBuffer->CleanUp();
 			m_IndexBuffer->CleanUp();
+			UnloadCPUData();
+			m_GPUResident = false;
 			Asset::CleanUp();
 		}
+
+		virtual AssetMemoryUsage GetMemoryUsage() const override;
+		virtual bool IsEvictable() const override { return !m_Source.ModelPath.empty(); }
+		virtual bool IsCPUResident() const override { return m_CPUResident; }
+		virtual bool IsGPUResident() const override { return m_GPUResident; }
+		virtual bool LoadCPUData() override;
+		virtual void LoadGPUData() override;
+		virtual void UnloadCPUData() override;
+		virtual void UnloadGPUData() override;
 		
 		inline uint64_t GetVertexCount() const { return m_VertexBuffer->GetCount(); }
+		inline const MeshBounds& GetBounds() const { return m_Bounds; }
 
-		inline const SHARED<VertexBuffer> GetVertexBuffer() const { return m_VertexBuffer; }
-		inline const SHARED<IndexBuffer> GetIndexBuffer() const { return m_IndexBuffer; }
+		inline const SHARED<VertexBuffer>& GetVertexBuffer() const { return m_VertexBuffer; }
+		inline const SHARED<IndexBuffer>& GetIndexBuffer() const { return m_IndexBuffer; }
 		
-		inline void Bind() const { m_VertexBuffer->Bind(); };
+		inline void Bind() const
+		{
+			m_VertexBuffer->Bind();
+			if (m_IndexBuffer->GetCount() > 0)
+				m_IndexBuffer->Bind();
+		}
 		virtual void Draw() const = 0;
 
 		static SHARED<MeshAsset> Create();
@@ -45,5 +87,13 @@ namespace CHIKU
 	protected:
 		SHARED<VertexBuffer> m_VertexBuffer;
 		SHARED<IndexBuffer> m_IndexBuffer;
+
+		MeshSource m_Source;
+		MeshBounds m_Bounds;
+		//Only filled between a restore's LoadCPUData and LoadGPUData, resident meshes live on the GPU alone
+		std::vector<uint8_t> m_CookedVertices;
+		std::vector<uint32_t> m_CookedIndices;
+		bool m_CPUResident = false;
+		bool m_GPUResident = false;
 	};
 }
\ No newline at end of file
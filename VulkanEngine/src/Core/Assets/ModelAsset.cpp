@@ -1,7 +1,8 @@
 #include "ModelAsset.h"
 #include "AssetManager.h"
+#include "AssetCooker.h"
 #include "Vulkan/Utils/VulkanModelUtils.h"
-#include "Renderer/GraphicsPipeline.h"
+#include "Renderer/RenderQueue.h"
 
 #include <nlohmann/json.hpp>
 #include <iostream>
@@ -13,18 +14,22 @@ namespace CHIKU
         ZoneScoped;
 
 		tinygltf::Model model;
-		tinygltf::TinyGLTF loader;
-		std::string err, warn;
-		
-		AssetPath newPath = Utils::ConvertToGLTF(SOURCE_DIR + path);
+		Utils::GLTFBuffers buffers;
+		AssetPath newPath = AssetCooker::GetGLTFPath(path);
 
-		bool ok = loader.LoadASCIIFromFile(&model, &err, &warn, newPath);
-		if (!warn.empty()) std::cout << "Warn: " << warn << "\n";
-		if (!err.empty()) std::cerr << "Err: " << err << "\n";
+		bool ok = Utils::LoadGLTFMapped(newPath, model, buffers);
 
-        std::filesystem::path inputPath = newPath;
+		Utils::ImportedModel imported;
+		ok = ok && Utils::ImportModel(model, buffers, imported);
 
-		Utils::ProcessModel(model, m_MeshesMaterials);
+		return LoadModel(model, imported, path) && ok;
+	}
+
+	bool ModelAsset::LoadModel(const tinygltf::Model& model, const Utils::ImportedModel& imported, const AssetPath& path)
+	{
+		ZoneScoped;
+
+		bool ok = Utils::ProcessModel(model, imported, path, m_MeshesMaterials);
 
 		for (const auto& [meshHandle, materialHandle] : m_MeshesMaterials)
 		{
@@ -36,15 +41,13 @@ namespace CHIKU
         return ok;
 	}
 
-	void ModelAsset::Draw() const
+	void ModelAsset::Draw(const glm::mat4& transform) const
 	{
 		ZoneScoped;
+		//Recording happens in RenderQueue::Flush once every draw of the frame is known
 		for (const auto& [mesh, material] : m_MeshesMaterialsAssets)
 		{
-			GraphicsPipeline::s_Instance->BindPipeline(material, mesh);
-
-			mesh->Bind();
-			mesh->Draw();
+			RenderQueue::Submit(mesh, material, transform);
 		}
 	}
 }
\ No newline at end of file
@@ -3,8 +3,18 @@
 #include "MaterialAsset.h"
 #include <unordered_map>
 
+namespace tinygltf
+{
+	class Model;
+}
+
 namespace CHIKU
 {
+	namespace Utils
+	{
+		struct ImportedModel;
+	}
+
 	class ModelAsset : public Asset
 	{
 	public:
@@ -16,7 +26,10 @@ namespace CHIKU
 		}
 
 		bool LoadModel(const AssetPath& path);
-		void Draw() const;
+		//Builds the meshes and materials of an already parsed and imported model, the import can run on a worker beforehand.
+		//Uploads to the GPU so it runs on the main thread
+		bool LoadModel(const tinygltf::Model& model, const Utils::ImportedModel& imported, const AssetPath& path);
+		void Draw(const glm::mat4& transform = glm::mat4(1.0f)) const;
 
 	private:
 		//The meshes inside the model and the materils for each mesh
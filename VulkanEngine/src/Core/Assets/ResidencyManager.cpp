@@ -0,0 +1,184 @@
+#include "ResidencyManager.h"
+#include "AssetManager.h"
+#include "Renderer/UploadQueue.h"
+
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+
+namespace CHIKU
+{
+	uint64_t ResidencyManager::m_Frame = 0;
+	std::array<ResidencyBudget, AssetTypeCount> ResidencyManager::m_Budgets;
+	std::array<AssetMemoryUsage, AssetTypeCount> ResidencyManager::m_Usage;
+	std::vector<SHARED<Asset>> ResidencyManager::m_Candidates;
+
+	static constexpr uint64_t Megabyte = 1024 * 1024;
+
+	void ResidencyManager::Init()
+	{
+		ZoneScoped;
+
+		m_Frame = 0;
+		m_Budgets = {};
+		m_Usage = {};
+
+		try
+		{
+			YAML::Node config = YAML::LoadFile(ENGINE_CONFIG);
+			YAML::Node residency = config["Residency"];
+			if (!residency)
+				return;
+
+			for (size_t i = 0; i < AssetTypeCount; i++)
+			{
+				YAML::Node budget = residency[AssetTypeToString(static_cast<AssetType>(i))];
+				if (!budget)
+					continue;
+
+				m_Budgets[i].GPU = budget["GPUBudgetMB"].as<uint64_t>(0) * Megabyte;
+			}
+		}
+		catch (const YAML::Exception& e)
+		{
+			LOG_WARN(std::string("Could not read the residency budgets, assets will never be evicted: ") + e.what());
+		}
+	}
+
+	void ResidencyManager::CleanUp()
+	{
+		ZoneScoped;
+		m_Candidates.clear();
+		m_Candidates.shrink_to_fit();
+	}
+
+	void ResidencyManager::Update()
+	{
+		ZoneScoped;
+
+		m_Frame++;
+		AssetMemoryUsage total;
+
+		for (size_t i = 0; i < AssetTypeCount; i++)
+		{
+			AssetType type = static_cast<AssetType>(i);
+			AssetMemoryUsage usage;
+
+			m_Candidates.clear();
+			AssetManager::ForEachAsset(type, [&](const SHARED<Asset>& asset)
+				{
+					//A restore in flight owns the asset's data until it is back on the main thread
+					if (asset->m_Residency.Restoring)
+						return;
+
+					AssetMemoryUsage assetUsage = asset->GetMemoryUsage();
+					usage.CPU += assetUsage.CPU;
+					usage.GPU += assetUsage.GPU;
+
+					if (asset->IsEvictable())
+						m_Candidates.push_back(asset);
+				});
+
+			m_Usage[i] = usage;
+
+			for (const auto& asset : m_Candidates)
+			{
+				const AssetResidency& residency = asset->m_Residency;
+				if (!asset->IsGPUResident() && residency.LastUsedFrame > residency.EvictedFrame)
+				{
+					Restore(asset);
+				}
+			}
+
+			Evict(type);
+
+			total.CPU += m_Usage[i].CPU;
+			total.GPU += m_Usage[i].GPU;
+		}
+
+		//Holding on to the assets would keep removed ones alive
+		m_Candidates.clear();
+
+		TracyPlot("Asset CPU Memory", static_cast<int64_t>(total.CPU));
+		TracyPlot("Asset GPU Memory", static_cast<int64_t>(total.GPU));
+	}
+
+	void ResidencyManager::Evict(AssetType type)
+	{
+		const ResidencyBudget& budget = m_Budgets[static_cast<size_t>(type)];
+		AssetMemoryUsage& usage = m_Usage[static_cast<size_t>(type)];
+
+		auto overGPU = [&]() { return budget.GPU != 0 && usage.GPU > budget.GPU; };
+
+		if (!overGPU())
+			return;
+
+		ZoneScoped;
+
+		std::sort(m_Candidates.begin(), m_Candidates.end(), [](const SHARED<Asset>& a, const SHARED<Asset>& b)
+			{
+				return a->m_Residency.LastUsedFrame < b->m_Residency.LastUsedFrame;
+			});
+
+		uint32_t evicted = 0;
+		for (const auto& asset : m_Candidates)
+		{
+			if (!overGPU())
+				break;
+
+			AssetResidency& residency = asset->m_Residency;
+			if (residency.Restoring)
+				continue;
+
+			AssetMemoryUsage before = asset->GetMemoryUsage();
+
+			//Frames still in flight may read the buffers, only assets unused for longer than that can lose them
+			if (asset->IsGPUResident() && residency.LastUsedFrame + MAX_FRAMES_IN_FLIGHT < m_Frame)
+			{
+				asset->UnloadGPUData();
+				residency.EvictedFrame = m_Frame;
+				evicted++;
+			}
+
+			AssetMemoryUsage after = asset->GetMemoryUsage();
+			usage.GPU -= before.GPU - after.GPU;
+		}
+
+		//Still over budget here means everything left was used within the last frames in flight
+		TracyPlot("Evicted Assets", static_cast<int64_t>(evicted));
+	}
+
+	DetachedTask ResidencyManager::Restore(SHARED<Asset> asset)
+	{
+		asset->m_Residency.Restoring = true;
+
+		bool restored = true;
+		if (!asset->IsCPUResident())
+		{
+			co_await ResumeOnWorker();
+
+			try
+			{
+				restored = asset->LoadCPUData();
+			}
+			catch (const std::exception& e)
+			{
+				LOG_ERROR(std::string("Restoring an asset threw: ") + e.what());
+				restored = false;
+			}
+		}
+
+		co_await ResumeOnUploadQueue();
+
+		if (restored)
+		{
+			asset->LoadGPUData();
+		}
+		else
+		{
+			//Left unloaded instead of retrying every frame it is drawn
+			asset->m_Residency.EvictedFrame = std::numeric_limits<uint64_t>::max();
+		}
+
+		asset->m_Residency.Restoring = false;
+	}
+}
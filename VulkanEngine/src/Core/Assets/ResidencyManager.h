@@ -0,0 +1,47 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Asset.h"
+#include "Jobs/Async.h"
+
+namespace CHIKU
+{
+	//Per type GPU byte budget, 0 means unlimited. Resident assets keep no CPU copy, so there is nothing to budget there
+	struct ResidencyBudget
+	{
+		uint64_t GPU = 0;
+	};
+
+	//Keeps evictable assets inside their budgets by unloading the least recently used ones.
+	//Draws mark what they use, once a type goes over budget the assets unused the longest lose their GPU data.
+	//An evicted asset that gets drawn again is restored in the background from its source,
+	//its draws are skipped until it is back. Only the main thread talks to it.
+	class ResidencyManager
+	{
+	public:
+		//Budgets come from the Residency section of Config.yaml, in megabytes
+		static void Init();
+		static void CleanUp();
+
+		//Once per frame before the upload queue is pumped, accounts memory, evicts and starts restores
+		static void Update();
+
+		//Marks the asset used by the current frame
+		static void Touch(Asset& asset) { asset.m_Residency.LastUsedFrame = m_Frame; }
+
+		static void SetBudget(AssetType type, const ResidencyBudget& budget) { m_Budgets[static_cast<size_t>(type)] = budget; }
+		static const ResidencyBudget& GetBudget(AssetType type) { return m_Budgets[static_cast<size_t>(type)]; }
+		static const AssetMemoryUsage& GetUsage(AssetType type) { return m_Usage[static_cast<size_t>(type)]; }
+
+	private:
+		static void Evict(AssetType type);
+		static DetachedTask Restore(SHARED<Asset> asset);
+
+	private:
+		static uint64_t m_Frame;
+		static std::array<ResidencyBudget, AssetTypeCount> m_Budgets;
+		static std::array<AssetMemoryUsage, AssetTypeCount> m_Usage;
+
+		//Reused every frame so accounting does not allocate once the scene settled
+		static std::vector<SHARED<Asset>> m_Candidates;
+	};
+}
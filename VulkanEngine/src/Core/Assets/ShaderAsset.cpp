@@ -4,6 +4,9 @@
 #include "Vulkan/Assets/VulkanShaderAsset.h"
 #endif // RENDERER_VULKAN
 
+#include "IO/FileSystem.h"
+#include <sstream>
+
 namespace CHIKU
 {
 	SHARED<ShaderAsset> ShaderAsset::Create()
@@ -17,4 +20,36 @@ namespace CHIKU
 		ZoneScoped;
 		return std::make_shared<VulkanShaderAsset>(handle);
 	}
+
+	void ShaderAsset::GetShaderNameAndStage(const AssetPath& path, ReadableHandle& shaderName, ShaderStages& shaderStage)
+	{
+		ZoneScoped;
+
+		shaderName = "Unknown";
+		std::string shaderType = "Unknown";
+
+		std::vector<char> source = FileSystem::ReadFile(path);
+		std::istringstream file(std::string(source.begin(), source.end()));
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.find("//Name:") != std::string::npos)
+			{
+				shaderName = line.substr(line.find(":") + 1);
+				shaderName.erase(0, shaderName.find_first_not_of(" \t")); // trim
+			}
+			else if (line.find("//Type:") != std::string::npos)
+			{
+				shaderType = line.substr(line.find(":") + 1);
+				shaderType.erase(0, shaderType.find_first_not_of(" \t"));
+			}
+		}
+
+		if (shaderType == SHADER_STAGE_VERTEX)              shaderStage = ShaderStages::Stage_Vertex;
+		else if (shaderType == SHADER_STAGE_TESSELATION)    shaderStage = ShaderStages::Stage_Tessellation;
+		else if (shaderType == SHADER_STAGE_GEOMETRY)       shaderStage = ShaderStages::Stage_Geometry;
+		else if (shaderType == SHADER_STAGE_FRAGMENT)       shaderStage = ShaderStages::Stage_Fragment;
+		else if (shaderType == SHADER_STAGE_COMPUTE)        shaderStage = ShaderStages::Stage_Compute;
+		else shaderStage = ShaderStages::Stage_None;
+	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Renderer/Renderer.h"
 #include "Renderer/Buffer/UniformBuffer.h"
 #include "Renderer/Buffer/VertexBuffer.h"
+#include "Renderer/ShaderFeatures.h"
 #include "Vulkan/Assets/VulkanShaderStagesData.h"
 
 #define SHADER_STAGE_VERTEX "Vertex"
@@ -20,7 +21,6 @@
 
 namespace CHIKU
 {
-
 	class ShaderAsset : public Asset
     {
     public:
@@ -40,6 +40,17 @@ namespace CHIKU
 
 		const std::unordered_map<ShaderStages,ShaderStageData>& GetShaderStage() { return m_ShaderStage; }
         ReadableHandle GetShaderHandle() const { return m_ShaderHandle; }
+        bool UsesVertexPulling() const { return m_VertexPulling; }
+        const PushConstantDescription& GetPushConstantRanges() const { return m_PushConstantRanges; }
+        //Members of the MaterialRecord the shader reads from the material table, empty if it reads none
+        const std::vector<UniformMemberInfo>& GetMaterialRecord() const { return m_MaterialRecord; }
+
+        const std::vector<SpecializationConstantInfo>& GetSpecializationConstants() const { return m_SpecializationConstants; }
+        //Features the shader declares a constant for, everything else cannot affect its pipelines
+        ShaderFeatureMask GetFeatureMask() const { return m_FeatureMask; }
+
+        //Reads the //Name: and //Type: header every stage source starts with, works without a device
+        static void GetShaderNameAndStage(const AssetPath& path, ReadableHandle& name, ShaderStages& stage);
 
         static SHARED<ShaderAsset> Create();
         static SHARED<ShaderAsset> Create(AssetHandle handle);
@@ -49,7 +60,12 @@ namespace CHIKU
 		std::vector<AssetPath> m_ShaderSPIRVs;
 
 		std::bitset<ATTR_COUNT> m_InputAttributes;
+        bool m_VertexPulling = false;
+        std::vector<SpecializationConstantInfo> m_SpecializationConstants;
+        ShaderFeatureMask m_FeatureMask = 0;
         UniformBufferDescription m_UniformBufferDescription;
+        PushConstantDescription m_PushConstantRanges;
+        std::vector<UniformMemberInfo> m_MaterialRecord;
         ReadableHandle m_ShaderHandle = "";
         std::unordered_map<ShaderStages, ShaderStageData> m_ShaderStage;
     };
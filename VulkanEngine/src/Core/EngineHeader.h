@@ -16,6 +16,10 @@
 
 #define SOURCE_DIR std::string(CHIKU_SRC_PATH)
 #define ASSET_REGISTRY SOURCE_DIR + std::string(STR(AssetRegistry.json)) 
+#define ASSET_REGISTRY_INDEX SOURCE_DIR + std::string(STR(AssetRegistry.bin))
+#define ASSET_PACK SOURCE_DIR + std::string(STR(Assets.pak))
+#define COOK_DATABASE SOURCE_DIR + std::string(STR(CookDatabase.json))
+#define ENGINE_CONFIG SOURCE_DIR + std::string(STR(Config.yaml))
 
 //#define ENABLE_VALIDATION_LAYERS
 #define DEFAULT_DESCRIPTOR_SET_LAYOUT_BINDING_COUNT 1
@@ -26,6 +30,25 @@
 #define MAX_FRAMES_IN_FLIGHT 3
 #define MAX_DESCRIPTOR_SETS 200
 #define MAX_DESCRIPTOR_SET_LAYOUTS 1000
+#define MAX_STORAGE_BUFFER_BINDINGS 200
+#define MAX_VERTEX_LAYOUTS 256
+#define MAX_MATERIALS 1024
+#define MAX_BOUND_DESCRIPTOR_SETS 8
+
+//Binding 0 of this set is the material parameter table, see MaterialTable
+#define MATERIAL_TABLE_DESCRIPTOR_SET 1
+static_assert(MATERIAL_TABLE_DESCRIPTOR_SET == DEFAULT_DESCRIPTOR_SET_LAYOUT_BINDING_COUNT, "the material table follows the global sets");
+//Every shader pads its MaterialRecord to this stride
+#define MATERIAL_RECORD_STRIDE 64
+
+//Set reserved for vertex pulling shaders, see VertexPulling
+#define VERTEX_PULLING_DESCRIPTOR_SET 2
+//#define ENABLE_VERTEX_PULLING
+
+//Counts heap allocations made while a frame is recorded, see AllocationTracker
+#ifndef NDEBUG
+#define CHIKU_TRACK_ALLOCATIONS
+#endif
 
 #define STR2(x) #x
 #define STR(x) STR2(x)
@@ -51,6 +74,7 @@
 #include <memory>
 #include <algorithm>
 #include <bitset>
+#include <span>
 
 #define SHARED std::shared_ptr
 #define WEAK std::weak_ptr
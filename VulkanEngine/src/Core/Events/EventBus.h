@@ -1,5 +1,6 @@
 #pragma once
 #include "Event.h"
+#include "Memory/MemoryResource.h"
 
 #include <unordered_map>
 #include <vector>
@@ -7,6 +8,8 @@
 #include <typeindex>
 namespace CHIKU
 {
+    //Handler tables are small nodes that live for the whole run, they come out of a pool
+    //instead of the general heap. Publishing itself never allocates.
     class EventBus {
     public:
         using HandlerID = size_t;
@@ -54,7 +57,8 @@ namespace CHIKU
 
     private:
         using WrappedHandler = std::pair<HandlerID, std::function<bool(Event&)>>;
-        std::unordered_map<std::type_index, std::vector<WrappedHandler>> handlers;
+        PoolResource handlerMemory{ "Event Handlers" };
+        std::pmr::unordered_map<std::type_index, std::pmr::vector<WrappedHandler>> handlers{ &handlerMemory };
         HandlerID nextHandlerId = 0;
     };
 }
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "Compression.h"
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+namespace CHIKU
+{
+	namespace Compression
+	{
+		static constexpr size_t MinMatch = 4;
+		static constexpr size_t MaxOffset = 65535;
+		//The tail is always stored as literals so the match finder never reads past the end
+		static constexpr size_t LastLiterals = 5;
+		static constexpr uint32_t HashBits = 14;
+
+		static uint32_t Read32(const uint8_t* data)
+		{
+			uint32_t value;
+			std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		static uint32_t Hash(uint32_t sequence)
+		{
+			return (sequence * 2654435761u) >> (32 - HashBits);
+		}
+
+		static uint8_t* WriteLength(uint8_t* output, size_t length)
+		{
+			while (length >= 255)
+			{
+				*output++ = 255;
+				length -= 255;
+			}
+			*output++ = static_cast<uint8_t>(length);
+			return output;
+		}
+
+		static uint8_t* WriteSequence(uint8_t* output, const uint8_t* literals, size_t literalCount, size_t offset, size_t matchLength)
+		{
+			size_t matchCode = matchLength ? matchLength - MinMatch : 0;
+
+			uint8_t* token = output++;
+			*token = static_cast<uint8_t>((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15));
+
+			if (literalCount >= 15)
+				output = WriteLength(output, literalCount - 15);
+
+			if (literalCount)
+				std::memcpy(output, literals, literalCount);
+			output += literalCount;
+
+			if (matchLength)
+			{
+				*output++ = static_cast<uint8_t>(offset);
+				*output++ = static_cast<uint8_t>(offset >> 8);
+
+				if (matchCode >= 15)
+					output = WriteLength(output, matchCode - 15);
+			}
+
+			return output;
+		}
+
+		size_t GetCompressBound(size_t size)
+		{
+			return size + size / 255 + 16;
+		}
+
+		size_t Compress(std::span<const uint8_t> source, std::span<uint8_t> destination)
+		{
+			ZoneScoped;
+
+			const uint8_t* input = source.data();
+			const size_t size = source.size();
+			uint8_t* output = destination.data();
+
+			size_t anchor = 0;
+			if (size > MinMatch + LastLiterals)
+			{
+				//Last position each hashed 4 byte sequence was seen at
+				std::vector<uint32_t> table(size_t(1) << HashBits, UINT32_MAX);
+
+				const size_t limit = size - LastLiterals;
+				size_t position = 0;
+				uint32_t misses = 0;
+
+				while (position + MinMatch <= limit)
+				{
+					uint32_t sequence = Read32(input + position);
+					uint32_t hash = Hash(sequence);
+					uint32_t candidate = table[hash];
+					table[hash] = static_cast<uint32_t>(position);
+
+					if (candidate == UINT32_MAX || position - candidate > MaxOffset || Read32(input + candidate) != sequence)
+					{
+						//Skips ahead faster the longer nothing matched, incompressible data is not scanned byte by byte
+						position += 1 + (misses++ >> 6);
+						continue;
+					}
+
+					size_t length = MinMatch;
+					while (position + length < limit && input[candidate + length] == input[position + length])
+						length++;
+
+					output = WriteSequence(output, input + anchor, position - anchor, position - candidate, length);
+
+					position += length;
+					anchor = position;
+					misses = 0;
+				}
+			}
+
+			output = WriteSequence(output, input + anchor, size - anchor, 0, 0);
+			return static_cast<size_t>(output - destination.data());
+		}
+
+		//Adds the extension bytes of a length that did not fit its nibble
+		static bool ReadLength(const uint8_t*& input, const uint8_t* end, size_t& length)
+		{
+			uint8_t value;
+			do
+			{
+				if (input == end)
+					return false;
+
+				value = *input++;
+				length += value;
+			} while (value == 255);
+
+			return true;
+		}
+
+		bool Decompress(std::span<const uint8_t> source, std::span<uint8_t> destination)
+		{
+			ZoneScoped;
+
+			const uint8_t* input = source.data();
+			const uint8_t* inputEnd = input + source.size();
+			uint8_t* output = destination.data();
+			uint8_t* outputEnd = output + destination.size();
+
+			while (input < inputEnd)
+			{
+				uint8_t token = *input++;
+
+				size_t literalCount = token >> 4;
+				if (literalCount == 15 && !ReadLength(input, inputEnd, literalCount))
+					return false;
+
+				if (literalCount > static_cast<size_t>(inputEnd - input) || literalCount > static_cast<size_t>(outputEnd - output))
+					return false;
+
+				if (literalCount)
+					std::memcpy(output, input, literalCount);
+				input += literalCount;
+				output += literalCount;
+
+				//The last sequence ends with its literals
+				if (input == inputEnd)
+					break;
+
+				if (inputEnd - input < 2)
+					return false;
+
+				size_t offset = input[0] | (size_t(input[1]) << 8);
+				input += 2;
+
+				size_t matchLength = token & 15;
+				if (matchLength == 15 && !ReadLength(input, inputEnd, matchLength))
+					return false;
+				matchLength += MinMatch;
+
+				if (offset == 0 || offset > static_cast<size_t>(output - destination.data()) || matchLength > static_cast<size_t>(outputEnd - output))
+					return false;
+
+				//Matches may overlap what they produce, a run of one byte is an offset of 1
+				const uint8_t* match = output - offset;
+				if (offset >= matchLength)
+				{
+					std::memcpy(output, match, matchLength);
+					output += matchLength;
+				}
+				else
+				{
+					for (size_t i = 0; i < matchLength; i++)
+						*output++ = match[i];
+				}
+			}
+
+			return output == outputEnd;
+		}
+	}
+}
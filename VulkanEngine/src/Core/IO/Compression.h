@@ -0,0 +1,21 @@
+#pragma once
+#include "EngineHeader.h"
+#include <span>
+
+namespace CHIKU
+{
+	//Byte oriented LZ77 in the spirit of LZ4, tuned for decompression speed over ratio.
+	//A stream is a run of sequences: a token with the literal and match length nibbles, the literals,
+	//a 16 bit back offset and the rest of the match length. The last sequence only has literals.
+	namespace Compression
+	{
+		//Worst case output size, data that does not compress grows by a byte per 255
+		size_t GetCompressBound(size_t size);
+
+		//Returns the compressed size, destination has to hold GetCompressBound(source.size()) bytes
+		size_t Compress(std::span<const uint8_t> source, std::span<uint8_t> destination);
+
+		//False when the stream is corrupt or does not decode to exactly destination.size() bytes
+		bool Decompress(std::span<const uint8_t> source, std::span<uint8_t> destination);
+	}
+}
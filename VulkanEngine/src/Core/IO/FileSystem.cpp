@@ -0,0 +1,151 @@
+#include "FileSystem.h"
+#include "Utils/Utils.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace CHIKU
+{
+	std::vector<SHARED<const PackFile>> FileSystem::m_Packs;
+	std::shared_mutex FileSystem::m_Mutex;
+
+	bool FileSystem::Mount(const std::string& packPath)
+	{
+		ZoneScoped;
+
+		SHARED<PackFile> pack = std::make_shared<PackFile>();
+		if (!pack->Open(packPath))
+			return false;
+
+		std::unique_lock lock(m_Mutex);
+		m_Packs.insert(m_Packs.begin(), std::move(pack));
+		return true;
+	}
+
+	void FileSystem::UnmountAll()
+	{
+		ZoneScoped;
+
+		std::unique_lock lock(m_Mutex);
+		m_Packs.clear();
+	}
+
+	std::string FileSystem::GetRelativePath(const std::string& path)
+	{
+		static const std::string root = std::filesystem::path(SOURCE_DIR).lexically_normal().generic_string();
+
+		std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+		if (normalized.starts_with(root))
+			normalized.erase(0, root.size());
+
+		return normalized;
+	}
+
+	uint64_t FileSystem::HashPath(const std::string& path)
+	{
+		return Utils::HashString(GetRelativePath(path));
+	}
+
+	std::string FileSystem::GetLoosePath(const std::string& path)
+	{
+		return std::filesystem::path(path).is_absolute() ? path : SOURCE_DIR + path;
+	}
+
+	//Reading happens outside the lock, block decompression dispatches jobs that may read files themselves
+	bool FileSystem::FindPacked(const std::string& path, SHARED<const PackFile>& pack, PackFileEntry& entry)
+	{
+		uint64_t hash = HashPath(path);
+
+		std::shared_lock lock(m_Mutex);
+		for (const auto& mounted : m_Packs)
+		{
+			if (const PackFileEntry* found = mounted->Find(hash))
+			{
+				pack = mounted;
+				entry = *found;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool FileSystem::Exists(const std::string& path)
+	{
+		return IsPacked(path) || std::filesystem::exists(GetLoosePath(path));
+	}
+
+	bool FileSystem::IsPacked(const std::string& path)
+	{
+		SHARED<const PackFile> pack;
+		PackFileEntry entry;
+		return FindPacked(path, pack, entry);
+	}
+
+	bool FileSystem::GetFileSize(const std::string& path, size_t& size)
+	{
+		SHARED<const PackFile> pack;
+		PackFileEntry entry;
+		if (FindPacked(path, pack, entry))
+		{
+			size = static_cast<size_t>(entry.Size);
+			return true;
+		}
+
+		std::error_code error;
+		uintmax_t fileSize = std::filesystem::file_size(GetLoosePath(path), error);
+		if (error)
+			return false;
+
+		size = static_cast<size_t>(fileSize);
+		return true;
+	}
+
+	bool FileSystem::ReadFile(const std::string& path, std::span<uint8_t> destination)
+	{
+		ZoneScoped;
+
+		SHARED<const PackFile> pack;
+		PackFileEntry entry;
+		if (FindPacked(path, pack, entry))
+			return pack->Read(entry, destination);
+
+		std::ifstream file(GetLoosePath(path), std::ios::ate | std::ios::binary);
+		if (!file || static_cast<size_t>(file.tellg()) != destination.size())
+			return false;
+
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(destination.data()), destination.size());
+		return file.good();
+	}
+
+	std::vector<char> FileSystem::ReadFile(const std::string& path)
+	{
+		ZoneScoped;
+
+		std::vector<char> data;
+		SHARED<const PackFile> pack;
+		PackFileEntry entry;
+		if (FindPacked(path, pack, entry))
+		{
+			data.resize(static_cast<size_t>(entry.Size));
+			if (!pack->Read(entry, std::span<uint8_t>(reinterpret_cast<uint8_t*>(data.data()), data.size())))
+			{
+				throw std::runtime_error("corrupt packed file: " + path);
+			}
+			return data;
+		}
+
+		std::ifstream file(GetLoosePath(path), std::ios::ate | std::ios::binary);
+		if (!file)
+		{
+			throw std::runtime_error("failed to open file: " + path);
+		}
+
+		data.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(data.data(), data.size());
+		return data;
+	}
+}
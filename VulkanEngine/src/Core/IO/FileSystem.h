@@ -0,0 +1,41 @@
+#pragma once
+#include "EngineHeader.h"
+#include "PackFile.h"
+#include <shared_mutex>
+
+namespace CHIKU
+{
+	//Where asset loaders read their files from. Mounted packs are looked at first, newest mount first,
+	//anything not packed is read as a loose file. Paths are relative to the source directory,
+	//absolute paths inside it are accepted too. Reads are safe from any thread.
+	class FileSystem
+	{
+	public:
+		//False when the pack is missing or invalid, nothing is mounted then
+		static bool Mount(const std::string& packPath);
+		static void UnmountAll();
+
+		//Forward slashes, relative to the source directory. Packs are keyed by the hash of it
+		static std::string GetRelativePath(const std::string& path);
+		static uint64_t HashPath(const std::string& path);
+		//Where the file is on disk when it is not packed
+		static std::string GetLoosePath(const std::string& path);
+
+		static bool Exists(const std::string& path);
+		static bool IsPacked(const std::string& path);
+		static bool GetFileSize(const std::string& path, size_t& size);
+
+		//Reads into caller memory such as a mapped staging buffer, destination has to be exactly the file size
+		static bool ReadFile(const std::string& path, std::span<uint8_t> destination);
+		//Throws when the file is neither packed nor on disk
+		static std::vector<char> ReadFile(const std::string& path);
+
+	private:
+		//Takes the lock only for the lookup. The pack is shared so an unmount cannot free it while it is read
+		static bool FindPacked(const std::string& path, SHARED<const PackFile>& pack, PackFileEntry& entry);
+
+	private:
+		static std::vector<SHARED<const PackFile>> m_Packs;
+		static std::shared_mutex m_Mutex;
+	};
+}
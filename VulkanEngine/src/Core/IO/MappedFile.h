@@ -0,0 +1,38 @@
+#pragma once
+#include "EngineHeader.h"
+#include <span>
+
+namespace CHIKU
+{
+	//Read only view of a whole file through the page cache. Opening costs a few syscalls no matter the size,
+	//pages are faulted in as they are touched so reading a small part of a large file only reads that part.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		//False when the file is missing or empty, the previous mapping is closed either way
+		bool Open(const std::string& path);
+		void Close();
+
+		bool IsOpen() const { return m_Data != nullptr; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+		std::span<const uint8_t> GetSpan() const { return { m_Data, m_Size }; }
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+
+#ifdef PLT_WINDOWS
+		void* m_File = nullptr;
+		void* m_Mapping = nullptr;
+#endif
+	};
+}
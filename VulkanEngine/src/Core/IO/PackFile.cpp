@@ -0,0 +1,190 @@
+#include "PackFile.h"
+#include "Compression.h"
+#include "Jobs/JobSystem.h"
+
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <atomic>
+
+namespace CHIKU
+{
+	bool PackFile::Open(const std::string& path)
+	{
+		ZoneScoped;
+
+		Close();
+		if (!m_File.Open(path))
+			return false;
+
+		const uint8_t* data = m_File.GetData();
+		size_t size = m_File.GetSize();
+
+		const PackHeader* header = reinterpret_cast<const PackHeader*>(data);
+		if (size < sizeof(PackHeader) || header->Magic != Magic || header->Version != Version || header->BlockSize == 0)
+		{
+			LOG_WARN("Not an asset pack of this version: " + path);
+			m_File.Close();
+			return false;
+		}
+
+		uint64_t tableSize = sizeof(PackFileEntry) * uint64_t(header->FileCount) + sizeof(PackBlock) * uint64_t(header->BlockCount);
+		if (header->TableOffset > size || tableSize > size - header->TableOffset)
+		{
+			LOG_WARN("Asset pack is truncated: " + path);
+			m_File.Close();
+			return false;
+		}
+
+		m_Header = header;
+		m_Files = reinterpret_cast<const PackFileEntry*>(data + header->TableOffset);
+		m_Blocks = reinterpret_cast<const PackBlock*>(data + header->TableOffset + sizeof(PackFileEntry) * header->FileCount);
+		return true;
+	}
+
+	void PackFile::Close()
+	{
+		m_File.Close();
+		m_Header = nullptr;
+		m_Files = nullptr;
+		m_Blocks = nullptr;
+	}
+
+	const PackFileEntry* PackFile::Find(uint64_t pathHash) const
+	{
+		std::span<const PackFileEntry> files = GetFiles();
+		auto it = std::lower_bound(files.begin(), files.end(), pathHash, [](const PackFileEntry& entry, uint64_t value)
+			{
+				return entry.PathHash < value;
+			});
+
+		return it != files.end() && it->PathHash == pathHash ? &*it : nullptr;
+	}
+
+	bool PackFile::Read(const PackFileEntry& entry, std::span<uint8_t> destination) const
+	{
+		ZoneScoped;
+
+		const uint64_t blockSize = m_Header->BlockSize;
+		if (destination.size() != entry.Size || uint64_t(entry.FirstBlock) + entry.BlockCount > m_Header->BlockCount ||
+			entry.BlockCount != (entry.Size + blockSize - 1) / blockSize)
+		{
+			return false;
+		}
+
+		const uint8_t* data = m_File.GetData();
+		const uint64_t dataEnd = m_Header->TableOffset;
+		std::atomic<bool> failed = false;
+
+		//Every block but the last is full, so each one knows where it lands without looking at the others
+		JobSystem::Dispatch(entry.BlockCount, [&](uint32_t index)
+			{
+				const PackBlock& block = m_Blocks[entry.FirstBlock + index];
+				uint64_t target = index * blockSize;
+
+				if (block.Offset > dataEnd || block.CompressedSize > dataEnd - block.Offset ||
+					block.Size != std::min<uint64_t>(blockSize, entry.Size - target))
+				{
+					failed.store(true, std::memory_order_relaxed);
+					return;
+				}
+
+				std::span<const uint8_t> source(data + block.Offset, block.CompressedSize);
+				std::span<uint8_t> output = destination.subspan(target, block.Size);
+
+				if (block.CompressedSize == block.Size)
+				{
+					std::copy(source.begin(), source.end(), output.begin());
+				}
+				else if (!Compression::Decompress(source, output))
+				{
+					failed.store(true, std::memory_order_relaxed);
+				}
+			}, JobPriority::Background);
+
+		return !failed.load(std::memory_order_relaxed);
+	}
+
+	bool PackWriter::Add(uint64_t pathHash, std::span<const uint8_t> data)
+	{
+		ZoneScoped;
+
+		for (const auto& file : m_Files)
+		{
+			if (file.PathHash == pathHash)
+				return false;
+		}
+
+		PackFileEntry& entry = m_Files.emplace_back();
+		entry.PathHash = pathHash;
+		entry.Size = data.size();
+		entry.FirstBlock = static_cast<uint32_t>(m_Blocks.size());
+		entry.BlockCount = static_cast<uint32_t>((data.size() + m_BlockSize - 1) / m_BlockSize);
+
+		std::vector<std::vector<uint8_t>> compressed(entry.BlockCount);
+		JobSystem::Dispatch(entry.BlockCount, [&](uint32_t index)
+			{
+				std::span<const uint8_t> block = data.subspan(size_t(index) * m_BlockSize, std::min<size_t>(m_BlockSize, data.size() - size_t(index) * m_BlockSize));
+
+				std::vector<uint8_t>& output = compressed[index];
+				output.resize(Compression::GetCompressBound(block.size()));
+				size_t size = Compression::Compress(block, output);
+
+				//Not worth a decompression pass when it barely shrinks
+				if (size >= block.size() - block.size() / 16)
+					output.assign(block.begin(), block.end());
+				else
+					output.resize(size);
+			});
+
+		for (uint32_t i = 0; i < entry.BlockCount; i++)
+		{
+			PackBlock& block = m_Blocks.emplace_back();
+			block.Offset = GetOffset();
+			block.CompressedSize = static_cast<uint32_t>(compressed[i].size());
+			block.Size = static_cast<uint32_t>(std::min<size_t>(m_BlockSize, data.size() - size_t(i) * m_BlockSize));
+
+			m_Data.insert(m_Data.end(), compressed[i].begin(), compressed[i].end());
+		}
+
+		return true;
+	}
+
+	void PackWriter::Write(const std::string& path) const
+	{
+		ZoneScoped;
+
+		std::vector<PackFileEntry> files = m_Files;
+		std::sort(files.begin(), files.end(), [](const PackFileEntry& a, const PackFileEntry& b)
+			{
+				return a.PathHash < b.PathHash;
+			});
+
+		PackHeader header;
+		header.Magic = PackFile::Magic;
+		header.Version = PackFile::Version;
+		header.FileCount = static_cast<uint32_t>(files.size());
+		header.BlockCount = static_cast<uint32_t>(m_Blocks.size());
+		header.BlockSize = m_BlockSize;
+		//The table is read in place, keep its 64 bit fields aligned
+		header.TableOffset = (GetOffset() + 7) & ~uint64_t(7);
+		const char padding[8] = {};
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			throw std::runtime_error("failed to open for writing: " + path);
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(m_Data.data()), m_Data.size());
+		file.write(padding, header.TableOffset - GetOffset());
+		file.write(reinterpret_cast<const char*>(files.data()), sizeof(PackFileEntry) * files.size());
+		file.write(reinterpret_cast<const char*>(m_Blocks.data()), sizeof(PackBlock) * m_Blocks.size());
+
+		if (!file.good())
+		{
+			throw std::runtime_error("failed to write: " + path);
+		}
+	}
+}
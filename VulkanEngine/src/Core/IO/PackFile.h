@@ -0,0 +1,88 @@
+#pragma once
+#include "EngineHeader.h"
+#include "MappedFile.h"
+#include <span>
+
+namespace CHIKU
+{
+	//On disk layout: header, compressed blocks, then the table of files sorted by path hash and their blocks.
+	//Files are cut into fixed size blocks compressed on their own, so one file decompresses on many threads.
+	struct PackHeader
+	{
+		uint32_t Magic = 0;
+		uint32_t Version = 0;
+		uint32_t FileCount = 0;
+		uint32_t BlockCount = 0;
+		uint32_t BlockSize = 0;
+		uint32_t Padding = 0;
+		uint64_t TableOffset = 0;
+	};
+
+	struct PackFileEntry
+	{
+		uint64_t PathHash = 0;
+		uint64_t Size = 0;
+		uint32_t FirstBlock = 0;
+		uint32_t BlockCount = 0;
+	};
+
+	//A block that did not shrink is stored as is, CompressedSize equals Size then
+	struct PackBlock
+	{
+		uint64_t Offset = 0;
+		uint32_t CompressedSize = 0;
+		uint32_t Size = 0;
+	};
+
+	static_assert(sizeof(PackHeader) == 32, "PackHeader is written to disk as is");
+	static_assert(sizeof(PackFileEntry) == 24, "PackFileEntry is written to disk as is");
+	static_assert(sizeof(PackBlock) == 16, "PackBlock is written to disk as is");
+
+	//Read side of an archive, mapped once and safe to read from any number of threads
+	class PackFile
+	{
+	public:
+		static constexpr uint32_t Magic = 0x4B415043; //CPAK
+		static constexpr uint32_t Version = 1;
+		static constexpr uint32_t DefaultBlockSize = 256 * 1024;
+
+		//False when the file is missing or not an archive of this version
+		bool Open(const std::string& path);
+		void Close();
+		bool IsOpen() const { return m_Header != nullptr; }
+
+		const PackFileEntry* Find(uint64_t pathHash) const;
+		std::span<const PackFileEntry> GetFiles() const { return { m_Files, m_Header ? m_Header->FileCount : 0 }; }
+
+		//Decompresses the file into destination, which has to be exactly entry.Size bytes, for example a mapped staging buffer.
+		//Blocks are spread over the job workers. False when the archive is corrupt
+		bool Read(const PackFileEntry& entry, std::span<uint8_t> destination) const;
+
+	private:
+		MappedFile m_File;
+		const PackHeader* m_Header = nullptr;
+		const PackFileEntry* m_Files = nullptr;
+		const PackBlock* m_Blocks = nullptr;
+	};
+
+	//Builds an archive in memory, blocks are compressed on the job workers as files are added
+	class PackWriter
+	{
+	public:
+		explicit PackWriter(uint32_t blockSize = PackFile::DefaultBlockSize) : m_BlockSize(blockSize) {}
+
+		//False when a file with this hash was added already
+		bool Add(uint64_t pathHash, std::span<const uint8_t> data);
+		//Where the next added file starts in the archive, files are stored in the order they are added
+		uint64_t GetOffset() const { return sizeof(PackHeader) + m_Data.size(); }
+
+		//Throws when the file cannot be written
+		void Write(const std::string& path) const;
+
+	private:
+		uint32_t m_BlockSize;
+		std::vector<PackFileEntry> m_Files;
+		std::vector<PackBlock> m_Blocks;
+		std::vector<uint8_t> m_Data;
+	};
+}
@@ -0,0 +1,39 @@
+#include "Async.h"
+#include "IO/FileSystem.h"
+
+namespace CHIKU
+{
+	void ReadFileAwaiter::await_suspend(std::coroutine_handle<> handle)
+	{
+		Continuation = handle;
+		Run = [](ScheduledJob* job)
+			{
+				ReadFileAwaiter* awaiter = static_cast<ReadFileAwaiter*>(job);
+				{
+					ZoneScopedN("Read File");
+					try
+					{
+						//Packed files decompress on the other workers while this one waits for them
+						awaiter->Data = FileSystem::ReadFile(awaiter->Path);
+					}
+					catch (...)
+					{
+						awaiter->Error = std::current_exception();
+					}
+				}
+
+				//The awaiter belongs to the coroutine frame, nothing may touch it after this
+				awaiter->Continuation.resume();
+			};
+
+		JobSystem::Schedule(this);
+	}
+
+	std::vector<char> ReadFileAwaiter::await_resume()
+	{
+		if (Error)
+			std::rethrow_exception(Error);
+
+		return std::move(Data);
+	}
+}
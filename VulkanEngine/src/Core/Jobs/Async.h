@@ -0,0 +1,63 @@
+#pragma once
+#include "JobSystem.h"
+#include <coroutine>
+#include <exception>
+
+namespace CHIKU
+{
+	//Coroutine that starts right away and frees itself when it finishes, nobody waits on it directly.
+	//Results go out through whatever shared state the coroutine was handed, exceptions must be caught inside.
+	struct DetachedTask
+	{
+		struct promise_type
+		{
+			DetachedTask get_return_object() noexcept { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept
+			{
+				LOG_ERROR("Unhandled exception in a detached coroutine");
+				std::terminate();
+			}
+		};
+	};
+
+	//Suspends the coroutine and hands it to Queue::Schedule, it continues on whatever thread drains that queue.
+	//The node lives in the coroutine frame so scheduling does not allocate.
+	template<typename Queue>
+	struct ScheduleAwaiter : ScheduledJob
+	{
+		std::coroutine_handle<> Continuation;
+
+		bool await_ready() const noexcept { return false; }
+
+		void await_suspend(std::coroutine_handle<> handle)
+		{
+			Continuation = handle;
+			Run = [](ScheduledJob* job) { static_cast<ScheduleAwaiter*>(job)->Continuation.resume(); };
+			Queue::Schedule(this);
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+	//co_await ResumeOnWorker() moves the rest of the coroutine onto a job worker
+	inline ScheduleAwaiter<JobSystem> ResumeOnWorker() { return {}; }
+
+	//Reads a whole file through the FileSystem on a job worker, the coroutine resumes there with the contents.
+	//Throws from co_await when the file can not be read.
+	struct ReadFileAwaiter : ScheduledJob
+	{
+		std::string Path;
+		std::vector<char> Data;
+		std::exception_ptr Error;
+		std::coroutine_handle<> Continuation;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> handle);
+		std::vector<char> await_resume();
+	};
+
+	inline ReadFileAwaiter ReadFileAsync(std::string path) { return { {}, std::move(path) }; }
+}
@@ -0,0 +1,183 @@
+#include "JobSystem.h"
+
+namespace CHIKU
+{
+	std::vector<std::thread> JobSystem::m_Workers;
+	std::vector<JobSystem::JobBatch*> JobSystem::m_Batches;
+	std::vector<JobSystem::JobBatch*> JobSystem::m_BackgroundBatches;
+	ScheduledJob* JobSystem::m_ScheduledHead = nullptr;
+	ScheduledJob* JobSystem::m_ScheduledTail = nullptr;
+	std::mutex JobSystem::m_JobMutex;
+	std::condition_variable JobSystem::m_JobCondition;
+	bool JobSystem::m_Stop = false;
+	thread_local bool JobSystem::s_IsWorker = false;
+
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		ZoneScoped;
+
+		if (workerCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		m_Stop = false;
+		m_Batches.reserve(MaxPendingBatches);
+		m_BackgroundBatches.reserve(MaxPendingBatches);
+		for (uint32_t i = 0; i < workerCount; i++)
+		{
+			m_Workers.emplace_back(&JobSystem::WorkerLoop, i);
+		}
+	}
+
+	void JobSystem::CleanUp()
+	{
+		ZoneScoped;
+
+		{
+			std::lock_guard<std::mutex> lock(m_JobMutex);
+			m_Stop = true;
+		}
+		m_JobCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			if (worker.joinable())
+				worker.join();
+		}
+
+		m_Workers.clear();
+		m_Batches.clear();
+		m_BackgroundBatches.clear();
+		m_ScheduledHead = nullptr;
+		m_ScheduledTail = nullptr;
+	}
+
+	void JobSystem::Dispatch(uint32_t jobCount, JobFunction function, const void* context, JobPriority priority)
+	{
+		ZoneScoped;
+
+		if (jobCount == 0)
+			return;
+
+		//Lives on this frame, which stays alive until every job reported back
+		JobBatch batch{ function, context, jobCount, 0, jobCount };
+
+		bool queued = false;
+		if (!m_Workers.empty() && jobCount > 1)
+		{
+			std::lock_guard<std::mutex> lock(m_JobMutex);
+			std::vector<JobBatch*>& batches = priority == JobPriority::Frame ? m_Batches : m_BackgroundBatches;
+			if (batches.size() < MaxPendingBatches)
+			{
+				batches.push_back(&batch);
+				queued = true;
+			}
+		}
+
+		if (!queued)
+		{
+			for (uint32_t i = 0; i < jobCount; i++)
+				function(context, i);
+			return;
+		}
+
+		m_JobCondition.notify_all();
+
+		//Waiting on frame work never picks up background jobs, so a streaming load cannot hold up the frame
+		bool allowBackground = priority == JobPriority::Background;
+		while (batch.Remaining.load(std::memory_order_acquire) > 0)
+		{
+			if (!RunPendingJob(allowBackground))
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::Schedule(ScheduledJob* job)
+	{
+		ZoneScoped;
+
+		if (m_Workers.empty())
+		{
+			job->Run(job);
+			return;
+		}
+
+		job->Next = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_JobMutex);
+			if (m_ScheduledTail)
+				m_ScheduledTail->Next = job;
+			else
+				m_ScheduledHead = job;
+			m_ScheduledTail = job;
+		}
+
+		m_JobCondition.notify_one();
+	}
+
+	bool JobSystem::RunScheduledJob()
+	{
+		ScheduledJob* job = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_JobMutex);
+			job = m_ScheduledHead;
+			if (!job)
+				return false;
+
+			m_ScheduledHead = job->Next;
+			if (!m_ScheduledHead)
+				m_ScheduledTail = nullptr;
+		}
+
+		job->Run(job);
+		return true;
+	}
+
+	bool JobSystem::RunPendingJob(bool allowBackground)
+	{
+		JobBatch* batch = nullptr;
+		uint32_t index = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_JobMutex);
+			std::vector<JobBatch*>* batches = &m_Batches;
+			if (batches->empty() && allowBackground)
+				batches = &m_BackgroundBatches;
+
+			if (batches->empty())
+				return false;
+
+			batch = batches->front();
+			index = batch->Next++;
+			if (batch->Next == batch->Count)
+				batches->erase(batches->begin());
+		}
+
+		batch->Function(batch->Context, index);
+		batch->Remaining.fetch_sub(1, std::memory_order_release);
+		return true;
+	}
+
+	void JobSystem::WorkerLoop(uint32_t workerIndex)
+	{
+		std::string threadName = "Job Worker " + std::to_string(workerIndex);
+		tracy::SetThreadName(threadName.c_str());
+		s_IsWorker = true;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_JobMutex);
+				m_JobCondition.wait(lock, [] { return m_Stop || !m_Batches.empty() || !m_BackgroundBatches.empty() || m_ScheduledHead; });
+
+				if (m_Stop && m_Batches.empty() && m_BackgroundBatches.empty() && !m_ScheduledHead)
+					return;
+			}
+
+			ZoneScopedN("Job");
+			if (!RunPendingJob(true))
+				RunScheduledJob();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include "EngineHeader.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace CHIKU
+{
+	//Intrusive node for work that runs once on whatever thread its queue drains on.
+	//The scheduler never owns the node, it has to stay alive until Run is called and is not touched after.
+	struct ScheduledJob
+	{
+		void (*Run)(ScheduledJob* job) = nullptr;
+		ScheduledJob* Next = nullptr;
+	};
+
+	//Frame batches are always claimed first. Background batches are fan out from loads and file reads, workers only take
+	//them when no frame batch is pending and a thread waiting on a frame batch never runs them
+	enum class JobPriority : uint8_t
+	{
+		Frame,
+		Background
+	};
+
+	//Fixed pool of worker threads for data parallel work inside a frame.
+	//Dispatch blocks until every job finished, the calling thread runs jobs too instead of sleeping.
+	//A dispatch is one batch on the caller's stack, so dispatching never touches the heap.
+	class JobSystem
+	{
+	public:
+		using JobFunction = void(*)(const void* context, uint32_t index);
+
+		//0 picks one worker per hardware thread minus the calling one
+		static void Init(uint32_t workerCount = 0);
+		static void CleanUp();
+
+		static uint32_t GetWorkerCount() { return static_cast<uint32_t>(m_Workers.size()); }
+		//False on the main thread and any thread the JobSystem did not start
+		static bool IsWorkerThread() { return s_IsWorker; }
+
+		//Runs job(i) for every i in [0, jobCount)
+		template<typename Job>
+		static void Dispatch(uint32_t jobCount, const Job& job, JobPriority priority = JobPriority::Frame)
+		{
+			Dispatch(jobCount, [](const void* context, uint32_t index) { (*static_cast<const Job*>(context))(index); }, &job, priority);
+		}
+
+		static void Dispatch(uint32_t jobCount, JobFunction function, const void* context, JobPriority priority = JobPriority::Frame);
+
+		//Queues fire and forget work like asset loads. Workers prefer dispatched batches so frame work is never stuck behind it,
+		//and the dispatching thread never picks it up. Runs inline when there are no workers.
+		static void Schedule(ScheduledJob* job);
+
+	private:
+		struct JobBatch
+		{
+			JobFunction Function;
+			const void* Context;
+			uint32_t Count;
+			uint32_t Next; //Guarded by m_JobMutex
+			std::atomic<uint32_t> Remaining;
+		};
+
+		static void WorkerLoop(uint32_t workerIndex);
+		//Background batches are only looked at when no frame batch is pending and the caller allows them
+		static bool RunPendingJob(bool allowBackground);
+		static bool RunScheduledJob();
+
+	private:
+		//Batches that still have unclaimed jobs, a batch leaves once its last job is claimed. The limit is per queue
+		static constexpr uint32_t MaxPendingBatches = 64;
+
+		static std::vector<std::thread> m_Workers;
+		static std::vector<JobBatch*> m_Batches;
+		static std::vector<JobBatch*> m_BackgroundBatches;
+		static ScheduledJob* m_ScheduledHead;
+		static ScheduledJob* m_ScheduledTail;
+		static std::mutex m_JobMutex;
+		static std::condition_variable m_JobCondition;
+		static bool m_Stop;
+		static thread_local bool s_IsWorker;
+	};
+}
@@ -0,0 +1,110 @@
+#include "AllocationTracker.h"
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#ifdef PLT_WINDOWS
+#include <malloc.h>
+#endif
+
+namespace CHIKU
+{
+	//Per thread so job workers and the asset threads never trip the render thread's check
+	static thread_local bool s_Tracking = false;
+	static thread_local uint32_t s_AllowDepth = 0;
+	static thread_local uint64_t s_FrameAllocations = 0;
+	static thread_local uint64_t s_FrameAllocatedBytes = 0;
+
+	void AllocationTracker::BeginFrame()
+	{
+#ifdef CHIKU_TRACK_ALLOCATIONS
+		s_FrameAllocations = 0;
+		s_FrameAllocatedBytes = 0;
+		s_Tracking = true;
+#endif
+	}
+
+	void AllocationTracker::EndFrame()
+	{
+#ifdef CHIKU_TRACK_ALLOCATIONS
+		s_Tracking = false;
+
+		TracyPlot("Frame Heap Allocations", static_cast<int64_t>(s_FrameAllocations));
+
+		if (s_FrameAllocations > 0)
+		{
+			LOG_ERROR("{} heap allocations ({} bytes) while recording the frame", s_FrameAllocations, s_FrameAllocatedBytes);
+		}
+
+		assert(s_FrameAllocations == 0 && "the per frame path must not allocate");
+#endif
+	}
+
+	void AllocationTracker::OnAllocation(size_t size)
+	{
+		if (!s_Tracking || s_AllowDepth > 0)
+			return;
+
+		s_FrameAllocations++;
+		s_FrameAllocatedBytes += size;
+	}
+
+	AllocationTracker::AllowScope::AllowScope()
+	{
+		s_AllowDepth++;
+	}
+
+	AllocationTracker::AllowScope::~AllowScope()
+	{
+		s_AllowDepth--;
+	}
+}
+
+#ifdef CHIKU_TRACK_ALLOCATIONS
+//Array, nothrow and sized forms forward to these by default, so replacing the four base forms covers every new/delete.
+//Every heap allocation also shows up in Tracy's memory view.
+void* operator new(size_t size)
+{
+	CHIKU::AllocationTracker::OnAllocation(size);
+
+	void* memory = std::malloc(size ? size : 1);
+	if (!memory)
+		throw std::bad_alloc();
+
+	TracyAlloc(memory, size);
+	return memory;
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	CHIKU::AllocationTracker::OnAllocation(size);
+
+	void* memory = nullptr;
+#ifdef PLT_WINDOWS
+	memory = _aligned_malloc(size ? size : 1, static_cast<size_t>(alignment));
+#else
+	if (posix_memalign(&memory, static_cast<size_t>(alignment), size ? size : 1) != 0)
+		memory = nullptr;
+#endif
+	if (!memory)
+		throw std::bad_alloc();
+
+	TracyAlloc(memory, size);
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	TracyFree(memory);
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	TracyFree(memory);
+#ifdef PLT_WINDOWS
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+#endif // CHIKU_TRACK_ALLOCATIONS
@@ -0,0 +1,30 @@
+#pragma once
+#include "EngineHeader.h"
+
+namespace CHIKU
+{
+	//Debug hook on the global allocator. Renderer::BeginFrame starts counting heap allocations
+	//on the render thread and Renderer::EndFrame asserts none happened, which keeps the per draw path allocation free.
+	//Does nothing unless CHIKU_TRACK_ALLOCATIONS is defined.
+	class AllocationTracker
+	{
+	public:
+		static void BeginFrame();
+		static void EndFrame();
+
+		//Hit by the global operator new, only counts on a thread inside a frame
+		static void OnAllocation(size_t size);
+
+		//Marks a cold path inside the frame that is allowed to allocate,
+		//like creating a pipeline the first time it is drawn or growing a queue past its capacity
+		class AllowScope
+		{
+		public:
+			AllowScope();
+			~AllowScope();
+
+			AllowScope(const AllowScope&) = delete;
+			AllowScope& operator=(const AllowScope&) = delete;
+		};
+	};
+}
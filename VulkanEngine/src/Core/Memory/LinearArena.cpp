@@ -0,0 +1,94 @@
+#include "LinearArena.h"
+#include <cstdlib>
+
+namespace CHIKU
+{
+	static uintptr_t AlignUp(uintptr_t value, size_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	LinearArena::LinearArena(size_t blockSize, const char* name)
+		: m_BlockSize(blockSize), m_Name(name)
+	{
+		m_First = CreateBlock(m_BlockSize);
+		m_Current = m_First;
+	}
+
+	LinearArena::~LinearArena()
+	{
+		Block* block = m_First;
+		while (block)
+		{
+			Block* next = block->Next;
+			TracyFreeN(block, m_Name);
+			std::free(block);
+			block = next;
+		}
+	}
+
+	void* LinearArena::Allocate(size_t size, size_t alignment)
+	{
+		while (true)
+		{
+			uintptr_t data = reinterpret_cast<uintptr_t>(GetBlockData(m_Current));
+			size_t offset = AlignUp(data + m_Current->Offset, alignment) - data;
+
+			if (offset + size <= m_Current->Size)
+			{
+				m_Current->Offset = offset + size;
+				return GetBlockData(m_Current) + offset;
+			}
+
+			Block* next = m_Current->Next;
+			if (!next || next->Size < size + alignment)
+			{
+				//Inserted right after the current block, blocks further down stay in the chain for reuse
+				Block* block = CreateBlock(std::max(m_BlockSize, size + alignment));
+				block->Next = next;
+				m_Current->Next = block;
+				next = block;
+			}
+
+			m_Current = next;
+			m_Current->Offset = 0;
+		}
+	}
+
+	LinearArena::Marker LinearArena::GetMarker() const
+	{
+		return { m_Current, m_Current->Offset };
+	}
+
+	void LinearArena::Rewind(const Marker& marker)
+	{
+		m_Current = static_cast<Block*>(marker.Block);
+		m_Current->Offset = marker.Offset;
+	}
+
+	void LinearArena::Reset()
+	{
+		m_Current = m_First;
+		m_Current->Offset = 0;
+	}
+
+	LinearArena::Block* LinearArena::CreateBlock(size_t minimumSize)
+	{
+		ZoneScoped;
+
+		//Straight from malloc, arena blocks are the memory the allocation tracker is meant to steer code to
+		Block* block = static_cast<Block*>(std::malloc(sizeof(Block) + minimumSize));
+		if (!block)
+		{
+			throw std::runtime_error("failed to allocate arena block!");
+		}
+
+		TracyAllocN(block, sizeof(Block) + minimumSize, m_Name);
+
+		block->Next = nullptr;
+		block->Size = minimumSize;
+		block->Offset = 0;
+		m_Capacity += minimumSize;
+		return block;
+	}
+}
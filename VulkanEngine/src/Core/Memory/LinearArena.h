@@ -0,0 +1,61 @@
+#pragma once
+#include "EngineHeader.h"
+#include <cstddef>
+
+namespace CHIKU
+{
+	//Bump allocator over a chain of blocks. Individual allocations are never freed,
+	//the arena is rewound to a marker or reset as a whole. Blocks are kept for reuse,
+	//so an arena that reached its working size stops touching the system allocator.
+	//Not thread safe, every thread gets its own arenas through Memory.
+	class LinearArena
+	{
+	public:
+		explicit LinearArena(size_t blockSize = 1024 * 1024, const char* name = "Linear Arena");
+		~LinearArena();
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		//Uninitialized storage for count objects of T
+		template<typename T>
+		T* Allocate(size_t count = 1)
+		{
+			return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		struct Marker
+		{
+			void* Block = nullptr;
+			size_t Offset = 0;
+		};
+
+		Marker GetMarker() const;
+		//Frees everything allocated after the marker was taken
+		void Rewind(const Marker& marker);
+		void Reset();
+
+		size_t GetCapacity() const { return m_Capacity; }
+
+	private:
+		//Keeps the data that follows the header max_align_t aligned
+		struct alignas(std::max_align_t) Block
+		{
+			Block* Next;
+			size_t Size;
+			size_t Offset;
+		};
+
+		Block* CreateBlock(size_t minimumSize);
+		static uint8_t* GetBlockData(Block* block) { return reinterpret_cast<uint8_t*>(block + 1); }
+
+	private:
+		Block* m_First = nullptr;
+		Block* m_Current = nullptr;
+		size_t m_BlockSize;
+		size_t m_Capacity = 0;
+		const char* m_Name; //Tracy keys memory pools by this pointer
+	};
+}
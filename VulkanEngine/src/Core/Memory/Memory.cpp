@@ -0,0 +1,37 @@
+#include "Memory.h"
+
+namespace CHIKU
+{
+	LinearArena& Memory::GetFrameArena()
+	{
+		static thread_local LinearArena arena(4 * 1024 * 1024, "Frame Arena");
+		return arena;
+	}
+
+	std::pmr::memory_resource* Memory::GetFrameResource()
+	{
+		static thread_local ArenaResource resource(GetFrameArena());
+		return &resource;
+	}
+
+	void Memory::ResetFrameArena()
+	{
+		GetFrameArena().Reset();
+	}
+
+	LinearArena& Memory::GetScratchArena()
+	{
+		static thread_local LinearArena arena(1024 * 1024, "Scratch Arena");
+		return arena;
+	}
+
+	ScratchScope::ScratchScope()
+		: m_Arena(Memory::GetScratchArena()), m_Marker(m_Arena.GetMarker()), m_Resource(m_Arena)
+	{
+	}
+
+	ScratchScope::~ScratchScope()
+	{
+		m_Arena.Rewind(m_Marker);
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "MemoryResource.h"
+
+namespace CHIKU
+{
+	//Per thread arenas for memory that does not outlive a frame or a scope.
+	//The frame arena is rewound by whoever drives the thread's frame, Renderer::BeginFrame for the render thread.
+	//The scratch arena is stack like, use it through ScratchScope.
+	class Memory
+	{
+	public:
+		static LinearArena& GetFrameArena();
+		static std::pmr::memory_resource* GetFrameResource();
+		static void ResetFrameArena();
+
+		static LinearArena& GetScratchArena();
+	};
+
+	//Everything allocated from the calling thread's scratch arena while this is alive is released with it.
+	//Scopes nest, an inner scope must end before the outer one.
+	class ScratchScope
+	{
+	public:
+		ScratchScope();
+		~ScratchScope();
+
+		ScratchScope(const ScratchScope&) = delete;
+		ScratchScope& operator=(const ScratchScope&) = delete;
+
+		template<typename T>
+		T* Allocate(size_t count = 1) { return m_Arena.Allocate<T>(count); }
+
+		//For std::pmr containers that live inside the scope
+		std::pmr::memory_resource* GetResource() { return &m_Resource; }
+
+	private:
+		LinearArena& m_Arena;
+		LinearArena::Marker m_Marker;
+		ArenaResource m_Resource;
+	};
+}
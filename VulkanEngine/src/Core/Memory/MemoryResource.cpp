@@ -0,0 +1,49 @@
+#include "MemoryResource.h"
+
+namespace CHIKU
+{
+	PoolResource::PoolResource(const char* name, std::pmr::memory_resource* upstream)
+		: m_Upstream(upstream)
+	{
+		for (uint32_t i = 0; i < PoolCount; i++)
+		{
+			m_Pools[i] = std::make_unique<PoolAllocator>(SmallestBlock << i, 256, name);
+		}
+	}
+
+	uint32_t PoolResource::GetPoolIndex(size_t bytes, size_t alignment)
+	{
+		if (alignment > alignof(std::max_align_t))
+			return PoolCount;
+
+		size_t blockSize = SmallestBlock;
+		for (uint32_t i = 0; i < PoolCount; i++, blockSize <<= 1)
+		{
+			if (bytes <= blockSize)
+				return i;
+		}
+
+		return PoolCount;
+	}
+
+	void* PoolResource::do_allocate(size_t bytes, size_t alignment)
+	{
+		uint32_t pool = GetPoolIndex(bytes, alignment);
+		if (pool == PoolCount)
+			return m_Upstream->allocate(bytes, alignment);
+
+		return m_Pools[pool]->Allocate();
+	}
+
+	void PoolResource::do_deallocate(void* memory, size_t bytes, size_t alignment)
+	{
+		uint32_t pool = GetPoolIndex(bytes, alignment);
+		if (pool == PoolCount)
+		{
+			m_Upstream->deallocate(memory, bytes, alignment);
+			return;
+		}
+
+		m_Pools[pool]->Free(memory);
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "LinearArena.h"
+#include "PoolAllocator.h"
+#include <memory_resource>
+
+namespace CHIKU
+{
+	//std::pmr view of a LinearArena, deallocation is a no-op and memory returns when the arena rewinds
+	class ArenaResource : public std::pmr::memory_resource
+	{
+	public:
+		explicit ArenaResource(LinearArena& arena) : m_Arena(arena) {}
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override { return m_Arena.Allocate(bytes, alignment); }
+		void do_deallocate(void*, size_t, size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	private:
+		LinearArena& m_Arena;
+	};
+
+	//Small requests are served from power of two PoolAllocators, anything larger goes upstream.
+	//For long lived containers of small nodes like maps, lists and handler tables. Not thread safe.
+	class PoolResource : public std::pmr::memory_resource
+	{
+	public:
+		explicit PoolResource(const char* name = "Pool Resource", std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* memory, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		//Index of the pool serving the request, PoolCount when it goes upstream
+		static uint32_t GetPoolIndex(size_t bytes, size_t alignment);
+
+	private:
+		static constexpr uint32_t PoolCount = 5; //16 to 256 bytes
+		static constexpr size_t SmallestBlock = 16;
+
+		std::array<std::unique_ptr<PoolAllocator>, PoolCount> m_Pools;
+		std::pmr::memory_resource* m_Upstream;
+	};
+}
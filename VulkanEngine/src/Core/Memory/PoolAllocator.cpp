@@ -0,0 +1,72 @@
+#include "PoolAllocator.h"
+#include <cstdlib>
+
+namespace CHIKU
+{
+	static constexpr size_t ChunkHeaderSize = alignof(std::max_align_t);
+
+	PoolAllocator::PoolAllocator(size_t blockSize, size_t blocksPerChunk, const char* name)
+		: m_BlockSize(std::max(blockSize, sizeof(FreeBlock))), m_BlocksPerChunk(blocksPerChunk), m_Name(name)
+	{
+		//Blocks are laid out back to back, rounding keeps every one of them max aligned
+		m_BlockSize = (m_BlockSize + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+	}
+
+	PoolAllocator::~PoolAllocator()
+	{
+		void* chunk = m_Chunks;
+		while (chunk)
+		{
+			void* previous = *static_cast<void**>(chunk);
+			TracyFreeN(chunk, m_Name);
+			std::free(chunk);
+			chunk = previous;
+		}
+	}
+
+	void* PoolAllocator::Allocate()
+	{
+		if (!m_FreeList)
+			CreateChunk();
+
+		FreeBlock* block = m_FreeList;
+		m_FreeList = block->Next;
+		return block;
+	}
+
+	void PoolAllocator::Free(void* block)
+	{
+		if (!block)
+			return;
+
+		FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+		freeBlock->Next = m_FreeList;
+		m_FreeList = freeBlock;
+	}
+
+	void PoolAllocator::CreateChunk()
+	{
+		ZoneScoped;
+
+		size_t chunkSize = ChunkHeaderSize + m_BlockSize * m_BlocksPerChunk;
+		uint8_t* chunk = static_cast<uint8_t*>(std::malloc(chunkSize));
+		if (!chunk)
+		{
+			throw std::runtime_error("failed to allocate pool chunk!");
+		}
+
+		TracyAllocN(chunk, chunkSize, m_Name);
+
+		*reinterpret_cast<void**>(chunk) = m_Chunks;
+		m_Chunks = chunk;
+
+		//Threaded back to front so blocks come out in address order
+		uint8_t* blocks = chunk + ChunkHeaderSize;
+		for (size_t i = m_BlocksPerChunk; i > 0; i--)
+		{
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + (i - 1) * m_BlockSize);
+			block->Next = m_FreeList;
+			m_FreeList = block;
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "EngineHeader.h"
+
+namespace CHIKU
+{
+	//Fixed size blocks carved out of chunks, freed blocks go on an intrusive free list.
+	//Allocate and Free are a couple of pointer swaps, chunks are only released on destruction.
+	//Not thread safe.
+	class PoolAllocator
+	{
+	public:
+		PoolAllocator(size_t blockSize, size_t blocksPerChunk = 256, const char* name = "Pool Allocator");
+		~PoolAllocator();
+
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+		void* Allocate();
+		void Free(void* block);
+
+		size_t GetBlockSize() const { return m_BlockSize; }
+
+	private:
+		void CreateChunk();
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* Next;
+		};
+
+		FreeBlock* m_FreeList = nullptr;
+		void* m_Chunks = nullptr; //Each chunk starts with the pointer to the previous one
+		size_t m_BlockSize;
+		size_t m_BlocksPerChunk;
+		const char* m_Name;
+	};
+}
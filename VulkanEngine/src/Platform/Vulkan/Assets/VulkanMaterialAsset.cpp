@@ -4,6 +4,7 @@
 #include "Vulkan/Utils/VulkanBufferUtils.h"
 #include "Vulkan/Renderer/VulkanRenderer.h"
 #include "Vulkan/Renderer/DescriptorPool.h"    
+#include "Vulkan/Renderer/MaterialTable.h"
 #include "Vulkan/Buffer/VulkanUniformBuffer.h"
 
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -16,12 +17,21 @@
 
 namespace CHIKU
 {
+    std::vector<VulkanMaterialAsset*> VulkanMaterialAsset::m_DirtyMaterials;
+    std::mutex VulkanMaterialAsset::m_DirtyMutex;
 
     void VulkanMaterialAsset::CreateMaterial()
     {
         ZoneScoped;
 
-        m_Material = LoadMaterialFromFile(m_SourcePath);
+        CreateMaterial(LoadMaterialFromFile(m_SourcePath));
+    }
+
+    void VulkanMaterialAsset::CreateMaterial(const Material& material)
+    {
+        ZoneScoped;
+
+        m_Material = material;
         auto shaderAssetHandle = AssetManager::GetShaderAssetHandle(m_Material.shader);
 
         if (shaderAssetHandle == Asset::InvalidHandle)
@@ -36,6 +46,8 @@ namespace CHIKU
             throw std::runtime_error("Shader asset not found: " + m_Material.shader);
         }
 
+        m_MaterialID = MaterialTable::Allocate();
+
         CreateUniformBuffer();
     }
 
@@ -47,34 +59,121 @@ namespace CHIKU
         m_UniformSetStorage = Utils::CreateDescriptorSetLayout(bufferDescription);
         Utils::CreateDescriptorSets(bufferDescription, m_UniformSetStorage);
 
-        if (m_UniformSetStorage.empty())
-            return;
+        ResolveParameterTargets();
+        BuildBindRecords();
+        QueueFlush();
+    }
 
-        for (int frameNumber = 0; frameNumber < MAX_FRAMES_IN_FLIGHT; frameNumber++)
+    void VulkanMaterialAsset::BuildBindRecords()
+    {
+        ZoneScoped;
+
+        const bool usesMaterialTable = !m_Shader->GetMaterialRecord().empty();
+        if (m_UniformSetStorage.size() + (usesMaterialTable ? 1 : 0) > MaxMaterialDescriptorSets)
         {
-            m_DescriptorSetsChache[frameNumber].resize(m_UniformSetStorage.size());
+            throw std::runtime_error("material uses more descriptor sets than a draw can bind!");
+        }
+
+        for (uint32_t frameNumber = 0; frameNumber < MAX_FRAMES_IN_FLIGHT; frameNumber++)
+        {
+            MaterialBindRecord& record = m_BindRecords[frameNumber];
+            record = {};
+
+            if (usesMaterialTable)
+                record.Sets[record.SetCount++] = MaterialTable::GetDescriptorSet(frameNumber);
 
-            int i = 0;
             for (const auto& [setIndex, storage] : m_UniformSetStorage)
-            {
-                m_DescriptorSetsChache[frameNumber][i] = storage.DescriptorSets[frameNumber];
-                i++;
-            }
+                record.Sets[record.SetCount++] = storage.DescriptorSets[frameNumber];
+
+            record.VertexPulling = m_Shader->UsesVertexPulling();
+            record.PushConstantRanges = &m_Shader->GetPushConstantRanges();
         }
+    }
+
+    void VulkanMaterialAsset::ResolveParameterTargets()
+    {
+        ZoneScoped;
+
+        m_ParameterTargets = {};
 
+        //Base color is the leading vec4 of the MaterialRecord and the alpha cutoff the float after it,
+        //shaders without them simply ignore the parameters
+        const auto& members = m_Shader->GetMaterialRecord();
+        if (!members.empty() && members[0].Type == UniformPlainDataType::Vec4)
+        {
+            m_ParameterTargets[Param_BaseColor] = { members[0].Offset, sizeof(glm::vec4), true };
+        }
+
+        if (members.size() > 1 && members[1].Type == UniformPlainDataType::Float)
+        {
+            m_ParameterTargets[Param_AlphaCutoff] = { members[1].Offset, sizeof(float), true };
+        }
     }
 
     void VulkanMaterialAsset::UpdateUniformBuffer(uint32_t currentFrame)
     {
         ZoneScoped;
 
-        if (m_UniformSetStorage.find(1) == m_UniformSetStorage.end())
+        MaterialParameterBits dirty = GetDirtyParameters(currentFrame);
+
+        for (uint32_t i = 0; i < Param_Count; i++)
         {
-            throw std::runtime_error("Uniform Set 1 not found, it should contain base color");
+            const ParameterTarget& target = m_ParameterTargets[i];
+            if (!dirty.test(i) || !target.Valid)
+                continue;
+
+            const void* source = nullptr;
+            switch (static_cast<MaterialParameter>(i))
+            {
+            case Param_BaseColor: source = &m_Material.config.baseColor; break;
+            case Param_AlphaCutoff: source = &m_Material.config.alphaCutoff; break;
+            default: break;
+            }
+
+            MaterialTable::Write(currentFrame, m_MaterialID, target.Offset, source, target.Size);
         }
 
-        auto& color = m_UniformSetStorage[1].BindingStorage[0].UniformBuffersMapped[currentFrame];
-        memcpy(color, &m_Material.config.baseColor, sizeof(glm::vec4));
+        m_UploadedGenerations[currentFrame] = m_Generation;
+    }
+
+    void VulkanMaterialAsset::MarkDirty(MaterialParameter parameter)
+    {
+        MaterialAsset::MarkDirty(parameter);
+        QueueFlush();
+    }
+
+    void VulkanMaterialAsset::QueueFlush()
+    {
+        std::lock_guard<std::mutex> lock(m_DirtyMutex);
+        if (m_FlushQueued)
+            return;
+
+        m_FlushQueued = true;
+        m_DirtyMaterials.push_back(this);
+    }
+
+    void VulkanMaterialAsset::FlushDirtyMaterials(uint32_t currentFrame)
+    {
+        ZoneScoped;
+
+        std::lock_guard<std::mutex> lock(m_DirtyMutex);
+
+        //A material leaves the list once every frame slot holds its latest generation
+        for (size_t i = 0; i < m_DirtyMaterials.size();)
+        {
+            VulkanMaterialAsset* material = m_DirtyMaterials[i];
+            material->UpdateUniformBuffer(currentFrame);
+
+            if (material->IsUploaded())
+            {
+                material->m_FlushQueued = false;
+                m_DirtyMaterials[i] = m_DirtyMaterials.back();
+                m_DirtyMaterials.pop_back();
+                continue;
+            }
+
+            i++;
+        }
     }
 
     void VulkanMaterialAsset::CleanUp()
@@ -83,10 +182,17 @@ namespace CHIKU
 
         Asset::CleanUp();
 
-        for (auto& [set, storage] : m_UniformSetStorage)
         {
-            vkDestroyDescriptorSetLayout(VulkanRenderer::GetVulkanDevice(), storage.DescriptorSetLayout, nullptr);
+            std::lock_guard<std::mutex> lock(m_DirtyMutex);
+            if (m_FlushQueued)
+            {
+                m_DirtyMaterials.erase(std::remove(m_DirtyMaterials.begin(), m_DirtyMaterials.end(), this), m_DirtyMaterials.end());
+                m_FlushQueued = false;
+            }
+        }
 
+        for (auto& [set, storage] : m_UniformSetStorage)
+        {
             for (auto& [bindingIndex, bindingStorage] : storage.BindingStorage)
             {
                 for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
@@ -104,6 +210,9 @@ namespace CHIKU
         }
 
         m_UniformSetStorage.clear();
+
+        MaterialTable::Free(m_MaterialID);
+        m_MaterialID = UINT32_MAX;
     }
 
     VulkanMaterialAsset::~VulkanMaterialAsset()
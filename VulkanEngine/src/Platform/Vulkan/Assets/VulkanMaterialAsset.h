@@ -1,8 +1,22 @@
 #pragma once
 #include "Assets/MaterialAsset.h"
+#include <mutex>
 
 namespace CHIKU
 {
+	//Sets a shader can own on top of the global set and the vertex pulling set
+	static constexpr uint32_t MaxMaterialDescriptorSets = MAX_BOUND_DESCRIPTOR_SETS - DEFAULT_DESCRIPTOR_SET_LAYOUT_BINDING_COUNT - 1;
+
+	//Everything a draw binds for a material in one frame slot, built when the material is created
+	//so binding only copies handles out of it
+	struct MaterialBindRecord
+	{
+		std::array<VkDescriptorSet, MaxMaterialDescriptorSets> Sets{}; //Material table first when the shader reads it
+		uint32_t SetCount = 0;
+		bool VertexPulling = false;
+		const PushConstantDescription* PushConstantRanges = nullptr;
+	};
+
 	class VulkanMaterialAsset : public MaterialAsset
 	{
 	public:
@@ -14,6 +28,7 @@ namespace CHIKU
 		}
 
 		virtual void CreateMaterial() override;
+		virtual void CreateMaterial(const Material& material) override;
 		virtual void CreateUniformBuffer() override;
 
 		virtual void CleanUp() override;
@@ -22,11 +37,35 @@ namespace CHIKU
 
 		virtual void UpdateUniformBuffer(uint32_t currentFrame) override;
 
-		std::vector<VkDescriptorSet> GetDescriptorSets(uint32_t frameCount) const { return m_DescriptorSetsChache[frameCount]; };
+		//Writes every material with changes pending for this frame slot, called once per frame before recording
+		static void FlushDirtyMaterials(uint32_t currentFrame);
+
+		const MaterialBindRecord& GetBindRecord(uint32_t currentFrame) const { return m_BindRecords[currentFrame]; }
 		std::vector<VkDescriptorSetLayout> GetDescriptorSetLayouts() const;
 
+	protected:
+		virtual void MarkDirty(MaterialParameter parameter) override;
+
 	private:
-		std::array< std::vector<VkDescriptorSet>, MAX_FRAMES_IN_FLIGHT> m_DescriptorSetsChache;
+		void QueueFlush();
+		void ResolveParameterTargets();
+		void BuildBindRecords();
+
+	private:
+		//Where a parameter lives inside the material's record
+		struct ParameterTarget
+		{
+			uint32_t Offset;
+			uint32_t Size;
+			bool Valid = false;
+		};
+
+		std::array<MaterialBindRecord, MAX_FRAMES_IN_FLIGHT> m_BindRecords;
+		std::array<ParameterTarget, Param_Count> m_ParameterTargets;
+		bool m_FlushQueued = false;
+
+		static std::vector<VulkanMaterialAsset*> m_DirtyMaterials;
+		static std::mutex m_DirtyMutex;
 	};
 
 }
\ No newline at end of file
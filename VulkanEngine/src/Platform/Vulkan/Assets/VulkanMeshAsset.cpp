@@ -1,21 +1,19 @@
 #include "VulkanMeshAsset.h"
-#include "Vulkan/Renderer/VulkanRenderer.h"
+#include "Vulkan/Renderer/CommandRecorder.h"
 
 namespace CHIKU
 {
 	void VulkanMeshAsset::Draw() const
 	{
 		ZoneScoped;
-		auto commandBuffer = VulkanRenderer::GetVulkanCommandBuffer();
-		m_VertexBuffer->Bind();
+		//Buffers are bound by MeshAsset::Bind, drawing only issues the draw
 		if (m_IndexBuffer->GetCount() > 0)
 		{
-			m_IndexBuffer->Bind();
-			vkCmdDrawIndexed(commandBuffer, m_IndexBuffer->GetCount(), 1, 0, 0, 0);
+			CommandRecorder::DrawIndexed(m_IndexBuffer->GetCount());
 		}
 		else
 		{
-			vkCmdDraw(commandBuffer, static_cast<uint32_t>(m_VertexBuffer->GetCount()), 1, 0, 0);
+			CommandRecorder::Draw(static_cast<uint32_t>(m_VertexBuffer->GetCount()));
 		}
 	}
 }
\ No newline at end of file
@@ -2,9 +2,11 @@
 #include "Vulkan/Renderer/VulkanRenderer.h"
 #include "Renderer/Buffer/UniformBuffer.h"
 #include "Vulkan/Utils/VulkanShaderUtils.h"
+#include "IO/FileSystem.h"
+#include "Assets/AssetCooker.h"
 
 #include <unordered_map>
-#include <fstream>
+#include <sstream>
 #include <nlohmann/json.hpp>
 #include <iostream>
 
@@ -32,59 +34,20 @@ namespace CHIKU
     void VulkanShaderAsset::CreateUniformBufferDescription(const std::vector<AssetPath>& shaderCodes)
     {
         ZoneScoped;
-        Utils::ProcessSPIRV(shaderCodes, m_UniformBufferDescription, m_InputAttributes);
-    }
+        Utils::ProcessSPIRV(shaderCodes, m_UniformBufferDescription, m_PushConstantRanges, m_MaterialRecord, m_InputAttributes, m_VertexPulling, m_SpecializationConstants);
 
-    std::vector<char> VulkanShaderAsset::ReadFile(const std::string& filePath) const
-    {
-        ZoneScoped;
-
-        std::string fullPath = SOURCE_DIR + filePath;
-        std::ifstream file(fullPath, std::ios::ate | std::ios::binary);
-
-        if (!file)
+        m_FeatureMask = 0;
+        for (const auto& constant : m_SpecializationConstants)
         {
-            throw std::runtime_error("Failed to open shader file: " + fullPath);
+            m_FeatureMask |= 1u << constant.Feature;
         }
-
-        size_t fileSize = static_cast<size_t>(file.tellg());
-        std::vector<char> buffer(fileSize);
-
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-        file.close();
-        return buffer;
     }
 
-    void VulkanShaderAsset::GetShaderNameAndStage(const AssetPath& path, ReadableHandle& shaderName, ShaderStages& shaderStage) const
+    std::vector<char> VulkanShaderAsset::ReadFile(const std::string& filePath) const
     {
         ZoneScoped;
 
-        shaderName = "Unknown";
-        std::string shaderType = "Unknown";
-
-        std::fstream file(SOURCE_DIR + path, std::ios::in | std::ios::out);
-        std::string line;
-        while (std::getline(file, line))
-        {
-            if (line.find("//Name:") != std::string::npos)
-            {
-                shaderName = line.substr(line.find(":") + 1);
-                shaderName.erase(0, shaderName.find_first_not_of(" \t")); // trim
-            }
-            else if (line.find("//Type:") != std::string::npos)
-            {
-                shaderType = line.substr(line.find(":") + 1);
-                shaderType.erase(0, shaderType.find_first_not_of(" \t"));
-            }
-        }
-
-        if (shaderType == SHADER_STAGE_VERTEX)              shaderStage = ShaderStages::Stage_Vertex;
-        else if (shaderType == SHADER_STAGE_TESSELATION)    shaderStage = ShaderStages::Stage_Tessellation;
-        else if (shaderType == SHADER_STAGE_GEOMETRY)       shaderStage = ShaderStages::Stage_Geometry;
-        else if (shaderType == SHADER_STAGE_FRAGMENT)       shaderStage = ShaderStages::Stage_Fragment;
-        else if (shaderType == SHADER_STAGE_COMPUTE)        shaderStage = ShaderStages::Stage_Compute;
-        else shaderStage = ShaderStages::Stage_None;
+        return FileSystem::ReadFile(filePath);
     }
 
     ShaderStageData VulkanShaderAsset::CreateShaderModule(const std::vector<char>& code) const
@@ -114,7 +77,8 @@ namespace CHIKU
         auto index = path.find_last_of(".");
         m_ShaderSPIRVs.push_back(path + ".spv");
         auto& spvPath = m_ShaderSPIRVs.back();
-        CreateSPIRV(path, spvPath);
+        //Cooked SPIR-V is used as is, only sources edited since the last cook are compiled here
+        AssetCooker::CookShader(path);
         auto code = ReadFile(spvPath);
 
         ShaderStages stage = ShaderStages::Stage_None;
@@ -157,21 +121,4 @@ namespace CHIKU
         }
         m_ShaderStage.clear();
     }
-
-    bool VulkanShaderAsset::CreateSPIRV(const std::string& a_ShaderPath, const std::string& a_OutPutPath) const
-    {
-        ZoneScoped;
-
-        std::string command = "glslc.exe " + (SOURCE_DIR + a_ShaderPath) + " -o " + (SOURCE_DIR + a_OutPutPath);
-        int result = std::system(command.c_str());
-
-        if (result != 0)
-        {
-            std::cerr << "Shader compilation failed with exit code: " << result << std::endl;
-            return false;
-        }
-
-        std::cout << "Compiled successfully: " << a_OutPutPath << std::endl;
-        return true;
-    }
 }
\ No newline at end of file
@@ -16,9 +16,7 @@ namespace CHIKU
 		virtual ~VulkanShaderAsset();
 
 	private:
-		void GetShaderNameAndStage(const AssetPath& data, ReadableHandle& name, ShaderStages& stage) const;
 		void CreateUniformBufferDescription(const std::vector<AssetPath>& shaderCodes);
-		bool CreateSPIRV(const std::string& a_ShaderPath, const std::string& a_OutPutPath) const;
 
 		ShaderStageData CreateShaderModule(const std::vector<char>& code) const;
 		std::vector<char> ReadFile(const std::string& filename) const;
@@ -6,12 +6,13 @@ namespace CHIKU
 	class VulkanIndexBuffer : public IndexBuffer
 	{
 	public:
-		virtual void CreateIndexBuffer(const std::vector<uint32_t>& indices);
+		virtual void CreateIndexBuffer(std::span<const uint32_t> indices);
 		virtual void Bind() const;
 		virtual void CleanUp();
+		virtual uint64_t GetSize() const override { return m_IndexBuffer != VK_NULL_HANDLE ? uint64_t(count) * sizeof(uint32_t) : 0; }
 
 	private:
-		VkBuffer m_IndexBuffer;
-		VkDeviceMemory m_IndexBufferMemory;
+		VkBuffer m_IndexBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory m_IndexBufferMemory = VK_NULL_HANDLE;
 	};
 }
\ No newline at end of file
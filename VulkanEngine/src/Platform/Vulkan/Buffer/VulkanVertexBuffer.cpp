@@ -1,84 +1,128 @@
 #include "VulkanVertexBuffer.h"
 #include "Vulkan/Renderer/VulkanRenderer.h"
 #include "Vulkan/Utils/VulkanBufferUtils.h"
+#include "Renderer/Buffer/VertexLayoutRegistry.h"
+#include "Vulkan/Renderer/VertexPulling.h"
+#include "Vulkan/Renderer/CommandRecorder.h"
+#include "Memory/AllocationTracker.h"
 
 namespace CHIKU
 {
-    void VulkanVertexBuffer::CreateVertexBuffer(const std::vector<uint8_t>& vertices)
+    std::deque<VulkanVertexInputDescription> VulkanVertexBuffer::s_InputDescriptions;
+    std::mutex VulkanVertexBuffer::s_InputDescriptionMutex;
+
+    void VulkanVertexBuffer::CreateVertexBuffer(std::span<const uint8_t> vertices)
     {
         ZoneScoped;
 
         VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingBufferMemory;
-        Utils::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            stagingBuffer, stagingBufferMemory);
-
-        void* data;
-        vkMapMemory(VulkanRenderer::GetVulkanDevice(), stagingBufferMemory, 0, bufferSize, 0, &data);
-        memcpy(data, vertices.data(), (size_t)bufferSize);
-        vkUnmapMemory(VulkanRenderer::GetVulkanDevice(), stagingBufferMemory);
+        m_Size = bufferSize;
 
         Utils::CreateBuffer(bufferSize,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             m_VertexBuffer, m_VertexBufferMemory);
 
-        Utils::CopyBuffer(stagingBuffer, m_VertexBuffer, bufferSize);
-
-        vkDestroyBuffer(VulkanRenderer::GetVulkanDevice(), stagingBuffer, nullptr);
-        vkFreeMemory(VulkanRenderer::GetVulkanDevice(), stagingBufferMemory, nullptr);
+        Utils::UploadBuffer(m_VertexBuffer, vertices.data(), bufferSize);
     }
 
     void VulkanVertexBuffer::Bind() const
     {
         ZoneScoped;
 
-        VkBuffer vertexBuffers[] = { m_VertexBuffer };
-        VkDeviceSize offsets[] = { 0 };
-        vkCmdBindVertexBuffers(VulkanRenderer::GetVulkanCommandBuffer(), 0, 1, vertexBuffers, offsets);
+        CommandRecorder::BindVertexBuffer(0, m_VertexBuffer);
     }
 
     void VulkanVertexBuffer::CleanUp()
     {
         ZoneScoped;
 
+        //Can run twice when the ResidencyManager evicted the buffer before shutdown
         vkDestroyBuffer(VulkanRenderer::GetVulkanDevice(), m_VertexBuffer, nullptr);
         vkFreeMemory(VulkanRenderer::GetVulkanDevice(), m_VertexBufferMemory, nullptr);
+        m_VertexBuffer = VK_NULL_HANDLE;
+        m_VertexBufferMemory = VK_NULL_HANDLE;
+
+        //The set points at the destroyed buffer, hand it back so evictions don't drain the pool
+        VertexPulling::FreeDescriptorSet(m_VertexPullingPool, m_VertexPullingSet);
+        m_VertexPullingSet = VK_NULL_HANDLE;
+        m_VertexPullingPool = VK_NULL_HANDLE;
     }
 
-    void VulkanVertexBuffer::PrepareBindingDescription()
+    const VulkanVertexInputDescription& VulkanVertexBuffer::GetInputDescription(VertexLayoutID layoutID)
     {
-        ZoneScoped;
+        std::lock_guard<std::mutex> lock(s_InputDescriptionMutex);
+        return s_InputDescriptions[layoutID];
+    }
+
+    VkPipelineVertexInputStateCreateInfo VulkanVertexBuffer::GetVertexInputState(VertexLayoutID layoutID)
+    {
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+        if (layoutID == InvalidVertexLayoutID)
+        {
+            return vertexInputInfo;
+        }
+
+        const auto& inputDescription = GetInputDescription(layoutID);
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(inputDescription.AttributeDescriptions.size());
+        vertexInputInfo.pVertexBindingDescriptions = &inputDescription.BindingDescription;
+        vertexInputInfo.pVertexAttributeDescriptions = inputDescription.AttributeDescriptions.data();
+        return vertexInputInfo;
+    }
+
+    VkDescriptorSet VulkanVertexBuffer::GetVertexPullingSet()
+    {
+        if (m_VertexPullingSet == VK_NULL_HANDLE)
+        {
+            //Created by the first draw that pulls from this buffer
+            AllocationTracker::AllowScope allow;
+            m_VertexPullingSet = VertexPulling::CreateDescriptorSet(m_MetaData.LayoutID, m_VertexBuffer, m_Size, m_VertexPullingPool);
+        }
 
-        m_BindingDescription = {};
-        m_BindingDescription.binding = m_Binding;
-        m_BindingDescription.stride = m_MetaData.Layout.Stride;
-        m_BindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return m_VertexPullingSet;
     }
 
-    void VulkanVertexBuffer::PrepareAttributeDescriptions()
+    void VulkanVertexBuffer::PrepareInputDescription(VertexLayoutID layoutID)
     {
         ZoneScoped;
 
-        const auto& layout = m_MetaData.Layout;
+        std::lock_guard<std::mutex> lock(s_InputDescriptionMutex);
 
-        m_AttributeDescription.clear();
-        m_AttributeDescription.resize(layout.VertexElements.size());
+        if (layoutID < s_InputDescriptions.size())
+        {
+            return;
+        }
 
-        for (int i = 0; i < m_AttributeDescription.size(); i++)
+        //Layout IDs are dense, fill every description up to the requested one
+        for (VertexLayoutID id = static_cast<VertexLayoutID>(s_InputDescriptions.size()); id <= layoutID; id++)
         {
-            const auto& componentType = layout.VertexElements[i].ComponentType;
-            const auto& attributeType = layout.VertexElements[i].AttributeType;
-            const auto& offset = layout.VertexElements[i].Offset;
-
-            m_AttributeDescription[i].binding = 0; //Because we have interleaved vertex data, we use binding 0
-            //Binding 0 is used when we use one vertex buffer with interleaved data
-            m_AttributeDescription[i].location = i;
-            m_AttributeDescription[i].format = Utils::GetVkFormat(componentType, attributeType);
-            m_AttributeDescription[i].offset = offset;
+            const auto& layout = VertexLayoutRegistry::GetLayout(id);
+            VulkanVertexInputDescription description{};
+
+            description.BindingDescription.binding = 0;
+            description.BindingDescription.stride = layout.Stride;
+            description.BindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+            description.AttributeDescriptions.resize(layout.VertexElements.size());
+
+            for (int i = 0; i < description.AttributeDescriptions.size(); i++)
+            {
+                const auto& componentType = layout.VertexElements[i].ComponentType;
+                const auto& attributeType = layout.VertexElements[i].AttributeType;
+                const auto& offset = layout.VertexElements[i].Offset;
+
+                description.AttributeDescriptions[i].binding = 0; //Because we have interleaved vertex data, we use binding 0
+                //Binding 0 is used when we use one vertex buffer with interleaved data
+                description.AttributeDescriptions[i].location = i;
+                description.AttributeDescriptions[i].format = Utils::GetVkFormat(componentType, attributeType);
+                description.AttributeDescriptions[i].offset = offset;
+            }
+
+            s_InputDescriptions.push_back(std::move(description));
+            VertexPulling::RegisterLayout(id, layout);
         }
     }
 }
\ No newline at end of file
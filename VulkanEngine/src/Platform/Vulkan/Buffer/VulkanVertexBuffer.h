@@ -1,38 +1,55 @@
 #pragma once
 #include "Renderer/Buffer/VertexBuffer.h"
 #include "EngineHeader.h"
+#include <deque>
+#include <mutex>
 
 namespace CHIKU
 {
+    struct VulkanVertexInputDescription
+    {
+        VkVertexInputBindingDescription BindingDescription;
+        std::vector<VkVertexInputAttributeDescription> AttributeDescriptions;
+    };
+
     class VulkanVertexBuffer : public VertexBuffer
     {
     public:
-        void CreateVertexBuffer(const std::vector<uint8_t>& vertices);
+        void CreateVertexBuffer(std::span<const uint8_t> vertices);
         void Bind() const;
         void CleanUp();
+        uint64_t GetSize() const override { return m_VertexBuffer != VK_NULL_HANDLE ? m_Size : 0; }
 
         void SetBinding(uint32_t binding) { m_Binding = binding; }
 		virtual void SetMetaData(const VertexBufferMetaData& metaData) override
         {
             VertexBuffer::SetMetaData(metaData);
 
-            PrepareBindingDescription();
-            PrepareAttributeDescriptions();
+            PrepareInputDescription(metaData.LayoutID);
         }
 
-        inline VkVertexInputBindingDescription GetBindingDescription() const { return m_BindingDescription; }
-        inline std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions() const { return m_AttributeDescription; }
+        //Input descriptions are built once per interned layout and shared by every buffer using it.
+        //Locked like the layout registry, loads prepare new descriptions from worker threads
+        static const VulkanVertexInputDescription& GetInputDescription(VertexLayoutID layoutID);
+        //InvalidVertexLayoutID gives an empty state for vertex pulling pipelines
+        static VkPipelineVertexInputStateCreateInfo GetVertexInputState(VertexLayoutID layoutID);
 
         inline VkDeviceMemory GetBufferMemory() const { return m_VertexBufferMemory; }
 
+        //Set bound at VERTEX_PULLING_DESCRIPTOR_SET when the shader pulls its vertices, created on first use
+        VkDescriptorSet GetVertexPullingSet();
+
     private:
-        void PrepareBindingDescription();
-        void PrepareAttributeDescriptions();
+        static void PrepareInputDescription(VertexLayoutID layoutID);
 
     private:
-        VkBuffer m_VertexBuffer;
-        VkDeviceMemory m_VertexBufferMemory;
-        VkVertexInputBindingDescription m_BindingDescription;
-        std::vector<VkVertexInputAttributeDescription> m_AttributeDescription;
+        VkBuffer m_VertexBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_VertexBufferMemory = VK_NULL_HANDLE;
+        VkDeviceSize m_Size = 0;
+        VkDescriptorSet m_VertexPullingSet = VK_NULL_HANDLE;
+        VkDescriptorPool m_VertexPullingPool = VK_NULL_HANDLE;
+
+        static std::deque<VulkanVertexInputDescription> s_InputDescriptions; //index is the VertexLayoutID
+        static std::mutex s_InputDescriptionMutex;
     };
-}
\ No newline at end of file
+}
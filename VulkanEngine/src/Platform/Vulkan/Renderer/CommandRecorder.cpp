@@ -0,0 +1,156 @@
+#include "CommandRecorder.h"
+#include "DynamicState.h"
+
+namespace CHIKU
+{
+	VkCommandBuffer CommandRecorder::m_CommandBuffer = VK_NULL_HANDLE;
+	CommandRecorderStats CommandRecorder::m_Stats;
+
+	VkPipeline CommandRecorder::m_Pipeline = VK_NULL_HANDLE;
+	std::array<CommandRecorder::BoundDescriptorSet, MAX_BOUND_DESCRIPTOR_SETS> CommandRecorder::m_DescriptorSets{};
+	std::array<CommandRecorder::BoundVertexBuffer, CommandRecorder::MaxTrackedVertexBindings> CommandRecorder::m_VertexBuffers{};
+	CommandRecorder::BoundIndexBuffer CommandRecorder::m_IndexBuffer;
+	RenderState CommandRecorder::m_RenderState;
+	bool CommandRecorder::m_RenderStateValid = false;
+
+	void CommandRecorder::Begin(VkCommandBuffer commandBuffer)
+	{
+		m_CommandBuffer = commandBuffer;
+		m_Stats = {};
+
+		m_Pipeline = VK_NULL_HANDLE;
+		m_DescriptorSets.fill({});
+		m_VertexBuffers.fill({});
+		m_IndexBuffer = {};
+		m_RenderStateValid = false;
+	}
+
+	void CommandRecorder::End()
+	{
+		TracyPlot("Pipeline Binds", static_cast<int64_t>(m_Stats.PipelineBinds));
+		TracyPlot("Pipeline Binds Skipped", static_cast<int64_t>(m_Stats.PipelineBindsSkipped));
+		TracyPlot("Descriptor Set Binds", static_cast<int64_t>(m_Stats.DescriptorSetBinds));
+		TracyPlot("Descriptor Set Binds Skipped", static_cast<int64_t>(m_Stats.DescriptorSetBindsSkipped));
+		TracyPlot("Buffer Binds", static_cast<int64_t>(m_Stats.VertexBufferBinds + m_Stats.IndexBufferBinds));
+		TracyPlot("Buffer Binds Skipped", static_cast<int64_t>(m_Stats.VertexBufferBindsSkipped + m_Stats.IndexBufferBindsSkipped));
+		TracyPlot("Dynamic State Sets", static_cast<int64_t>(m_Stats.DynamicStateSets));
+		TracyPlot("Dynamic State Sets Skipped", static_cast<int64_t>(m_Stats.DynamicStateSetsSkipped));
+
+		m_CommandBuffer = VK_NULL_HANDLE;
+	}
+
+	void CommandRecorder::BindPipeline(VkPipeline pipeline)
+	{
+		if (m_Pipeline == pipeline)
+		{
+			m_Stats.PipelineBindsSkipped++;
+			return;
+		}
+
+		vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		m_Pipeline = pipeline;
+		m_Stats.PipelineBinds++;
+	}
+
+	void CommandRecorder::BindDescriptorSets(VkPipelineLayout layout, uint32_t firstSet, uint32_t setCount, const VkDescriptorSet* sets)
+	{
+		if (firstSet + setCount > MAX_BOUND_DESCRIPTOR_SETS)
+		{
+			throw std::runtime_error("descriptor set index exceeds the tracked sets!");
+		}
+
+		//Only the span between the first and the last set that differs is rebound,
+		//sets on both ends are already bound through the same layout
+		uint32_t first = setCount;
+		uint32_t last = 0;
+		for (uint32_t i = 0; i < setCount; i++)
+		{
+			const BoundDescriptorSet& bound = m_DescriptorSets[firstSet + i];
+			if (bound.Set != sets[i] || bound.Layout != layout)
+			{
+				first = std::min(first, i);
+				last = i;
+			}
+		}
+
+		if (first == setCount)
+		{
+			m_Stats.DescriptorSetBindsSkipped += setCount;
+			return;
+		}
+
+		const uint32_t boundCount = last - first + 1;
+		vkCmdBindDescriptorSets(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, firstSet + first, boundCount, sets + first, 0, nullptr);
+
+		m_Stats.DescriptorSetBinds += boundCount;
+		m_Stats.DescriptorSetBindsSkipped += setCount - boundCount;
+
+		for (uint32_t i = 0; i < setCount; i++)
+		{
+			m_DescriptorSets[firstSet + i] = { sets[i], layout };
+		}
+
+		//Binding through another layout may disturb every higher set, those are not trusted anymore
+		for (uint32_t i = firstSet + setCount; i < MAX_BOUND_DESCRIPTOR_SETS; i++)
+		{
+			if (m_DescriptorSets[i].Layout != layout)
+				m_DescriptorSets[i] = {};
+		}
+	}
+
+	void CommandRecorder::BindVertexBuffer(uint32_t binding, VkBuffer buffer, VkDeviceSize offset)
+	{
+		BoundVertexBuffer& bound = m_VertexBuffers[binding];
+		if (bound.Buffer == buffer && bound.Offset == offset)
+		{
+			m_Stats.VertexBufferBindsSkipped++;
+			return;
+		}
+
+		vkCmdBindVertexBuffers(m_CommandBuffer, binding, 1, &buffer, &offset);
+		bound = { buffer, offset };
+		m_Stats.VertexBufferBinds++;
+	}
+
+	void CommandRecorder::BindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType)
+	{
+		if (m_IndexBuffer.Buffer == buffer && m_IndexBuffer.Offset == offset && m_IndexBuffer.IndexType == indexType)
+		{
+			m_Stats.IndexBufferBindsSkipped++;
+			return;
+		}
+
+		vkCmdBindIndexBuffer(m_CommandBuffer, buffer, offset, indexType);
+		m_IndexBuffer = { buffer, offset, indexType };
+		m_Stats.IndexBufferBinds++;
+	}
+
+	void CommandRecorder::SetRenderState(const RenderState& renderState)
+	{
+		DynamicStateCalls calls = DynamicState::Apply(m_CommandBuffer, renderState, m_RenderStateValid ? &m_RenderState : nullptr);
+
+		m_Stats.DynamicStateSets += calls.Issued;
+		m_Stats.DynamicStateSetsSkipped += calls.Skipped;
+
+		m_RenderState = renderState;
+		m_RenderStateValid = true;
+	}
+
+	void CommandRecorder::PushConstants(VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size, const void* data)
+	{
+		vkCmdPushConstants(m_CommandBuffer, layout, stages, offset, size, data);
+		m_Stats.PushConstants++;
+	}
+
+	void CommandRecorder::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+	{
+		vkCmdDraw(m_CommandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+		m_Stats.Draws++;
+	}
+
+	void CommandRecorder::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+	{
+		vkCmdDrawIndexed(m_CommandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+		m_Stats.Draws++;
+	}
+}
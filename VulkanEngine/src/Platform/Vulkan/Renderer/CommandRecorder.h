@@ -0,0 +1,80 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Renderer/RenderState.h"
+
+namespace CHIKU
+{
+	//Issued versus dropped calls of the command buffer recorded last
+	struct CommandRecorderStats
+	{
+		uint32_t PipelineBinds = 0;
+		uint32_t PipelineBindsSkipped = 0;
+		uint32_t DescriptorSetBinds = 0;		//Counted per set, not per call
+		uint32_t DescriptorSetBindsSkipped = 0;
+		uint32_t VertexBufferBinds = 0;
+		uint32_t VertexBufferBindsSkipped = 0;
+		uint32_t IndexBufferBinds = 0;
+		uint32_t IndexBufferBindsSkipped = 0;
+		uint32_t DynamicStateSets = 0;
+		uint32_t DynamicStateSetsSkipped = 0;
+		uint32_t PushConstants = 0;
+		uint32_t Draws = 0;
+	};
+
+	//Wraps the command buffer of the current frame and remembers what is bound on it,
+	//so binding state that is already set never reaches the driver.
+	//Everything that records draw state goes through here instead of calling vkCmd* directly.
+	class CommandRecorder
+	{
+	public:
+		//Forgets all tracked state, a freshly begun command buffer has nothing bound
+		static void Begin(VkCommandBuffer commandBuffer);
+		static void End();
+
+		static VkCommandBuffer GetCommandBuffer() { return m_CommandBuffer; }
+		static const CommandRecorderStats& GetStats() { return m_Stats; }
+
+		static void BindPipeline(VkPipeline pipeline);
+		static void BindDescriptorSets(VkPipelineLayout layout, uint32_t firstSet, uint32_t setCount, const VkDescriptorSet* sets);
+		static void BindVertexBuffer(uint32_t binding, VkBuffer buffer, VkDeviceSize offset = 0);
+		static void BindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType);
+		static void SetRenderState(const RenderState& renderState);
+
+		static void PushConstants(VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size, const void* data);
+		static void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0);
+		static void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t firstInstance = 0);
+
+	private:
+		static constexpr uint32_t MaxTrackedVertexBindings = 4;
+
+		struct BoundDescriptorSet
+		{
+			VkDescriptorSet Set = VK_NULL_HANDLE;
+			VkPipelineLayout Layout = VK_NULL_HANDLE;
+		};
+
+		struct BoundVertexBuffer
+		{
+			VkBuffer Buffer = VK_NULL_HANDLE;
+			VkDeviceSize Offset = 0;
+		};
+
+		struct BoundIndexBuffer
+		{
+			VkBuffer Buffer = VK_NULL_HANDLE;
+			VkDeviceSize Offset = 0;
+			VkIndexType IndexType = VK_INDEX_TYPE_UINT32;
+		};
+
+	private:
+		static VkCommandBuffer m_CommandBuffer;
+		static CommandRecorderStats m_Stats;
+
+		static VkPipeline m_Pipeline;
+		static std::array<BoundDescriptorSet, MAX_BOUND_DESCRIPTOR_SETS> m_DescriptorSets;
+		static std::array<BoundVertexBuffer, MaxTrackedVertexBindings> m_VertexBuffers;
+		static BoundIndexBuffer m_IndexBuffer;
+		static RenderState m_RenderState;
+		static bool m_RenderStateValid;
+	};
+}
@@ -0,0 +1,276 @@
+#include "DynamicState.h"
+#include "Vulkan/Utils/VulkanPipelineUtils.h"
+#include "Vulkan/Utils/VulkanRendererUtility.h"
+
+namespace CHIKU
+{
+	DynamicStateSupport DynamicState::m_Support;
+
+	VkPhysicalDeviceExtendedDynamicStateFeaturesEXT DynamicState::m_DynamicStateFeatures{};
+	VkPhysicalDeviceExtendedDynamicState2FeaturesEXT DynamicState::m_DynamicState2Features{};
+	VkPhysicalDeviceExtendedDynamicState3FeaturesEXT DynamicState::m_DynamicState3Features{};
+
+	PFN_vkCmdSetCullModeEXT DynamicState::m_CmdSetCullMode = nullptr;
+	PFN_vkCmdSetFrontFaceEXT DynamicState::m_CmdSetFrontFace = nullptr;
+	PFN_vkCmdSetPrimitiveTopologyEXT DynamicState::m_CmdSetPrimitiveTopology = nullptr;
+	PFN_vkCmdSetDepthTestEnableEXT DynamicState::m_CmdSetDepthTestEnable = nullptr;
+	PFN_vkCmdSetDepthWriteEnableEXT DynamicState::m_CmdSetDepthWriteEnable = nullptr;
+	PFN_vkCmdSetPrimitiveRestartEnableEXT DynamicState::m_CmdSetPrimitiveRestartEnable = nullptr;
+	PFN_vkCmdSetDepthBiasEnableEXT DynamicState::m_CmdSetDepthBiasEnable = nullptr;
+	PFN_vkCmdSetPolygonModeEXT DynamicState::m_CmdSetPolygonMode = nullptr;
+	PFN_vkCmdSetColorBlendEnableEXT DynamicState::m_CmdSetColorBlendEnable = nullptr;
+
+	//Topology classes as defined by the spec, without the unrestricted property
+	//only topologies of the same class as the baked one may be set dynamically
+	static PrimitiveTopology GetTopologyClass(PrimitiveTopology topology)
+	{
+		switch (topology)
+		{
+		case PrimitiveTopology::PointList:		return PrimitiveTopology::PointList;
+		case PrimitiveTopology::LineList:
+		case PrimitiveTopology::LineStrip:		return PrimitiveTopology::LineList;
+		default:								return PrimitiveTopology::TriangleList;
+		}
+	}
+
+	void* DynamicState::QuerySupport(VkPhysicalDevice physicalDevice, const std::vector<VkExtensionProperties>& availableExtensions, std::vector<const char*>& deviceExtensions, void* pNext)
+	{
+		ZoneScoped;
+
+		m_Support = {};
+
+		const bool hasDynamicState = Utils::IsExtensionAvailable(availableExtensions, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+		const bool hasDynamicState2 = Utils::IsExtensionAvailable(availableExtensions, VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+		const bool hasDynamicState3 = Utils::IsExtensionAvailable(availableExtensions, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+
+		if (!hasDynamicState)
+		{
+			LOG_WARN("VK_EXT_extended_dynamic_state not supported, render state is baked into pipelines");
+			return pNext;
+		}
+
+		m_DynamicStateFeatures = {};
+		m_DynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+		m_DynamicState2Features = {};
+		m_DynamicState2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT;
+		m_DynamicState3Features = {};
+		m_DynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+
+		VkPhysicalDeviceExtendedDynamicState3PropertiesEXT dynamicState3Properties{};
+		dynamicState3Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_PROPERTIES_EXT;
+
+		void* featureChain = &m_DynamicStateFeatures;
+		if (hasDynamicState2)
+		{
+			m_DynamicState2Features.pNext = featureChain;
+			featureChain = &m_DynamicState2Features;
+		}
+		if (hasDynamicState3)
+		{
+			m_DynamicState3Features.pNext = featureChain;
+			featureChain = &m_DynamicState3Features;
+		}
+
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = featureChain;
+		vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+		if (hasDynamicState3)
+		{
+			VkPhysicalDeviceProperties2 properties2{};
+			properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			properties2.pNext = &dynamicState3Properties;
+			vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+		}
+
+		m_Support.ExtendedDynamicState = m_DynamicStateFeatures.extendedDynamicState == VK_TRUE;
+		m_Support.ExtendedDynamicState2 = hasDynamicState2 && m_DynamicState2Features.extendedDynamicState2 == VK_TRUE;
+		m_Support.PolygonMode = hasDynamicState3 && m_DynamicState3Features.extendedDynamicState3PolygonMode == VK_TRUE;
+		m_Support.ColorBlendEnable = hasDynamicState3 && m_DynamicState3Features.extendedDynamicState3ColorBlendEnable == VK_TRUE;
+		m_Support.UnrestrictedTopology = hasDynamicState3 && dynamicState3Properties.dynamicPrimitiveTopologyUnrestricted == VK_TRUE;
+
+		if (!m_Support.ExtendedDynamicState)
+		{
+			m_Support = {};
+			return pNext;
+		}
+
+		//Rebuild the chain with only what gets used, the EDS3 struct exposes a lot
+		//of features we never set and enabling them costs validation/driver work
+		m_DynamicStateFeatures.pNext = pNext;
+		featureChain = &m_DynamicStateFeatures;
+		deviceExtensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+
+		if (m_Support.ExtendedDynamicState2)
+		{
+			m_DynamicState2Features.extendedDynamicState2LogicOp = VK_FALSE;
+			m_DynamicState2Features.extendedDynamicState2PatchControlPoints = VK_FALSE;
+			m_DynamicState2Features.pNext = featureChain;
+			featureChain = &m_DynamicState2Features;
+			deviceExtensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+		}
+
+		if (m_Support.PolygonMode || m_Support.ColorBlendEnable)
+		{
+			const VkBool32 polygonMode = m_DynamicState3Features.extendedDynamicState3PolygonMode;
+			const VkBool32 colorBlendEnable = m_DynamicState3Features.extendedDynamicState3ColorBlendEnable;
+
+			m_DynamicState3Features = {};
+			m_DynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+			m_DynamicState3Features.extendedDynamicState3PolygonMode = polygonMode;
+			m_DynamicState3Features.extendedDynamicState3ColorBlendEnable = colorBlendEnable;
+			m_DynamicState3Features.pNext = featureChain;
+			featureChain = &m_DynamicState3Features;
+			deviceExtensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+		}
+		else
+		{
+			m_Support.UnrestrictedTopology = false;
+		}
+
+		LOG_INFO("Extended dynamic state: EDS1 {} EDS2 {} polygon mode {} blend enable {} unrestricted topology {}",
+			m_Support.ExtendedDynamicState, m_Support.ExtendedDynamicState2, m_Support.PolygonMode, m_Support.ColorBlendEnable, m_Support.UnrestrictedTopology);
+
+		return featureChain;
+	}
+
+	void DynamicState::LoadFunctions(VkDevice device)
+	{
+		ZoneScoped;
+
+		if (m_Support.ExtendedDynamicState)
+		{
+			m_CmdSetCullMode = (PFN_vkCmdSetCullModeEXT)vkGetDeviceProcAddr(device, "vkCmdSetCullModeEXT");
+			m_CmdSetFrontFace = (PFN_vkCmdSetFrontFaceEXT)vkGetDeviceProcAddr(device, "vkCmdSetFrontFaceEXT");
+			m_CmdSetPrimitiveTopology = (PFN_vkCmdSetPrimitiveTopologyEXT)vkGetDeviceProcAddr(device, "vkCmdSetPrimitiveTopologyEXT");
+			m_CmdSetDepthTestEnable = (PFN_vkCmdSetDepthTestEnableEXT)vkGetDeviceProcAddr(device, "vkCmdSetDepthTestEnableEXT");
+			m_CmdSetDepthWriteEnable = (PFN_vkCmdSetDepthWriteEnableEXT)vkGetDeviceProcAddr(device, "vkCmdSetDepthWriteEnableEXT");
+
+			if (!m_CmdSetCullMode || !m_CmdSetFrontFace || !m_CmdSetPrimitiveTopology || !m_CmdSetDepthTestEnable || !m_CmdSetDepthWriteEnable)
+			{
+				LOG_WARN("Failed to load VK_EXT_extended_dynamic_state functions, falling back to static pipeline state");
+				m_Support = {};
+				return;
+			}
+		}
+
+		if (m_Support.ExtendedDynamicState2)
+		{
+			m_CmdSetPrimitiveRestartEnable = (PFN_vkCmdSetPrimitiveRestartEnableEXT)vkGetDeviceProcAddr(device, "vkCmdSetPrimitiveRestartEnableEXT");
+			m_CmdSetDepthBiasEnable = (PFN_vkCmdSetDepthBiasEnableEXT)vkGetDeviceProcAddr(device, "vkCmdSetDepthBiasEnableEXT");
+			m_Support.ExtendedDynamicState2 = m_CmdSetPrimitiveRestartEnable && m_CmdSetDepthBiasEnable;
+		}
+
+		if (m_Support.PolygonMode)
+		{
+			m_CmdSetPolygonMode = (PFN_vkCmdSetPolygonModeEXT)vkGetDeviceProcAddr(device, "vkCmdSetPolygonModeEXT");
+			m_Support.PolygonMode = m_CmdSetPolygonMode != nullptr;
+		}
+
+		if (m_Support.ColorBlendEnable)
+		{
+			m_CmdSetColorBlendEnable = (PFN_vkCmdSetColorBlendEnableEXT)vkGetDeviceProcAddr(device, "vkCmdSetColorBlendEnableEXT");
+			m_Support.ColorBlendEnable = m_CmdSetColorBlendEnable != nullptr;
+		}
+	}
+
+	void DynamicState::GetPipelineDynamicStates(std::vector<VkDynamicState>& dynamicStates)
+	{
+		if (m_Support.ExtendedDynamicState)
+		{
+			dynamicStates.push_back(VK_DYNAMIC_STATE_CULL_MODE_EXT);
+			dynamicStates.push_back(VK_DYNAMIC_STATE_FRONT_FACE_EXT);
+			dynamicStates.push_back(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT);
+			dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT);
+			dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT);
+		}
+
+		if (m_Support.ExtendedDynamicState2)
+		{
+			dynamicStates.push_back(VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT);
+			dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT);
+		}
+
+		if (m_Support.PolygonMode)
+			dynamicStates.push_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+
+		if (m_Support.ColorBlendEnable)
+			dynamicStates.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+	}
+
+	RenderState DynamicState::GetPipelineRenderState(const RenderState& renderState)
+	{
+		RenderState pipelineState = renderState;
+		const RenderState defaults{};
+
+		if (m_Support.ExtendedDynamicState)
+		{
+			pipelineState.Cull = defaults.Cull;
+			pipelineState.Front = defaults.Front;
+			pipelineState.DepthTest = defaults.DepthTest;
+			pipelineState.DepthWrite = defaults.DepthWrite;
+			pipelineState.Topology = m_Support.UnrestrictedTopology ? defaults.Topology : GetTopologyClass(renderState.Topology);
+		}
+
+		if (m_Support.PolygonMode)
+			pipelineState.Polygon = defaults.Polygon;
+
+		if (m_Support.ColorBlendEnable)
+			pipelineState.BlendEnabled = defaults.BlendEnabled;
+
+		return pipelineState;
+	}
+
+	DynamicStateCalls DynamicState::Apply(VkCommandBuffer commandBuffer, const RenderState& renderState, const RenderState* previous)
+	{
+		ZoneScoped;
+
+		DynamicStateCalls calls;
+		auto changed = [&](bool differs) -> bool
+			{
+				if (!previous || differs)
+				{
+					calls.Issued++;
+					return true;
+				}
+
+				calls.Skipped++;
+				return false;
+			};
+
+		if (m_Support.ExtendedDynamicState)
+		{
+			if (changed(previous && previous->Cull != renderState.Cull))
+				m_CmdSetCullMode(commandBuffer, Utils::GetVkCullMode(renderState.Cull));
+			if (changed(previous && previous->Front != renderState.Front))
+				m_CmdSetFrontFace(commandBuffer, Utils::GetVkFrontFace(renderState.Front));
+			if (changed(previous && previous->Topology != renderState.Topology))
+				m_CmdSetPrimitiveTopology(commandBuffer, Utils::GetVkPrimitiveTopology(renderState.Topology));
+			if (changed(previous && previous->DepthTest != renderState.DepthTest))
+				m_CmdSetDepthTestEnable(commandBuffer, renderState.DepthTest ? VK_TRUE : VK_FALSE);
+			if (changed(previous && previous->DepthWrite != renderState.DepthWrite))
+				m_CmdSetDepthWriteEnable(commandBuffer, renderState.DepthWrite ? VK_TRUE : VK_FALSE);
+		}
+
+		//Never changes, so only the first apply on a command buffer records it
+		if (m_Support.ExtendedDynamicState2)
+		{
+			if (changed(false))
+				m_CmdSetPrimitiveRestartEnable(commandBuffer, VK_FALSE);
+			if (changed(false))
+				m_CmdSetDepthBiasEnable(commandBuffer, VK_FALSE);
+		}
+
+		if (m_Support.PolygonMode && changed(previous && previous->Polygon != renderState.Polygon))
+			m_CmdSetPolygonMode(commandBuffer, Utils::GetVkPolygonMode(renderState.Polygon));
+
+		if (m_Support.ColorBlendEnable && changed(previous && previous->BlendEnabled != renderState.BlendEnabled))
+		{
+			VkBool32 blendEnable = renderState.BlendEnabled ? VK_TRUE : VK_FALSE;
+			m_CmdSetColorBlendEnable(commandBuffer, 0, 1, &blendEnable);
+		}
+
+		return calls;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Renderer/RenderState.h"
+
+namespace CHIKU
+{
+	struct DynamicStateSupport
+	{
+		bool ExtendedDynamicState = false;	//Cull mode, front face, topology class, depth test/write
+		bool ExtendedDynamicState2 = false;	//Primitive restart, depth bias enable
+		bool PolygonMode = false;			//Extended dynamic state 3
+		bool ColorBlendEnable = false;		//Extended dynamic state 3
+		bool UnrestrictedTopology = false;	//Any topology can be set, not only the class baked in the pipeline
+	};
+
+	struct DynamicStateCalls
+	{
+		uint32_t Issued = 0;
+		uint32_t Skipped = 0;
+	};
+
+	//Render state that the device lets us set at bind time is stripped from the pipeline key,
+	//so materials that only differ in that state share one VkPipeline.
+	//Devices without the extensions fall back to baking everything into the pipeline.
+	class DynamicState
+	{
+	public:
+		//Called while the logical device is being created, appends the extensions to enable
+		//and returns pNext extended with the features that have to be passed in VkDeviceCreateInfo::pNext
+		static void* QuerySupport(VkPhysicalDevice physicalDevice, const std::vector<VkExtensionProperties>& availableExtensions, std::vector<const char*>& deviceExtensions, void* pNext);
+		static void LoadFunctions(VkDevice device);
+
+		static const DynamicStateSupport& GetSupport() { return m_Support; }
+
+		static void GetPipelineDynamicStates(std::vector<VkDynamicState>& dynamicStates);
+		static RenderState GetPipelineRenderState(const RenderState& renderState);
+
+		//With previous set only the dynamic state that differs from it is recorded
+		static DynamicStateCalls Apply(VkCommandBuffer commandBuffer, const RenderState& renderState, const RenderState* previous = nullptr);
+
+	private:
+		static DynamicStateSupport m_Support;
+
+		static VkPhysicalDeviceExtendedDynamicStateFeaturesEXT m_DynamicStateFeatures;
+		static VkPhysicalDeviceExtendedDynamicState2FeaturesEXT m_DynamicState2Features;
+		static VkPhysicalDeviceExtendedDynamicState3FeaturesEXT m_DynamicState3Features;
+
+		static PFN_vkCmdSetCullModeEXT m_CmdSetCullMode;
+		static PFN_vkCmdSetFrontFaceEXT m_CmdSetFrontFace;
+		static PFN_vkCmdSetPrimitiveTopologyEXT m_CmdSetPrimitiveTopology;
+		static PFN_vkCmdSetDepthTestEnableEXT m_CmdSetDepthTestEnable;
+		static PFN_vkCmdSetDepthWriteEnableEXT m_CmdSetDepthWriteEnable;
+		static PFN_vkCmdSetPrimitiveRestartEnableEXT m_CmdSetPrimitiveRestartEnable;
+		static PFN_vkCmdSetDepthBiasEnableEXT m_CmdSetDepthBiasEnable;
+		static PFN_vkCmdSetPolygonModeEXT m_CmdSetPolygonMode;
+		static PFN_vkCmdSetColorBlendEnableEXT m_CmdSetColorBlendEnable;
+	};
+}
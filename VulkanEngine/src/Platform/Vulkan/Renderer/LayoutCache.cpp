@@ -0,0 +1,92 @@
+#include "LayoutCache.h"
+#include "Vulkan/Renderer/VulkanRenderer.h"
+
+namespace CHIKU
+{
+	std::unordered_map<DescriptorSetLayoutKey, VkDescriptorSetLayout> LayoutCache::m_DescriptorSetLayouts;
+	std::unordered_map<PipelineLayoutKey, VkPipelineLayout> LayoutCache::m_PipelineLayouts;
+
+	void LayoutCache::CleanUp()
+	{
+		ZoneScoped;
+
+		for (auto& [key, layout] : m_PipelineLayouts)
+		{
+			vkDestroyPipelineLayout(VulkanRenderer::GetVulkanDevice(), layout, nullptr);
+		}
+		m_PipelineLayouts.clear();
+
+		for (auto& [key, layout] : m_DescriptorSetLayouts)
+		{
+			vkDestroyDescriptorSetLayout(VulkanRenderer::GetVulkanDevice(), layout, nullptr);
+		}
+		m_DescriptorSetLayouts.clear();
+	}
+
+	VkDescriptorSetLayout LayoutCache::GetDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
+	{
+		ZoneScoped;
+
+		DescriptorSetLayoutKey key = { bindings };
+		std::sort(key.Bindings.begin(), key.Bindings.end(),
+			[](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b)
+			{
+				return a.binding < b.binding;
+			});
+
+		auto it = m_DescriptorSetLayouts.find(key);
+		if (it != m_DescriptorSetLayouts.end())
+		{
+			return it->second;
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(key.Bindings.size());
+		layoutInfo.pBindings = key.Bindings.data();
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(VulkanRenderer::GetVulkanDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create descriptor set layout!");
+		}
+
+		m_DescriptorSetLayouts[key] = layout;
+		return layout;
+	}
+
+	VkPipelineLayout LayoutCache::GetPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges)
+	{
+		ZoneScoped;
+
+		//Ranges are ordered by offset so the same shader interface always yields the same key
+		PipelineLayoutKey key = { setLayouts, pushConstantRanges };
+		std::sort(key.PushConstantRanges.begin(), key.PushConstantRanges.end(),
+			[](const VkPushConstantRange& a, const VkPushConstantRange& b)
+			{
+				return a.offset != b.offset ? a.offset < b.offset : a.stageFlags < b.stageFlags;
+			});
+
+		auto it = m_PipelineLayouts.find(key);
+		if (it != m_PipelineLayouts.end())
+		{
+			return it->second;
+		}
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(key.SetLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = key.SetLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(key.PushConstantRanges.size());
+		pipelineLayoutInfo.pPushConstantRanges = key.PushConstantRanges.data();
+
+		VkPipelineLayout pipelineLayout;
+		if (vkCreatePipelineLayout(VulkanRenderer::GetVulkanDevice(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+
+		m_PipelineLayouts[key] = pipelineLayout;
+		return pipelineLayout;
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Utils/Utils.h"
+
+namespace CHIKU
+{
+	//Bindings are kept sorted by binding index so two shaders declaring the same
+	//resources in a different order still resolve to the same layout
+	struct DescriptorSetLayoutKey
+	{
+		std::vector<VkDescriptorSetLayoutBinding> Bindings;
+
+		bool operator==(const DescriptorSetLayoutKey& other) const
+		{
+			if (Bindings.size() != other.Bindings.size())
+				return false;
+
+			for (size_t i = 0; i < Bindings.size(); i++)
+			{
+				const auto& a = Bindings[i];
+				const auto& b = other.Bindings[i];
+
+				if (a.binding != b.binding ||
+					a.descriptorType != b.descriptorType ||
+					a.descriptorCount != b.descriptorCount ||
+					a.stageFlags != b.stageFlags)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	};
+
+	struct PipelineLayoutKey
+	{
+		std::vector<VkDescriptorSetLayout> SetLayouts;
+		std::vector<VkPushConstantRange> PushConstantRanges;
+
+		bool operator==(const PipelineLayoutKey& other) const
+		{
+			if (SetLayouts != other.SetLayouts || PushConstantRanges.size() != other.PushConstantRanges.size())
+				return false;
+
+			for (size_t i = 0; i < PushConstantRanges.size(); i++)
+			{
+				const auto& a = PushConstantRanges[i];
+				const auto& b = other.PushConstantRanges[i];
+
+				if (a.stageFlags != b.stageFlags || a.offset != b.offset || a.size != b.size)
+					return false;
+			}
+
+			return true;
+		}
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<CHIKU::DescriptorSetLayoutKey>
+	{
+		size_t operator()(const CHIKU::DescriptorSetLayoutKey& key) const
+		{
+			size_t seed = 0;
+			for (const auto& binding : key.Bindings)
+			{
+				CHIKU::Utils::hash_combine(seed, std::hash<uint32_t>()(binding.binding));
+				CHIKU::Utils::hash_combine(seed, std::hash<uint32_t>()(static_cast<uint32_t>(binding.descriptorType)));
+				CHIKU::Utils::hash_combine(seed, std::hash<uint32_t>()(binding.descriptorCount));
+				CHIKU::Utils::hash_combine(seed, std::hash<uint32_t>()(binding.stageFlags));
+			}
+			return seed;
+		}
+	};
+
+	template<>
+	struct hash<CHIKU::PipelineLayoutKey>
+	{
+		size_t operator()(const CHIKU::PipelineLayoutKey& key) const
+		{
+			size_t seed = 0;
+			for (const auto& layout : key.SetLayouts)
+				CHIKU::Utils::hash_combine(seed, std::hash<VkDescriptorSetLayout>()(layout));
+			for (const auto& range : key.PushConstantRanges)
+			{
+				CHIKU::Utils::hash_combine(seed, std::hash<uint32_t>()(range.stageFlags));
+				CHIKU::Utils::hash_combine(seed, std::hash<uint32_t>()(range.offset));
+				CHIKU::Utils::hash_combine(seed, std::hash<uint32_t>()(range.size));
+			}
+			return seed;
+		}
+	};
+}
+
+namespace CHIKU
+{
+	//Owns every VkDescriptorSetLayout and VkPipelineLayout in the engine.
+	//Identical binding descriptions hand back the same Vulkan object, so materials
+	//sharing a shader share layouts and their pipelines stay layout compatible.
+	//Callers must never destroy the returned handles, CleanUp releases them all.
+	class LayoutCache
+	{
+	public:
+		static void CleanUp();
+
+		static VkDescriptorSetLayout GetDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+		static VkPipelineLayout GetPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges = {});
+
+	private:
+		static std::unordered_map<DescriptorSetLayoutKey, VkDescriptorSetLayout> m_DescriptorSetLayouts;
+		static std::unordered_map<PipelineLayoutKey, VkPipelineLayout> m_PipelineLayouts;
+	};
+}
@@ -0,0 +1,138 @@
+#include "MaterialTable.h"
+#include "DescriptorPool.h"
+#include "LayoutCache.h"
+#include "Vulkan/Renderer/VulkanRenderer.h"
+#include "Vulkan/Utils/VulkanBufferUtils.h"
+
+namespace CHIKU
+{
+	static constexpr VkDeviceSize TableFrameSize = static_cast<VkDeviceSize>(MATERIAL_RECORD_STRIDE) * MAX_MATERIALS;
+
+	VkBuffer MaterialTable::m_Table = VK_NULL_HANDLE;
+	VkDeviceMemory MaterialTable::m_TableMemory = VK_NULL_HANDLE;
+	uint8_t* MaterialTable::m_TableMapped = nullptr;
+	std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> MaterialTable::m_DescriptorSets{};
+
+	std::vector<MaterialID> MaterialTable::m_FreeList;
+	MaterialID MaterialTable::m_NextID = 0;
+	std::mutex MaterialTable::m_AllocationMutex;
+
+	void MaterialTable::Init()
+	{
+		ZoneScoped;
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(VulkanRenderer::GetVulkanPhysicalDevice(), &properties);
+		if (TableFrameSize % properties.limits.minStorageBufferOffsetAlignment != 0)
+		{
+			throw std::runtime_error("material table frame size does not respect the storage buffer alignment!");
+		}
+
+		//Each frame slot has its own copy, so a write never races a frame the GPU is still reading
+		Utils::CreateBuffer(TableFrameSize * MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			m_Table, m_TableMemory);
+
+		vkMapMemory(VulkanRenderer::GetVulkanDevice(), m_TableMemory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&m_TableMapped));
+		memset(m_TableMapped, 0, TableFrameSize * MAX_FRAMES_IN_FLIGHT);
+
+		std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> layouts;
+		layouts.fill(GetDescriptorSetLayout());
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = DescriptorPool::GetDescriptorPool();
+		allocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+		allocInfo.pSetLayouts = layouts.data();
+
+		if (vkAllocateDescriptorSets(VulkanRenderer::GetVulkanDevice(), &allocInfo, m_DescriptorSets.data()) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to allocate material table descriptor sets!");
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		{
+			VkDescriptorBufferInfo bufferInfo{ m_Table, TableFrameSize * i, TableFrameSize };
+
+			VkWriteDescriptorSet descriptorWrite{};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = m_DescriptorSets[i];
+			descriptorWrite.dstBinding = 0;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			descriptorWrite.pBufferInfo = &bufferInfo;
+
+			vkUpdateDescriptorSets(VulkanRenderer::GetVulkanDevice(), 1, &descriptorWrite, 0, nullptr);
+		}
+	}
+
+	void MaterialTable::CleanUp()
+	{
+		ZoneScoped;
+
+		if (m_Table == VK_NULL_HANDLE)
+			return;
+
+		vkUnmapMemory(VulkanRenderer::GetVulkanDevice(), m_TableMemory);
+		vkDestroyBuffer(VulkanRenderer::GetVulkanDevice(), m_Table, nullptr);
+		vkFreeMemory(VulkanRenderer::GetVulkanDevice(), m_TableMemory, nullptr);
+
+		m_Table = VK_NULL_HANDLE;
+		m_TableMemory = VK_NULL_HANDLE;
+		m_TableMapped = nullptr;
+
+		m_FreeList.clear();
+		m_NextID = 0;
+	}
+
+	MaterialID MaterialTable::Allocate()
+	{
+		std::lock_guard<std::mutex> lock(m_AllocationMutex);
+
+		if (!m_FreeList.empty())
+		{
+			MaterialID id = m_FreeList.back();
+			m_FreeList.pop_back();
+			return id;
+		}
+
+		if (m_NextID >= MAX_MATERIALS)
+		{
+			throw std::runtime_error("material table is full!");
+		}
+
+		return m_NextID++;
+	}
+
+	void MaterialTable::Free(MaterialID id)
+	{
+		if (id == InvalidMaterialID)
+			return;
+
+		std::lock_guard<std::mutex> lock(m_AllocationMutex);
+		m_FreeList.push_back(id);
+	}
+
+	void MaterialTable::Write(uint32_t currentFrame, MaterialID id, uint32_t offset, const void* data, uint32_t size)
+	{
+		if (id >= MAX_MATERIALS || offset + size > MATERIAL_RECORD_STRIDE)
+		{
+			throw std::runtime_error("material table write is out of bounds!");
+		}
+
+		memcpy(m_TableMapped + TableFrameSize * currentFrame + static_cast<VkDeviceSize>(MATERIAL_RECORD_STRIDE) * id + offset, data, size);
+	}
+
+	VkDescriptorSetLayout MaterialTable::GetDescriptorSetLayout()
+	{
+		std::vector<VkDescriptorSetLayoutBinding> bindings(1);
+
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		return LayoutCache::GetDescriptorSetLayout(bindings);
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "EngineHeader.h"
+#include <mutex>
+
+namespace CHIKU
+{
+	using MaterialID = uint32_t;
+	constexpr MaterialID InvalidMaterialID = UINT32_MAX;
+
+	//Constant data of every material lives in one storage buffer of MATERIAL_RECORD_STRIDE sized records,
+	//one copy per frame in flight. Shaders read MATERIAL_TABLE_DESCRIPTOR_SET binding 0 indexed by the
+	//material ID pushed per draw, so materials differ by an index instead of by descriptor sets.
+	class MaterialTable
+	{
+	public:
+		static void Init();
+		static void CleanUp();
+
+		static MaterialID Allocate();
+		static void Free(MaterialID id);
+
+		//Writes into the copy of the given frame slot, offset is relative to the record
+		static void Write(uint32_t currentFrame, MaterialID id, uint32_t offset, const void* data, uint32_t size);
+
+		static VkDescriptorSetLayout GetDescriptorSetLayout();
+		static VkDescriptorSet GetDescriptorSet(uint32_t currentFrame) { return m_DescriptorSets[currentFrame]; }
+
+	private:
+		static VkBuffer m_Table;
+		static VkDeviceMemory m_TableMemory;
+		static uint8_t* m_TableMapped;
+		static std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_DescriptorSets;
+
+		static std::vector<MaterialID> m_FreeList;
+		static MaterialID m_NextID;
+		static std::mutex m_AllocationMutex;
+	};
+}
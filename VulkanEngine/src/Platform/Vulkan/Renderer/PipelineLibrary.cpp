@@ -0,0 +1,422 @@
+#include "PipelineLibrary.h"
+#include "DynamicState.h"
+#include <Vulkan/Renderer/VulkanRenderer.h>
+#include <Vulkan/Buffer/VulkanVertexBuffer.h>
+#include <Vulkan/Utils/VulkanPipelineUtils.h>
+#include <Vulkan/Utils/VulkanRendererUtility.h>
+
+namespace CHIKU
+{
+	bool PipelineLibrary::m_Supported = false;
+	bool PipelineLibrary::m_FastLinking = false;
+	VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT PipelineLibrary::m_Features{};
+
+	std::unordered_map<VertexInputLibraryKey, VkPipeline> PipelineLibrary::m_VertexInputLibraries;
+	std::unordered_map<PreRasterLibraryKey, VkPipeline> PipelineLibrary::m_PreRasterLibraries;
+	std::unordered_map<FragmentShaderLibraryKey, VkPipeline> PipelineLibrary::m_FragmentShaderLibraries;
+	std::unordered_map<FragmentOutputLibraryKey, VkPipeline> PipelineLibrary::m_FragmentOutputLibraries;
+
+	std::thread PipelineLibrary::m_Worker;
+	std::mutex PipelineLibrary::m_JobMutex;
+	std::condition_variable PipelineLibrary::m_JobCondition;
+	std::deque<PipelineLibrary::OptimizeJob> PipelineLibrary::m_Jobs;
+	std::vector<OptimizedPipeline> PipelineLibrary::m_Finished;
+	bool PipelineLibrary::m_StopWorker = false;
+
+	//Every part gets the full list, the driver only looks at the states belonging to that part
+	static std::vector<VkDynamicState> GetLibraryDynamicStates()
+	{
+		std::vector<VkDynamicState> dynamicStates = {
+			VK_DYNAMIC_STATE_VIEWPORT,
+			VK_DYNAMIC_STATE_SCISSOR
+		};
+
+		DynamicState::GetPipelineDynamicStates(dynamicStates);
+		return dynamicStates;
+	}
+
+	void* PipelineLibrary::QuerySupport(VkPhysicalDevice physicalDevice, const std::vector<VkExtensionProperties>& availableExtensions, std::vector<const char*>& deviceExtensions, void* pNext)
+	{
+		ZoneScoped;
+
+		m_Supported = false;
+		m_FastLinking = false;
+
+		if (!Utils::IsExtensionAvailable(availableExtensions, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) ||
+			!Utils::IsExtensionAvailable(availableExtensions, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
+		{
+			LOG_WARN("VK_EXT_graphics_pipeline_library not supported, pipelines are compiled as a whole");
+			return pNext;
+		}
+
+		m_Features = {};
+		m_Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &m_Features;
+		vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+		if (m_Features.graphicsPipelineLibrary != VK_TRUE)
+		{
+			LOG_WARN("graphicsPipelineLibrary feature not supported, pipelines are compiled as a whole");
+			return pNext;
+		}
+
+		VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT properties{};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &properties;
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+		m_Supported = true;
+		m_FastLinking = properties.graphicsPipelineLibraryFastLinking == VK_TRUE;
+
+		deviceExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+		deviceExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+
+		LOG_INFO("Graphics pipeline library enabled, fast linking {}", m_FastLinking);
+
+		m_Features.pNext = pNext;
+		return &m_Features;
+	}
+
+	void PipelineLibrary::Init()
+	{
+		ZoneScoped;
+
+		if (!m_Supported)
+			return;
+
+		m_StopWorker = false;
+		m_Worker = std::thread(&PipelineLibrary::WorkerLoop);
+	}
+
+	void PipelineLibrary::CleanUp()
+	{
+		ZoneScoped;
+
+		if (m_Worker.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_JobMutex);
+				m_StopWorker = true;
+				m_Jobs.clear();
+			}
+			m_JobCondition.notify_all();
+			m_Worker.join();
+		}
+
+		VkDevice device = VulkanRenderer::GetVulkanDevice();
+
+		//Optimized pipelines nobody collected are still ours
+		for (auto& optimized : m_Finished)
+			vkDestroyPipeline(device, optimized.Pipeline, nullptr);
+		m_Finished.clear();
+
+		for (auto& [key, library] : m_VertexInputLibraries)
+			vkDestroyPipeline(device, library, nullptr);
+		m_VertexInputLibraries.clear();
+
+		for (auto& [key, library] : m_PreRasterLibraries)
+			vkDestroyPipeline(device, library, nullptr);
+		m_PreRasterLibraries.clear();
+
+		for (auto& [key, library] : m_FragmentShaderLibraries)
+			vkDestroyPipeline(device, library, nullptr);
+		m_FragmentShaderLibraries.clear();
+
+		for (auto& [key, library] : m_FragmentOutputLibraries)
+			vkDestroyPipeline(device, library, nullptr);
+		m_FragmentOutputLibraries.clear();
+	}
+
+	VkPipeline PipelineLibrary::Link(const PipelineKey& key, const std::shared_ptr<MaterialAsset>& materialAsset, VkPipelineLayout pipelineLayout)
+	{
+		ZoneScoped;
+
+		const RenderState& renderState = key.PipelineRenderState;
+		const auto& shaderStages = materialAsset->GetShader()->GetShaderStage();
+		const auto& constants = materialAsset->GetShader()->GetSpecializationConstants();
+
+		auto vertexStage = shaderStages.find(ShaderStages::Stage_Vertex);
+		auto fragmentStage = shaderStages.find(ShaderStages::Stage_Fragment);
+		if (vertexStage == shaderStages.end() || fragmentStage == shaderStages.end())
+		{
+			throw std::runtime_error("pipeline library requires a vertex and a fragment stage!");
+		}
+
+		std::array<VkPipeline, 4> libraries = {
+			GetVertexInputLibrary({ key.VertexLayout, renderState.Topology }),
+			GetPreRasterLibrary({ key.ShaderAssetHandle, pipelineLayout, renderState.Cull, renderState.Front, renderState.Polygon, key.Features }, vertexStage->second.ShaderModule, constants),
+			GetFragmentShaderLibrary({ key.ShaderAssetHandle, pipelineLayout, renderState.DepthTest, renderState.DepthWrite, key.Features }, fragmentStage->second.ShaderModule, constants),
+			GetFragmentOutputLibrary({ renderState.BlendEnabled })
+		};
+
+		VkPipeline pipeline = LinkLibraries(libraries, pipelineLayout, false);
+
+		{
+			std::lock_guard<std::mutex> lock(m_JobMutex);
+			m_Jobs.push_back({ key, pipelineLayout, libraries });
+		}
+		m_JobCondition.notify_one();
+
+		return pipeline;
+	}
+
+	void PipelineLibrary::CollectOptimizedPipelines(std::vector<OptimizedPipeline>& optimizedPipelines)
+	{
+		std::lock_guard<std::mutex> lock(m_JobMutex);
+		if (m_Finished.empty())
+			return;
+
+		optimizedPipelines.insert(optimizedPipelines.end(), m_Finished.begin(), m_Finished.end());
+		m_Finished.clear();
+	}
+
+	VkPipeline PipelineLibrary::GetVertexInputLibrary(const VertexInputLibraryKey& key)
+	{
+		auto it = m_VertexInputLibraries.find(key);
+		if (it != m_VertexInputLibraries.end())
+			return it->second;
+
+		ZoneScopedN("CreateVertexInputLibrary");
+
+		VkPipelineVertexInputStateCreateInfo vertexInputInfo = VulkanVertexBuffer::GetVertexInputState(key.VertexLayout);
+
+		RenderState renderState{};
+		renderState.Topology = key.Topology;
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly = Utils::GetInputAssemblyState(renderState);
+
+		std::vector<VkDynamicState> dynamicStates = GetLibraryDynamicStates();
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+		dynamicState.pDynamicStates = dynamicStates.data();
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.pVertexInputState = &vertexInputInfo;
+		pipelineInfo.pInputAssemblyState = &inputAssembly;
+		pipelineInfo.pDynamicState = &dynamicState;
+
+		VkPipeline library = CreateLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, pipelineInfo);
+		m_VertexInputLibraries[key] = library;
+		return library;
+	}
+
+	VkPipeline PipelineLibrary::GetPreRasterLibrary(const PreRasterLibraryKey& key, VkShaderModule vertexShader, const std::vector<SpecializationConstantInfo>& constants)
+	{
+		auto it = m_PreRasterLibraries.find(key);
+		if (it != m_PreRasterLibraries.end())
+			return it->second;
+
+		ZoneScopedN("CreatePreRasterLibrary");
+
+		VkPipelineShaderStageCreateInfo shaderStage{};
+		shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
+		shaderStage.module = vertexShader;
+		shaderStage.pName = "main";
+
+		SpecializationData specialization;
+		shaderStage.pSpecializationInfo = Utils::GetSpecializationInfo(constants, ShaderStages::Stage_Vertex, key.Features, specialization);
+
+		VkPipelineViewportStateCreateInfo viewportState{};
+		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewportState.viewportCount = 1;
+		viewportState.scissorCount = 1;
+
+		RenderState renderState{};
+		renderState.Cull = key.Cull;
+		renderState.Front = key.Front;
+		renderState.Polygon = key.Polygon;
+		VkPipelineRasterizationStateCreateInfo rasterizer = Utils::GetRasterizationState(renderState);
+
+		std::vector<VkDynamicState> dynamicStates = GetLibraryDynamicStates();
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+		dynamicState.pDynamicStates = dynamicStates.data();
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.stageCount = 1;
+		pipelineInfo.pStages = &shaderStage;
+		pipelineInfo.pViewportState = &viewportState;
+		pipelineInfo.pRasterizationState = &rasterizer;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = key.PipelineLayout;
+		pipelineInfo.renderPass = VulkanRenderer::GetVulkanRenderPass();
+		pipelineInfo.subpass = 0;
+
+		VkPipeline library = CreateLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, pipelineInfo);
+		m_PreRasterLibraries[key] = library;
+		return library;
+	}
+
+	VkPipeline PipelineLibrary::GetFragmentShaderLibrary(const FragmentShaderLibraryKey& key, VkShaderModule fragmentShader, const std::vector<SpecializationConstantInfo>& constants)
+	{
+		auto it = m_FragmentShaderLibraries.find(key);
+		if (it != m_FragmentShaderLibraries.end())
+			return it->second;
+
+		ZoneScopedN("CreateFragmentShaderLibrary");
+
+		VkPipelineShaderStageCreateInfo shaderStage{};
+		shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+		shaderStage.module = fragmentShader;
+		shaderStage.pName = "main";
+
+		SpecializationData specialization;
+		shaderStage.pSpecializationInfo = Utils::GetSpecializationInfo(constants, ShaderStages::Stage_Fragment, key.Features, specialization);
+
+		RenderState renderState{};
+		renderState.DepthTest = key.DepthTest;
+		renderState.DepthWrite = key.DepthWrite;
+		VkPipelineDepthStencilStateCreateInfo depthStencil = Utils::GetDepthStencilState(renderState);
+		VkPipelineMultisampleStateCreateInfo multisampling = Utils::GetMultisampleState();
+
+		std::vector<VkDynamicState> dynamicStates = GetLibraryDynamicStates();
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+		dynamicState.pDynamicStates = dynamicStates.data();
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.stageCount = 1;
+		pipelineInfo.pStages = &shaderStage;
+		pipelineInfo.pDepthStencilState = &depthStencil;
+		pipelineInfo.pMultisampleState = &multisampling;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = key.PipelineLayout;
+		pipelineInfo.renderPass = VulkanRenderer::GetVulkanRenderPass();
+		pipelineInfo.subpass = 0;
+
+		VkPipeline library = CreateLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, pipelineInfo);
+		m_FragmentShaderLibraries[key] = library;
+		return library;
+	}
+
+	VkPipeline PipelineLibrary::GetFragmentOutputLibrary(const FragmentOutputLibraryKey& key)
+	{
+		auto it = m_FragmentOutputLibraries.find(key);
+		if (it != m_FragmentOutputLibraries.end())
+			return it->second;
+
+		ZoneScopedN("CreateFragmentOutputLibrary");
+
+		RenderState renderState{};
+		renderState.BlendEnabled = key.BlendEnabled;
+		VkPipelineColorBlendAttachmentState colorBlendAttachment = Utils::GetColorBlendAttachmentState(renderState);
+
+		VkPipelineColorBlendStateCreateInfo colorBlending{};
+		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlending.logicOpEnable = VK_FALSE;
+		colorBlending.logicOp = VK_LOGIC_OP_COPY;
+		colorBlending.attachmentCount = 1;
+		colorBlending.pAttachments = &colorBlendAttachment;
+
+		VkPipelineMultisampleStateCreateInfo multisampling = Utils::GetMultisampleState();
+
+		std::vector<VkDynamicState> dynamicStates = GetLibraryDynamicStates();
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+		dynamicState.pDynamicStates = dynamicStates.data();
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.pColorBlendState = &colorBlending;
+		pipelineInfo.pMultisampleState = &multisampling;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.renderPass = VulkanRenderer::GetVulkanRenderPass();
+		pipelineInfo.subpass = 0;
+
+		VkPipeline library = CreateLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, pipelineInfo);
+		m_FragmentOutputLibraries[key] = library;
+		return library;
+	}
+
+	VkPipeline PipelineLibrary::CreateLibrary(VkGraphicsPipelineLibraryFlagsEXT flags, VkGraphicsPipelineCreateInfo& pipelineInfo)
+	{
+		VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo{};
+		libraryInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+		libraryInfo.flags = flags;
+
+		//Link time optimization info is kept so the background link can produce a fully optimized pipeline
+		pipelineInfo.pNext = &libraryInfo;
+		pipelineInfo.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+
+		VkPipeline library;
+		if (vkCreateGraphicsPipelines(VulkanRenderer::GetVulkanDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &library) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create graphics pipeline library!");
+		}
+
+		return library;
+	}
+
+	VkPipeline PipelineLibrary::LinkLibraries(const std::array<VkPipeline, 4>& libraries, VkPipelineLayout pipelineLayout, bool optimize)
+	{
+		ZoneScoped;
+
+		VkPipelineLibraryCreateInfoKHR linkInfo{};
+		linkInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+		linkInfo.libraryCount = static_cast<uint32_t>(libraries.size());
+		linkInfo.pLibraries = libraries.data();
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.pNext = &linkInfo;
+		pipelineInfo.flags = optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+		pipelineInfo.layout = pipelineLayout;
+
+		VkPipeline pipeline;
+		if (vkCreateGraphicsPipelines(VulkanRenderer::GetVulkanDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to link graphics pipeline libraries!");
+		}
+
+		return pipeline;
+	}
+
+	void PipelineLibrary::WorkerLoop()
+	{
+		tracy::SetThreadName("PipelineLibrary");
+
+		while (true)
+		{
+			OptimizeJob job;
+			{
+				std::unique_lock<std::mutex> lock(m_JobMutex);
+				m_JobCondition.wait(lock, [] { return m_StopWorker || !m_Jobs.empty(); });
+
+				if (m_StopWorker)
+					return;
+
+				job = m_Jobs.front();
+				m_Jobs.pop_front();
+			}
+
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			try
+			{
+				pipeline = LinkLibraries(job.Libraries, job.PipelineLayout, true);
+			}
+			catch (const std::exception& e)
+			{
+				//The fast linked pipeline stays in use
+				LOG_WARN("Optimized pipeline link failed: {}", e.what());
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(m_JobMutex);
+			m_Finished.push_back({ job.Key, pipeline });
+		}
+	}
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Renderer/GraphicsPipeline.h"
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace CHIKU
+{
+	//Each part only holds the state VK_EXT_graphics_pipeline_library assigns to it,
+	//so a new vertex layout only compiles a vertex input part and reuses the shader parts
+	struct VertexInputLibraryKey
+	{
+		VertexLayoutID VertexLayout;
+		PrimitiveTopology Topology;
+
+		bool operator==(const VertexInputLibraryKey& other) const
+		{
+			return VertexLayout == other.VertexLayout && Topology == other.Topology;
+		}
+	};
+
+	struct PreRasterLibraryKey
+	{
+		AssetHandle ShaderAssetHandle;
+		VkPipelineLayout PipelineLayout;
+		CullMode Cull;
+		FrontFace Front;
+		PolygonMode Polygon;
+		ShaderFeatureMask Features;
+
+		bool operator==(const PreRasterLibraryKey& other) const
+		{
+			return ShaderAssetHandle == other.ShaderAssetHandle &&
+				PipelineLayout == other.PipelineLayout &&
+				Cull == other.Cull &&
+				Front == other.Front &&
+				Polygon == other.Polygon &&
+				Features == other.Features;
+		}
+	};
+
+	struct FragmentShaderLibraryKey
+	{
+		AssetHandle ShaderAssetHandle;
+		VkPipelineLayout PipelineLayout;
+		bool DepthTest;
+		bool DepthWrite;
+		ShaderFeatureMask Features;
+
+		bool operator==(const FragmentShaderLibraryKey& other) const
+		{
+			return ShaderAssetHandle == other.ShaderAssetHandle &&
+				PipelineLayout == other.PipelineLayout &&
+				DepthTest == other.DepthTest &&
+				DepthWrite == other.DepthWrite &&
+				Features == other.Features;
+		}
+	};
+
+	struct FragmentOutputLibraryKey
+	{
+		bool BlendEnabled;
+
+		bool operator==(const FragmentOutputLibraryKey& other) const
+		{
+			return BlendEnabled == other.BlendEnabled;
+		}
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<CHIKU::VertexInputLibraryKey>
+	{
+		size_t operator()(const CHIKU::VertexInputLibraryKey& key) const
+		{
+			size_t seed = 0;
+			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::VertexLayoutID>()(key.VertexLayout));
+			CHIKU::Utils::hash_combine(seed, std::hash<uint8_t>()(static_cast<uint8_t>(key.Topology)));
+			return seed;
+		}
+	};
+
+	template<>
+	struct hash<CHIKU::PreRasterLibraryKey>
+	{
+		size_t operator()(const CHIKU::PreRasterLibraryKey& key) const
+		{
+			size_t seed = 0;
+			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::AssetHandle>()(key.ShaderAssetHandle));
+			CHIKU::Utils::hash_combine(seed, std::hash<VkPipelineLayout>()(key.PipelineLayout));
+			CHIKU::Utils::hash_combine(seed, std::hash<uint8_t>()(static_cast<uint8_t>(key.Cull)));
+			CHIKU::Utils::hash_combine(seed, std::hash<uint8_t>()(static_cast<uint8_t>(key.Front)));
+			CHIKU::Utils::hash_combine(seed, std::hash<uint8_t>()(static_cast<uint8_t>(key.Polygon)));
+			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::ShaderFeatureMask>()(key.Features));
+			return seed;
+		}
+	};
+
+	template<>
+	struct hash<CHIKU::FragmentShaderLibraryKey>
+	{
+		size_t operator()(const CHIKU::FragmentShaderLibraryKey& key) const
+		{
+			size_t seed = 0;
+			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::AssetHandle>()(key.ShaderAssetHandle));
+			CHIKU::Utils::hash_combine(seed, std::hash<VkPipelineLayout>()(key.PipelineLayout));
+			CHIKU::Utils::hash_combine(seed, std::hash<bool>()(key.DepthTest));
+			CHIKU::Utils::hash_combine(seed, std::hash<bool>()(key.DepthWrite));
+			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::ShaderFeatureMask>()(key.Features));
+			return seed;
+		}
+	};
+
+	template<>
+	struct hash<CHIKU::FragmentOutputLibraryKey>
+	{
+		size_t operator()(const CHIKU::FragmentOutputLibraryKey& key) const
+		{
+			return std::hash<bool>()(key.BlendEnabled);
+		}
+	};
+}
+
+namespace CHIKU
+{
+	struct OptimizedPipeline
+	{
+		PipelineKey Key;
+		VkPipeline Pipeline;
+	};
+
+	//Builds pipelines out of independently compiled and cached
+	//VK_EXT_graphics_pipeline_library parts. A missing pipeline is fast linked on
+	//the spot and a link time optimized version is queued on a worker thread,
+	//the caller swaps it in once CollectOptimizedPipelines hands it back.
+	//Parts are owned here and released in CleanUp, linked pipelines belong to the caller.
+	class PipelineLibrary
+	{
+	public:
+		//Same contract as DynamicState::QuerySupport, pNext is the chain built so far
+		static void* QuerySupport(VkPhysicalDevice physicalDevice, const std::vector<VkExtensionProperties>& availableExtensions, std::vector<const char*>& deviceExtensions, void* pNext);
+		static bool IsSupported() { return m_Supported; }
+
+		static void Init();
+		static void CleanUp();
+
+		static VkPipeline Link(const PipelineKey& key, const std::shared_ptr<MaterialAsset>& materialAsset, VkPipelineLayout pipelineLayout);
+		static void CollectOptimizedPipelines(std::vector<OptimizedPipeline>& optimizedPipelines);
+
+	private:
+		struct OptimizeJob
+		{
+			PipelineKey Key;
+			VkPipelineLayout PipelineLayout;
+			std::array<VkPipeline, 4> Libraries;
+		};
+
+		static VkPipeline GetVertexInputLibrary(const VertexInputLibraryKey& key);
+		static VkPipeline GetPreRasterLibrary(const PreRasterLibraryKey& key, VkShaderModule vertexShader, const std::vector<SpecializationConstantInfo>& constants);
+		static VkPipeline GetFragmentShaderLibrary(const FragmentShaderLibraryKey& key, VkShaderModule fragmentShader, const std::vector<SpecializationConstantInfo>& constants);
+		static VkPipeline GetFragmentOutputLibrary(const FragmentOutputLibraryKey& key);
+
+		static VkPipeline CreateLibrary(VkGraphicsPipelineLibraryFlagsEXT flags, VkGraphicsPipelineCreateInfo& pipelineInfo);
+		static VkPipeline LinkLibraries(const std::array<VkPipeline, 4>& libraries, VkPipelineLayout pipelineLayout, bool optimize);
+
+		static void WorkerLoop();
+
+	private:
+		static bool m_Supported;
+		static bool m_FastLinking;
+		static VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT m_Features;
+
+		static std::unordered_map<VertexInputLibraryKey, VkPipeline> m_VertexInputLibraries;
+		static std::unordered_map<PreRasterLibraryKey, VkPipeline> m_PreRasterLibraries;
+		static std::unordered_map<FragmentShaderLibraryKey, VkPipeline> m_FragmentShaderLibraries;
+		static std::unordered_map<FragmentOutputLibraryKey, VkPipeline> m_FragmentOutputLibraries;
+
+		static std::thread m_Worker;
+		static std::mutex m_JobMutex;
+		static std::condition_variable m_JobCondition;
+		static std::deque<OptimizeJob> m_Jobs;
+		static std::vector<OptimizedPipeline> m_Finished;
+		static bool m_StopWorker;
+	};
+}
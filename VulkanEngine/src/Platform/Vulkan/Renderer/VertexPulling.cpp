@@ -0,0 +1,190 @@
+#include "VertexPulling.h"
+#include "LayoutCache.h"
+#include "Vulkan/Renderer/VulkanRenderer.h"
+#include "Vulkan/Utils/VulkanBufferUtils.h"
+
+namespace CHIKU
+{
+	VkBuffer VertexPulling::m_LayoutTable = VK_NULL_HANDLE;
+	VkDeviceMemory VertexPulling::m_LayoutTableMemory = VK_NULL_HANDLE;
+	uint8_t* VertexPulling::m_LayoutTableMapped = nullptr;
+	VkDeviceSize VertexPulling::m_EntryStride = sizeof(VertexLayoutEntry);
+	std::vector<VkDescriptorPool> VertexPulling::m_Pools;
+	std::mutex VertexPulling::m_PoolMutex;
+
+	//Every vertex buffer drawn with a pulling shader owns one set, so pools are sized for many meshes
+	static constexpr uint32_t SetsPerPool = 256;
+
+	void VertexPulling::Init()
+	{
+		ZoneScoped;
+
+		//Each set binds a single entry, so entries have to respect the storage buffer offset alignment
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(VulkanRenderer::GetVulkanPhysicalDevice(), &properties);
+		const VkDeviceSize alignment = std::max<VkDeviceSize>(properties.limits.minStorageBufferOffsetAlignment, 4);
+		m_EntryStride = (sizeof(VertexLayoutEntry) + alignment - 1) / alignment * alignment;
+
+		//Entries are written once when a layout is first seen and never change afterwards,
+		//so a host coherent table is safe to append to while frames are in flight
+		Utils::CreateBuffer(m_EntryStride * MAX_VERTEX_LAYOUTS, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			m_LayoutTable, m_LayoutTableMemory);
+
+		vkMapMemory(VulkanRenderer::GetVulkanDevice(), m_LayoutTableMemory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&m_LayoutTableMapped));
+	}
+
+	void VertexPulling::CleanUp()
+	{
+		ZoneScoped;
+
+		for (VkDescriptorPool pool : m_Pools)
+		{
+			vkDestroyDescriptorPool(VulkanRenderer::GetVulkanDevice(), pool, nullptr);
+		}
+		m_Pools.clear();
+
+		if (m_LayoutTable == VK_NULL_HANDLE)
+			return;
+
+		vkUnmapMemory(VulkanRenderer::GetVulkanDevice(), m_LayoutTableMemory);
+		vkDestroyBuffer(VulkanRenderer::GetVulkanDevice(), m_LayoutTable, nullptr);
+		vkFreeMemory(VulkanRenderer::GetVulkanDevice(), m_LayoutTableMemory, nullptr);
+
+		m_LayoutTable = VK_NULL_HANDLE;
+		m_LayoutTableMemory = VK_NULL_HANDLE;
+		m_LayoutTableMapped = nullptr;
+	}
+
+	void VertexPulling::RegisterLayout(VertexLayoutID layoutID, const VertexBufferLayout& layout)
+	{
+		ZoneScoped;
+
+		if (layoutID >= MAX_VERTEX_LAYOUTS)
+		{
+			throw std::runtime_error("vertex layout table is full!");
+		}
+
+		VertexLayoutEntry entry{};
+		entry.ElementCount = static_cast<uint32_t>(std::min<size_t>(layout.VertexElements.size(), ATTR_COUNT));
+		entry.Stride = layout.Stride;
+
+		for (uint32_t i = 0; i < entry.ElementCount; i++)
+		{
+			const auto& element = layout.VertexElements[i];
+			entry.Offsets[i] = element.Offset;
+			entry.Formats[i] = static_cast<uint32_t>(element.ComponentType) | ((static_cast<uint32_t>(element.AttributeType) + 1) << 8);
+		}
+
+		memcpy(m_LayoutTableMapped + m_EntryStride * layoutID, &entry, sizeof(VertexLayoutEntry));
+	}
+
+	VkDescriptorSetLayout VertexPulling::GetDescriptorSetLayout()
+	{
+		std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+		return LayoutCache::GetDescriptorSetLayout(bindings);
+	}
+
+	VkDescriptorPool VertexPulling::CreatePool()
+	{
+		ZoneScoped;
+
+		VkDescriptorPoolSize poolSize{};
+		poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		poolSize.descriptorCount = SetsPerPool * 2;
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+		poolInfo.maxSets = SetsPerPool;
+
+		VkDescriptorPool pool;
+		if (vkCreateDescriptorPool(VulkanRenderer::GetVulkanDevice(), &poolInfo, nullptr, &pool) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create vertex pulling descriptor pool!");
+		}
+
+		m_Pools.push_back(pool);
+		return pool;
+	}
+
+	VkDescriptorSet VertexPulling::CreateDescriptorSet(VertexLayoutID layoutID, VkBuffer vertexBuffer, VkDeviceSize size, VkDescriptorPool& pool)
+	{
+		ZoneScoped;
+
+		VkDescriptorSetLayout setLayout = GetDescriptorSetLayout();
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &setLayout;
+
+		VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+		{
+			std::lock_guard<std::mutex> lock(m_PoolMutex);
+
+			//Freed sets leave room in older pools, try them before growing
+			VkResult result = VK_ERROR_OUT_OF_POOL_MEMORY;
+			for (auto it = m_Pools.rbegin(); it != m_Pools.rend() && result != VK_SUCCESS; ++it)
+			{
+				allocInfo.descriptorPool = *it;
+				result = vkAllocateDescriptorSets(VulkanRenderer::GetVulkanDevice(), &allocInfo, &descriptorSet);
+			}
+
+			if (result != VK_SUCCESS)
+			{
+				allocInfo.descriptorPool = CreatePool();
+				result = vkAllocateDescriptorSets(VulkanRenderer::GetVulkanDevice(), &allocInfo, &descriptorSet);
+			}
+
+			if (result != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to allocate vertex pulling descriptor set!");
+			}
+		}
+		pool = allocInfo.descriptorPool;
+
+		std::array<VkDescriptorBufferInfo, 2> bufferInfos{};
+		bufferInfos[0] = { m_LayoutTable, m_EntryStride * layoutID, sizeof(VertexLayoutEntry) };
+		bufferInfos[1] = { vertexBuffer, 0, size };
+
+		std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+		for (uint32_t i = 0; i < descriptorWrites.size(); i++)
+		{
+			descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[i].dstSet = descriptorSet;
+			descriptorWrites[i].dstBinding = i;
+			descriptorWrites[i].dstArrayElement = 0;
+			descriptorWrites[i].descriptorCount = 1;
+			descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+		}
+
+		vkUpdateDescriptorSets(VulkanRenderer::GetVulkanDevice(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+		return descriptorSet;
+	}
+
+	void VertexPulling::FreeDescriptorSet(VkDescriptorPool pool, VkDescriptorSet descriptorSet)
+	{
+		ZoneScoped;
+
+		if (descriptorSet == VK_NULL_HANDLE)
+			return;
+
+		std::lock_guard<std::mutex> lock(m_PoolMutex);
+		vkFreeDescriptorSets(VulkanRenderer::GetVulkanDevice(), pool, 1, &descriptorSet);
+	}
+}
\ No newline at end of file
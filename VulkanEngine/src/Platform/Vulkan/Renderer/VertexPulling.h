@@ -0,0 +1,45 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Renderer/Buffer/VertexBuffer.h"
+
+namespace CHIKU
+{
+	//Mirrors VertexLayout in Shaders/Common/VertexPulling.glsl (std430), indexed by element/location
+	struct VertexLayoutEntry
+	{
+		uint32_t ElementCount;
+		uint32_t Stride;
+		uint32_t Offsets[ATTR_COUNT];
+		uint32_t Formats[ATTR_COUNT]; //ComponentType | ComponentCount << 8
+	};
+
+	//Shaders that declare set VERTEX_PULLING_DESCRIPTOR_SET fetch their vertices from storage buffers
+	//instead of the input assembler. Every interned layout gets an entry in one table, each vertex
+	//buffer gets a set pointing at its own entry and data, so the pipeline itself is layout agnostic.
+	class VertexPulling
+	{
+	public:
+		static void Init();
+		static void CleanUp();
+
+		static void RegisterLayout(VertexLayoutID layoutID, const VertexBufferLayout& layout);
+
+		static VkDescriptorSetLayout GetDescriptorSetLayout();
+		//Sets come from pools owned by VertexPulling so evicted buffers can hand theirs back,
+		//pool receives the pool the set was allocated from and has to be passed to FreeDescriptorSet
+		static VkDescriptorSet CreateDescriptorSet(VertexLayoutID layoutID, VkBuffer vertexBuffer, VkDeviceSize size, VkDescriptorPool& pool);
+		static void FreeDescriptorSet(VkDescriptorPool pool, VkDescriptorSet descriptorSet);
+
+	private:
+		static VkDescriptorPool CreatePool();
+
+	private:
+		static VkBuffer m_LayoutTable;
+		static VkDeviceMemory m_LayoutTableMemory;
+		static uint8_t* m_LayoutTableMapped;
+		static VkDeviceSize m_EntryStride;
+
+		static std::vector<VkDescriptorPool> m_Pools; //grows by one pool whenever the last one is full
+		static std::mutex m_PoolMutex;
+	};
+}
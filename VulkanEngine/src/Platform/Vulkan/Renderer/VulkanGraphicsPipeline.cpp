@@ -1,9 +1,18 @@
 #include "VulkanGraphicsPipeline.h"
 #include <Vulkan/Utils/VulkanShaderUtils.h>
+#include <Vulkan/Utils/VulkanPipelineUtils.h>
 #include <Vulkan/Renderer/VulkanRenderer.h>
 #include <Vulkan/Buffer/VulkanVertexBuffer.h>
 #include <Vulkan/Assets/VulkanMaterialAsset.h>
 #include "VulkanGraphicsPipelineData.h"
+#include "LayoutCache.h"
+#include "DynamicState.h"
+#include "CommandRecorder.h"
+#include "Memory/AllocationTracker.h"
+#include "PipelineLibrary.h"
+#include "VertexPulling.h"
+#include "MaterialTable.h"
+#include <Renderer/RenderQueue.h>
 
 namespace CHIKU
 {
@@ -16,11 +25,10 @@ namespace CHIKU
 			{0,UniformOpaqueDataType::none},
 			{
 				{UniformPlainDataType::Mat4, 0, sizeof(glm::mat4)},
-				{UniformPlainDataType::Mat4, sizeof(glm::mat4), sizeof(glm::mat4)},
-				{UniformPlainDataType::Mat4, sizeof(glm::mat4) * 2, sizeof(glm::mat4)}
+				{UniformPlainDataType::Mat4, sizeof(glm::mat4), sizeof(glm::mat4)}
 			},
 			0,
-			sizeof(glm::mat4) * 3,
+			sizeof(CameraUniformData),
 		};
 
 		bufferDescription[0][0].Stages.set(ShaderStages::Stage_Vertex);
@@ -37,17 +45,27 @@ namespace CHIKU
 				m_GlobalDescriptorSetsChache[i][setIndex] = UniformStorage.DescriptorSets[i];
 			}
 		}
+
+		PipelineLibrary::Init();
 	}
 
 	void VulkanGraphicsPipeline::mCleanUp() 
 	{
 		ZoneScoped;
-		for (auto& [key, pipelineData] : m_Pipelines)
+		PipelineLibrary::CleanUp();
+
+		for (auto& pipelineData : m_PipelineData)
 		{
 			vkDestroyPipeline(VulkanRenderer::GetVulkanDevice(), pipelineData.Pipeline, nullptr);
-			vkDestroyPipelineLayout(VulkanRenderer::GetVulkanDevice(), pipelineData.PipelineLayout, nullptr);
 		}
 		m_Pipelines.clear();
+		m_PipelineData.clear();
+
+		for (auto& [frame, pipeline] : m_RetiredPipelines)
+		{
+			vkDestroyPipeline(VulkanRenderer::GetVulkanDevice(), pipeline, nullptr);
+		}
+		m_RetiredPipelines.clear();
 
 		for (auto& setStorage : m_GlobalUniformSetStorage)
 		{
@@ -59,7 +77,6 @@ namespace CHIKU
 					vkFreeMemory(VulkanRenderer::GetVulkanDevice(), storage.UniformBuffersMemory[i], nullptr);
 				}
 			}
-			vkDestroyDescriptorSetLayout(VulkanRenderer::GetVulkanDevice(), setStorage.DescriptorSetLayout, nullptr);
 		}
 	}
 
@@ -67,80 +84,220 @@ namespace CHIKU
 		const std::shared_ptr<MaterialAsset>& materialAsset, 
 		const std::shared_ptr<MeshAsset>& meshAsset) 
 	{
-		const auto& vertexBuffer = meshAsset->GetVertexBuffer();
-		const std::shared_ptr<VulkanVertexBuffer> vulkanVB = std::dynamic_pointer_cast<VulkanVertexBuffer>(vertexBuffer);
-		PipelineKey key = { materialAsset->GetHandle(), vertexBuffer->GetMetaData() };
+		//State the device can set at bind time is canonicalized away so it does not split pipelines,
+		//and features the shader has no constant for would only produce identical variants
+		PipelineKey key = {
+			materialAsset->GetShader()->GetHandle(),
+			DynamicState::GetPipelineRenderState(materialAsset->GetRenderState()),
+			GetPipelineVertexLayout(materialAsset, meshAsset),
+			materialAsset->GetFeatures() & materialAsset->GetShader()->GetFeatureMask()
+		};
 
-		if (m_Pipelines.find(key) == m_Pipelines.end())
+		auto it = m_Pipelines.find(key);
+		if (it == m_Pipelines.end())
 		{
-			m_Pipelines[key] = CreatePipeline(materialAsset, vulkanVB->GetBindingDescription(), vulkanVB->GetAttributeDescriptions());
+			//First use of a key, the only part of submission that may allocate
+			AllocationTracker::AllowScope allow;
+
+			PipelineData pipelineData;
+			if (PipelineLibrary::IsSupported())
+			{
+				VkPipelineLayout pipelineLayout = GetPipelineLayout(materialAsset);
+				pipelineData = PipelineData{ PipelineLibrary::Link(key, materialAsset, pipelineLayout), pipelineLayout };
+			}
+			else
+			{
+				pipelineData = CreatePipeline(materialAsset, key.PipelineRenderState, key.VertexLayout, key.Features);
+			}
+
+			pipelineData.ID = static_cast<uint32_t>(m_PipelineData.size());
+			m_PipelineData.push_back(pipelineData);
+			it = m_Pipelines.emplace(key, pipelineData.ID).first;
 		}
 
-		return m_Pipelines[key];
+		return m_PipelineData[it->second];
 	}
 
-	void VulkanGraphicsPipeline::mBindPipeline(
-		const std::shared_ptr<MaterialAsset>& materialAsset,
-		const std::shared_ptr<MeshAsset>& meshAsset) 
+	void VulkanGraphicsPipeline::mUpdate()
 	{
+		ZoneScoped;
 
-		auto& let = m_GlobalUniformSetStorage[0].BindingStorage[0].UniformBuffersMapped[VulkanRenderer::GetCurrentFrame()];
-
-		static auto startTime = std::chrono::high_resolution_clock::now();
-
-		auto currentTime = std::chrono::high_resolution_clock::now();
-		float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+		m_FrameNumber++;
 
-		glm::mat4 model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		//glm::mat4 model = glm::mat4(1.0f);
+		//The camera is shared by every draw, so it is written once per frame instead of per bind
+		const float nearPlane = 0.1f;
+		const float farPlane = 10.0f;
 		glm::mat4 view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-		glm::mat4 proj = glm::perspective(glm::radians(45.0f), (float)Window::WIDTH / (float)Window::HEIGHT, 0.1f, 10.0f);
+		glm::mat4 proj = glm::perspective(glm::radians(45.0f), (float)Window::WIDTH / (float)Window::HEIGHT, nearPlane, farPlane);
 
 		proj[1][1] *= -1;
 
-		//model = glm::scale(model, glm::vec3(0.5f, 0.5f, 0.5f));
+		CameraUniformData camera = { view, proj };
+		memcpy(m_GlobalUniformSetStorage[0].BindingStorage[0].UniformBuffersMapped[VulkanRenderer::GetCurrentFrame()], &camera, sizeof(CameraUniformData));
+		RenderQueue::SetView(view, nearPlane, farPlane);
+
+		//Static materials are not touched here, only the ones with pending parameter changes
+		VulkanMaterialAsset::FlushDirtyMaterials(VulkanRenderer::GetCurrentFrame());
+
+		//Optimized pipelines arrive a handful of times after a new key, not every frame
+		AllocationTracker::AllowScope allow;
+
+		m_OptimizedPipelines.clear();
+		PipelineLibrary::CollectOptimizedPipelines(m_OptimizedPipelines);
+
+		for (const auto& optimized : m_OptimizedPipelines)
+		{
+			auto it = m_Pipelines.find(optimized.Key);
+			if (it == m_Pipelines.end())
+			{
+				vkDestroyPipeline(VulkanRenderer::GetVulkanDevice(), optimized.Pipeline, nullptr);
+				continue;
+			}
 
-		auto size = sizeof(glm::mat4);
+			//The fast linked pipeline may still be referenced by frames in flight
+			PipelineData& pipelineData = m_PipelineData[it->second];
+			m_RetiredPipelines.push_back({ m_FrameNumber, pipelineData.Pipeline });
+			pipelineData.Pipeline = optimized.Pipeline;
+		}
 
-		glm::mat4 data[3] = { model,view,proj };
-		memcpy(let, data, size);
-		memcpy((uint8_t*)let + size, (uint8_t*)data + size, size * 2);
+		while (!m_RetiredPipelines.empty() && m_FrameNumber - m_RetiredPipelines.front().first >= MAX_FRAMES_IN_FLIGHT)
+		{
+			vkDestroyPipeline(VulkanRenderer::GetVulkanDevice(), m_RetiredPipelines.front().second, nullptr);
+			m_RetiredPipelines.pop_front();
+		}
+	}
 
-		materialAsset->UpdateUniformBuffer(VulkanRenderer::GetCurrentFrame());
+	void VulkanGraphicsPipeline::mBindPipeline(uint32_t pipelineID, const MaterialAsset& materialAsset, const MeshAsset& meshAsset)
+	{
+		const uint32_t currentFrame = VulkanRenderer::GetCurrentFrame();
+		const PipelineData& pipelineData = m_PipelineData[pipelineID];
 
-		std::shared_ptr<VulkanMaterialAsset> vulkanMaterialAsset = std::dynamic_pointer_cast<VulkanMaterialAsset>(materialAsset);
+		//Only Vulkan materials and buffers reach the Vulkan pipeline
+		const MaterialBindRecord& bindRecord = static_cast<const VulkanMaterialAsset&>(materialAsset).GetBindRecord(currentFrame);
 
-		const auto& [pipeline, pipelineLayout] = GraphicsPipeline::GetPipeline(materialAsset, meshAsset);
-		const auto& sets = vulkanMaterialAsset->GetDescriptorSets(VulkanRenderer::GetCurrentFrame());
+		std::array<VkDescriptorSet, MAX_BOUND_DESCRIPTOR_SETS> descriptorSets;
+		uint32_t setCount = 0;
 
-		std::vector<VkDescriptorSet> descriptorSets;
+		for (VkDescriptorSet set : m_GlobalDescriptorSetsChache[currentFrame])
+			descriptorSets[setCount++] = set;
 
-		descriptorSets.insert(descriptorSets.end(), m_GlobalDescriptorSetsChache[VulkanRenderer::GetCurrentFrame()].begin(), m_GlobalDescriptorSetsChache[VulkanRenderer::GetCurrentFrame()].end());
-		descriptorSets.insert(descriptorSets.end(), sets.begin(), sets.end());
+		for (uint32_t i = 0; i < bindRecord.SetCount; i++)
+			descriptorSets[setCount++] = bindRecord.Sets[i];
 
-		vkCmdBindDescriptorSets(
-			VulkanRenderer::GetVulkanCommandBuffer(),
-			VK_PIPELINE_BIND_POINT_GRAPHICS,
-			pipelineLayout,
-			0,
-			static_cast<uint32_t>(descriptorSets.size()),
-			descriptorSets.data(),
-			0,
-			nullptr);
+		if (bindRecord.VertexPulling)
+		{
+			descriptorSets[setCount++] = static_cast<VulkanVertexBuffer*>(meshAsset.GetVertexBuffer().get())->GetVertexPullingSet();
+		}
 
-		vkCmdBindPipeline(VulkanRenderer::GetVulkanCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		//The recorder drops whatever of this is already bound, typically the global and table sets
+		CommandRecorder::BindDescriptorSets(pipelineData.PipelineLayout, 0, setCount, descriptorSets.data());
+		CommandRecorder::BindPipeline(pipelineData.Pipeline);
+		CommandRecorder::SetRenderState(materialAsset.GetRenderState());
 
+		m_BoundPipelineLayout = pipelineData.PipelineLayout;
+		m_BoundPushConstantRanges = bindRecord.PushConstantRanges;
 	}
 
-	PipelineData VulkanGraphicsPipeline::CreatePipeline(const std::shared_ptr<MaterialAsset>& materialAsset, const VkVertexInputBindingDescription& bindingDescription, const std::vector<VkVertexInputAttributeDescription>& attributeDescription)
+	void VulkanGraphicsPipeline::mPushConstants(const void* data, uint32_t size, uint32_t offset)
+	{
+		if (m_BoundPipelineLayout == VK_NULL_HANDLE)
+		{
+			throw std::runtime_error("push constants require a bound pipeline!");
+		}
+
+		//Stages may declare different parts of the block. The update is split at every range boundary
+		//and each piece is pushed with exactly the stages whose range covers it, bytes no stage reads are dropped.
+		const uint32_t end = offset + size;
+
+		std::array<uint32_t, ShaderStages::Stage_Count * 2 + 2> boundaries;
+		uint32_t boundaryCount = 0;
+		boundaries[boundaryCount++] = offset;
+		boundaries[boundaryCount++] = end;
+
+		for (const auto& range : *m_BoundPushConstantRanges)
+		{
+			if (range.Offset > offset && range.Offset < end) boundaries[boundaryCount++] = range.Offset;
+			if (range.Offset + range.Size > offset && range.Offset + range.Size < end) boundaries[boundaryCount++] = range.Offset + range.Size;
+		}
+
+		std::sort(boundaries.begin(), boundaries.begin() + boundaryCount);
+
+		for (uint32_t i = 0; i + 1 < boundaryCount; i++)
+		{
+			uint32_t pieceBegin = boundaries[i];
+			uint32_t pieceEnd = boundaries[i + 1];
+			if (pieceBegin == pieceEnd)
+				continue;
+
+			ShaderStageBits stages;
+			for (const auto& range : *m_BoundPushConstantRanges)
+			{
+				if (range.Offset <= pieceBegin && range.Offset + range.Size >= pieceEnd)
+					stages |= range.Stages;
+			}
+
+			if (stages.none())
+				continue;
+
+			CommandRecorder::PushConstants(m_BoundPipelineLayout, Utils::MapToVulkanShaderStageFlags(stages),
+				pieceBegin, pieceEnd - pieceBegin, static_cast<const uint8_t*>(data) + (pieceBegin - offset));
+		}
+	}
+
+	VertexLayoutID VulkanGraphicsPipeline::GetPipelineVertexLayout(const std::shared_ptr<MaterialAsset>& materialAsset, const std::shared_ptr<MeshAsset>& meshAsset)
+	{
+		//Pulled vertices are decoded in the shader, every layout shares the same pipeline
+		if (materialAsset->GetShader()->UsesVertexPulling())
+			return InvalidVertexLayoutID;
+
+		return meshAsset->GetVertexBuffer()->GetLayoutID();
+	}
+
+	VkPipelineLayout VulkanGraphicsPipeline::GetPipelineLayout(const std::shared_ptr<MaterialAsset>& materialAsset)
+	{
+		auto vulkanMaterialAsset = std::dynamic_pointer_cast<VulkanMaterialAsset>(materialAsset);
+		const auto& materialDescriptorSetLayouts = vulkanMaterialAsset->GetDescriptorSetLayouts();
+
+		std::vector<VkDescriptorSetLayout> finalDescriptorSetLayouts;
+
+		finalDescriptorSetLayouts.insert(finalDescriptorSetLayouts.end(), m_GlobalDescriptorSetLayouts.begin(), m_GlobalDescriptorSetLayouts.end());
+
+		if (!materialAsset->GetShader()->GetMaterialRecord().empty())
+		{
+			//Shaders and reflection address the table by MATERIAL_TABLE_DESCRIPTOR_SET, it only holds while the global sets come first
+			if (finalDescriptorSetLayouts.size() != MATERIAL_TABLE_DESCRIPTOR_SET)
+			{
+				throw std::runtime_error("material table does not land on MATERIAL_TABLE_DESCRIPTOR_SET!");
+			}
+
+			finalDescriptorSetLayouts.push_back(MaterialTable::GetDescriptorSetLayout());
+		}
+
+		finalDescriptorSetLayouts.insert(finalDescriptorSetLayouts.end(), materialDescriptorSetLayouts.begin(), materialDescriptorSetLayouts.end());
+
+		if (materialAsset->GetShader()->UsesVertexPulling())
+		{
+			if (finalDescriptorSetLayouts.size() != VERTEX_PULLING_DESCRIPTOR_SET)
+			{
+				throw std::runtime_error("vertex pulling shaders must not use the reserved descriptor set!");
+			}
+
+			finalDescriptorSetLayouts.push_back(VertexPulling::GetDescriptorSetLayout());
+		}
+
+		//Materials sharing a shader resolve to the same set layouts and therefore the same pipeline layout
+		return LayoutCache::GetPipelineLayout(finalDescriptorSetLayouts, Utils::GetVkPushConstantRanges(materialAsset->GetShader()->GetPushConstantRanges()));
+	}
+
+	PipelineData VulkanGraphicsPipeline::CreatePipeline(const std::shared_ptr<MaterialAsset>& materialAsset, const RenderState& renderState, VertexLayoutID vertexLayout, ShaderFeatureMask features)
 	{
 		ZoneScoped;
 
-		const auto& config = materialAsset->GetMaterial().config;
 		const auto& shaderAsset = materialAsset->GetShader();
 		const auto& shaderStages = shaderAsset->GetShaderStage();
 
 		std::vector<VkPipelineShaderStageCreateInfo> shaderStageInfos;
+		std::array<SpecializationData, ShaderStages::Stage_Count> specializations;
 
 		for (const auto& [stage, shaderModule] : shaderStages)
 		{
@@ -162,47 +319,23 @@ namespace CHIKU
 			shaderStage.stage = flags; // e.g., VK_SHADER_STAGE_VERTEX_BIT
 			shaderStage.module = shaderModule.ShaderModule;
 			shaderStage.pName = "main";
-			shaderStage.pSpecializationInfo = nullptr;
+			shaderStage.pSpecializationInfo = Utils::GetSpecializationInfo(shaderAsset->GetSpecializationConstants(), stage, features, specializations[stage]);
 
 			shaderStageInfos.push_back(shaderStage);
 		}
 
-		VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-
-		vertexInputInfo.vertexBindingDescriptionCount = 1;
-		vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescription.size());
-		vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-		vertexInputInfo.pVertexAttributeDescriptions = attributeDescription.data();
+		VkPipelineVertexInputStateCreateInfo vertexInputInfo = VulkanVertexBuffer::GetVertexInputState(vertexLayout);
 
-		VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-		inputAssembly.primitiveRestartEnable = VK_FALSE;
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly = Utils::GetInputAssemblyState(renderState);
 
 		VkPipelineViewportStateCreateInfo viewportState{};
 		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 		viewportState.viewportCount = 1;
 		viewportState.scissorCount = 1;
 
-		VkPipelineRasterizationStateCreateInfo rasterizer{};
-		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-		rasterizer.depthClampEnable = VK_FALSE;
-		rasterizer.rasterizerDiscardEnable = VK_FALSE;
-		rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-		rasterizer.lineWidth = 1.0f;
-		rasterizer.cullMode = VK_CULL_MODE_NONE;
-		rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-		rasterizer.depthBiasEnable = VK_FALSE;
-
-		VkPipelineMultisampleStateCreateInfo multisampling{};
-		multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-		multisampling.sampleShadingEnable = VK_FALSE;
-		multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-		VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-		colorBlendAttachment.blendEnable = VK_FALSE;
+		VkPipelineRasterizationStateCreateInfo rasterizer = Utils::GetRasterizationState(renderState);
+		VkPipelineMultisampleStateCreateInfo multisampling = Utils::GetMultisampleState();
+		VkPipelineColorBlendAttachmentState colorBlendAttachment = Utils::GetColorBlendAttachmentState(renderState);
 
 		VkPipelineColorBlendStateCreateInfo colorBlending{};
 		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
@@ -220,43 +353,19 @@ namespace CHIKU
 			VK_DYNAMIC_STATE_SCISSOR
 		};
 
+		//Without extended dynamic state support nothing is appended and the
+		//render state above stays baked into the pipeline
+		DynamicState::GetPipelineDynamicStates(dynamicStates);
+
 		VkPipelineDynamicStateCreateInfo dynamicState{};
 		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 		dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
 		dynamicState.pDynamicStates = dynamicStates.data();
 
 
-		auto vulkanMaterialAsset = std::dynamic_pointer_cast<VulkanMaterialAsset>(materialAsset);
-		const auto& materialDescriptorSetLayouts = vulkanMaterialAsset->GetDescriptorSetLayouts();
+		VkPipelineLayout pipelineLayout = GetPipelineLayout(materialAsset);
 
-		std::vector<VkDescriptorSetLayout> finalDescriptorSetLayouts;
-
-		finalDescriptorSetLayouts.insert(finalDescriptorSetLayouts.end(), m_GlobalDescriptorSetLayouts.begin(), m_GlobalDescriptorSetLayouts.end());
-		finalDescriptorSetLayouts.insert(finalDescriptorSetLayouts.end(), materialDescriptorSetLayouts.begin(), materialDescriptorSetLayouts.end());
-
-		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(finalDescriptorSetLayouts.size());
-		pipelineLayoutInfo.pSetLayouts = finalDescriptorSetLayouts.data();
-
-		VkPipelineLayout pipelineLayout;
-
-		if (vkCreatePipelineLayout(VulkanRenderer::GetVulkanDevice(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
-		{
-			throw std::runtime_error("failed to create pipeline layout!");
-		}
-
-		VkPipelineDepthStencilStateCreateInfo depthStencil{};
-		depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-		depthStencil.depthTestEnable = config.depthTest;
-		depthStencil.depthWriteEnable = config.depthWrite;
-		depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-		depthStencil.depthBoundsTestEnable = VK_FALSE;
-		depthStencil.minDepthBounds = 0.0f; // Optional
-		depthStencil.maxDepthBounds = 1.0f; // Optional
-		depthStencil.stencilTestEnable = VK_FALSE;
-		depthStencil.front = {}; // Optional
-		depthStencil.back = {}; // Optional
+		VkPipelineDepthStencilStateCreateInfo depthStencil = Utils::GetDepthStencilState(renderState);
 
 		VkGraphicsPipelineCreateInfo pipelineInfo{};
 		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -292,9 +401,7 @@ namespace CHIKU
 		const std::shared_ptr<MeshAsset>& meshAsset) 
 	{
 
-		const std::shared_ptr<VertexBuffer>& vertexBuffer = meshAsset->GetVertexBuffer();
-		std::shared_ptr<VulkanVertexBuffer> vulkanVB = std::dynamic_pointer_cast<VulkanVertexBuffer>(vertexBuffer);
-
-		return CreatePipeline(materialAsset, vulkanVB->GetBindingDescription(), vulkanVB->GetAttributeDescriptions());
+		ShaderFeatureMask features = materialAsset->GetFeatures() & materialAsset->GetShader()->GetFeatureMask();
+		return CreatePipeline(materialAsset, DynamicState::GetPipelineRenderState(materialAsset->GetRenderState()), GetPipelineVertexLayout(materialAsset, meshAsset), features);
 	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <Renderer/GraphicsPipeline.h>
+#include "PipelineLibrary.h"
 
 namespace CHIKU
 {
@@ -9,6 +10,7 @@ namespace CHIKU
 	public:
 		virtual void mInit() override;
 		virtual void mCleanUp() override;
+		virtual void mUpdate() override;
 
 		virtual PipelineData mGetPipeline(
 			const std::shared_ptr<MaterialAsset>& materialAsset,
@@ -18,17 +20,28 @@ namespace CHIKU
 			const std::shared_ptr<MaterialAsset>& materialAsset,
 			const std::shared_ptr<MeshAsset>& meshAsset) override;
 
-		virtual void mBindPipeline(
-			const std::shared_ptr<MaterialAsset>& materialAsset,
-			const std::shared_ptr<MeshAsset>& meshAsset) override;
+		virtual void mBindPipeline(uint32_t pipelineID, const MaterialAsset& materialAsset, const MeshAsset& meshAsset) override;
+
+		virtual void mPushConstants(const void* data, uint32_t size, uint32_t offset) override;
 
 		PipelineData CreatePipeline(
 			const std::shared_ptr<MaterialAsset>& materialAsset, 
-			const VkVertexInputBindingDescription& bindingDescription, 
-			const std::vector<VkVertexInputAttributeDescription>& attributeDescription);
+			const RenderState& renderState,
+			VertexLayoutID vertexLayout,
+			ShaderFeatureMask features);
+
+	private:
+		VertexLayoutID GetPipelineVertexLayout(const std::shared_ptr<MaterialAsset>& materialAsset, const std::shared_ptr<MeshAsset>& meshAsset);
+		VkPipelineLayout GetPipelineLayout(const std::shared_ptr<MaterialAsset>& materialAsset);
 
 	private:
-		std::unordered_map<PipelineKey, PipelineData> m_Pipelines;
+		std::unordered_map<PipelineKey, uint32_t> m_Pipelines; //Value is the index into m_PipelineData
+		std::vector<PipelineData> m_PipelineData; //Indexed by PipelineData::ID
+		std::vector<OptimizedPipeline> m_OptimizedPipelines;
+		std::deque<std::pair<uint64_t, VkPipeline>> m_RetiredPipelines; //Frame it was retired on, destroyed once no frame in flight can use it
+		uint64_t m_FrameNumber = 0;
+		VkPipelineLayout m_BoundPipelineLayout = VK_NULL_HANDLE;
+		const PushConstantDescription* m_BoundPushConstantRanges = nullptr;
 		std::array<VkDescriptorSetLayout, DEFAULT_DESCRIPTOR_SET_LAYOUT_BINDING_COUNT> m_GlobalDescriptorSetLayouts; //Key is the set Index>
 		std::array<std::array<VkDescriptorSet, DEFAULT_DESCRIPTOR_SET_LAYOUT_BINDING_COUNT>, MAX_FRAMES_IN_FLIGHT> m_GlobalDescriptorSetsChache;
 	};
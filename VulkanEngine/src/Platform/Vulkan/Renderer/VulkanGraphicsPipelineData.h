@@ -7,5 +7,6 @@ namespace CHIKU
 	{
 		VkPipeline Pipeline;
 		VkPipelineLayout PipelineLayout;
+		uint32_t ID = 0; //Dense and stable for the lifetime of the key, used to sort draws by pipeline
 	};
 }
\ No newline at end of file
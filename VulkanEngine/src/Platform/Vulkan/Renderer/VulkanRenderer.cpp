@@ -1,5 +1,11 @@
 #include "VulkanRenderer.h"
 #include "DescriptorPool.h"
+#include "LayoutCache.h"
+#include "DynamicState.h"
+#include "PipelineLibrary.h"
+#include "VertexPulling.h"
+#include "MaterialTable.h"
+#include "CommandRecorder.h"
 #include <Vulkan/Buffer/VulkanUniformBuffer.h>
 #include <Vulkan/Buffer/VulkanVertexBuffer.h>
 #include <Vulkan/Buffer/VulkanIndexBuffer.h>
@@ -65,6 +71,8 @@ namespace CHIKU
 
 		m_Commands.Init(m_GraphicsQueue, m_LogicalDevice, m_PhysicalDevice, m_Surface);
 		m_Swapchain.Init(m_Window, m_PhysicalDevice, m_LogicalDevice, m_Surface);
+		VertexPulling::Init();
+		MaterialTable::Init();
 		CreateGraphicsBinding();
 	}
 
@@ -85,6 +93,9 @@ namespace CHIKU
 
 		vkDeviceWaitIdle(m_LogicalDevice);  // Or vkQueueWaitIdle(queue)
 
+		VertexPulling::CleanUp();
+		MaterialTable::CleanUp();
+		LayoutCache::CleanUp();
 		DescriptorPool::CleanUp();
 		m_Commands.CleanUp();
 		m_Swapchain.CleanUp();
@@ -191,12 +202,14 @@ namespace CHIKU
 		}
 
 		m_Swapchain.BeginRenderPass(commandBuffer, m_ImageIndex);
+		CommandRecorder::Begin(commandBuffer);
 	}
 
 	void VulkanRenderer::EndRecordingCommands(const VkCommandBuffer& commandBuffer)
 	{
 		ZoneScoped;
 
+		CommandRecorder::End();
 		m_Swapchain.EndRenderPass(commandBuffer);
 
 		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
@@ -506,12 +519,15 @@ namespace CHIKU
 			}
 		}
 
+		void* deviceFeatureChain = DynamicState::QuerySupport(m_PhysicalDevice, deviceExtensionProperties, activeDeviceExtensions, nullptr);
+		deviceFeatureChain = PipelineLibrary::QuerySupport(m_PhysicalDevice, deviceExtensionProperties, activeDeviceExtensions, deviceFeatureChain);
+
 		VkPhysicalDeviceFeatures features;
 		vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &features);
 
 		VkDeviceCreateInfo deviceCI;
 		deviceCI.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-		deviceCI.pNext = nullptr;
+		deviceCI.pNext = deviceFeatureChain;
 		deviceCI.flags = 0;
 		deviceCI.queueCreateInfoCount = static_cast<uint32_t>(deviceQueueCIs.size());
 		deviceCI.pQueueCreateInfos = deviceQueueCIs.data();
@@ -522,6 +538,8 @@ namespace CHIKU
 		deviceCI.pEnabledFeatures = &features;
 		VULKAN_CHECK(vkCreateDevice(m_PhysicalDevice, &deviceCI, nullptr, &m_LogicalDevice), "Failed to create Device.");
 
+		DynamicState::LoadFunctions(m_LogicalDevice);
+
 	}
 
 	void VulkanRenderer::CreateSyncObjects()
@@ -51,6 +51,85 @@ namespace CHIKU
 			vkBindBufferMemory(VulkanRenderer::GetVulkanDevice(), buffer, bufferMemory, 0);
 		}
 
+		void UploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size)
+		{
+			ZoneScoped;
+
+			UploadBatch* batch = UploadBatch::GetCurrent();
+			if (batch && batch->Upload(dstBuffer, data, size))
+				return;
+
+			VkBuffer stagingBuffer;
+			VkDeviceMemory stagingBufferMemory;
+			CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+			void* mapped;
+			vkMapMemory(VulkanRenderer::GetVulkanDevice(), stagingBufferMemory, 0, size, 0, &mapped);
+			memcpy(mapped, data, (size_t)size);
+			vkUnmapMemory(VulkanRenderer::GetVulkanDevice(), stagingBufferMemory);
+
+			CopyBuffer(stagingBuffer, dstBuffer, size);
+
+			vkDestroyBuffer(VulkanRenderer::GetVulkanDevice(), stagingBuffer, nullptr);
+			vkFreeMemory(VulkanRenderer::GetVulkanDevice(), stagingBufferMemory, nullptr);
+		}
+
+		thread_local UploadBatch* UploadBatch::s_Current = nullptr;
+
+		UploadBatch::UploadBatch(VkDeviceSize stagingSize) : m_Size(stagingSize), m_Previous(s_Current)
+		{
+			ZoneScoped;
+
+			s_Current = this;
+			if (m_Size == 0)
+				return;
+
+			CreateBuffer(m_Size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_StagingBuffer, m_StagingBufferMemory);
+
+			void* mapped;
+			vkMapMemory(VulkanRenderer::GetVulkanDevice(), m_StagingBufferMemory, 0, m_Size, 0, &mapped);
+			m_Mapped = static_cast<uint8_t*>(mapped);
+		}
+
+		UploadBatch::~UploadBatch()
+		{
+			ZoneScoped;
+
+			s_Current = m_Previous;
+			if (m_StagingBuffer == VK_NULL_HANDLE)
+				return;
+
+			//Every copy recorded so far goes out in one submit, the staging buffer is free once it finished
+			if (m_CommandBuffer != VK_NULL_HANDLE)
+				VulkanRenderer::EndRecordingSingleTimeCommands(m_CommandBuffer);
+
+			vkUnmapMemory(VulkanRenderer::GetVulkanDevice(), m_StagingBufferMemory);
+			vkDestroyBuffer(VulkanRenderer::GetVulkanDevice(), m_StagingBuffer, nullptr);
+			vkFreeMemory(VulkanRenderer::GetVulkanDevice(), m_StagingBufferMemory, nullptr);
+		}
+
+		bool UploadBatch::Upload(VkBuffer dstBuffer, const void* data, VkDeviceSize size)
+		{
+			ZoneScoped;
+
+			if (m_Mapped == nullptr || size > m_Size - m_Used)
+				return false;
+
+			if (m_CommandBuffer == VK_NULL_HANDLE)
+				m_CommandBuffer = VulkanRenderer::BeginRecordingSingleTimeCommands();
+
+			memcpy(m_Mapped + m_Used, data, (size_t)size);
+
+			VkBufferCopy copyRegion{};
+			copyRegion.srcOffset = m_Used;
+			copyRegion.dstOffset = 0;
+			copyRegion.size = size;
+			vkCmdCopyBuffer(m_CommandBuffer, m_StagingBuffer, dstBuffer, 1, &copyRegion);
+
+			m_Used += size;
+			return true;
+		}
+
         size_t GetAttributeSize(const VertexComponentType& componentType, const VertexAttributeType& type)
         {
             ZoneScoped;
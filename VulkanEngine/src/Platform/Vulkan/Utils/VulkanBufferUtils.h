@@ -8,6 +8,35 @@ namespace CHIKU
 	{
 		void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
 		void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+		//Fills a device local buffer through a staging buffer, part of the calling thread's UploadBatch when one is open
+		void UploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size);
+
+		//Uploads made on this thread while the batch is alive share one staging buffer and one submit,
+		//instead of every buffer waiting on the queue by itself. Batches nest, the innermost one collects the uploads
+		class UploadBatch
+		{
+		public:
+			UploadBatch(VkDeviceSize stagingSize);
+			~UploadBatch();
+
+			UploadBatch(const UploadBatch&) = delete;
+			UploadBatch& operator=(const UploadBatch&) = delete;
+
+			//False when the staging buffer has no room left, the caller uploads on its own
+			bool Upload(VkBuffer dstBuffer, const void* data, VkDeviceSize size);
+			static UploadBatch* GetCurrent() { return s_Current; }
+
+		private:
+			VkBuffer m_StagingBuffer = VK_NULL_HANDLE;
+			VkDeviceMemory m_StagingBufferMemory = VK_NULL_HANDLE;
+			uint8_t* m_Mapped = nullptr;
+			VkDeviceSize m_Size = 0;
+			VkDeviceSize m_Used = 0;
+			VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+			UploadBatch* m_Previous = nullptr;
+
+			static thread_local UploadBatch* s_Current;
+		};
         
         size_t GetAttributeSize(const VertexComponentType& componentType,const VertexAttributeType& type);
         void FinalizeLayout(VertexBufferLayout& layout);
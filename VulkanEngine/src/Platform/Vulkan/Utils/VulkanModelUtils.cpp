@@ -2,9 +2,15 @@
 #include "VulkanBufferUtils.h"
 #include "Assets/AssetManager.h"
 #include "Assets/ShaderAsset.h"
+#include "Assets/MaterialAsset.h"
+#include "Renderer/Buffer/VertexLayoutRegistry.h"
+#include "Memory/Memory.h"
+#include "IO/FileSystem.h"
+#include "Jobs/JobSystem.h"
+#include "Utils/Utils.h"
+#include <nlohmann/json.hpp>
 #include <fstream>
 #include <iostream>
-#include <nlohmann/json.hpp>
 
 namespace CHIKU
 {
@@ -19,22 +25,25 @@ namespace CHIKU
             {
                 attr.Offset = offset;
                 attr.size = static_cast<uint32_t>(GetAttributeSize(attr.ComponentType, attr.AttributeType));
+                if (attr.SourceStride == 0)
+                    attr.SourceStride = attr.size;
                 offset += attr.size;
             }
             layout.Stride = offset;
         }
 
-        std::vector<uint32_t> CreateIndices(const tinygltf::Model& model, const tinygltf::Primitive& primitive)
+        bool CreateIndices(const tinygltf::Model& model, const GLTFBuffers& buffers, const tinygltf::Primitive& primitive, std::span<uint32_t> outIndices, size_t vertexCount)
         {
-			std::vector<uint32_t> indices;
+            ZoneScoped;
+
             const tinygltf::Accessor& indexAccessor = model.accessors[primitive.indices];
             const tinygltf::BufferView& bufferView = model.bufferViews[indexAccessor.bufferView];
-            const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
 
             const size_t byteOffset = bufferView.byteOffset + indexAccessor.byteOffset;
-            const unsigned char* dataPtr = buffer.data.data() + byteOffset;
+            const unsigned char* dataPtr = buffers.Get(bufferView.buffer).data() + byteOffset;
+            const size_t count = std::min<size_t>(indexAccessor.count, outIndices.size());
 
-            for (size_t i = 0; i < indexAccessor.count; ++i)
+            for (size_t i = 0; i < count; ++i)
             {
                 uint32_t index = 0;
 
@@ -51,15 +60,18 @@ namespace CHIKU
                     break;
                 default:
                     std::cerr << "Unsupported index component type!" << std::endl;
-                    break;
+                    return false;
                 }
 
                 //std::cout << "Index[" << i << "] = " << index << std::endl;
 
-				indices.push_back(index);
+                if (index >= vertexCount)
+                    return false;
+
+                outIndices[i] = index;
             }
 
-			return indices;
+            return true;
         }
 
         std::string SelectShaderFromMaterial(const tinygltf::Material& mat)
@@ -71,182 +83,352 @@ namespace CHIKU
                 return SHADER_LIT;
             }
 
-            // 2. Check alphaMode for transparency
+            // 2. Alpha mode, textures and vertex colors no longer pick a shader,
+            //    they are specialization constants of the lit shader (see GetMaterialFeatures)
+            return SHADER_DEFAULT_LIT;
+        }
+
+        ShaderFeatureMask GetMaterialFeatures(int index, const tinygltf::Model& model, const tinygltf::Material& mat)
+        {
+            ZoneScoped;
+
+            ShaderFeatureMask features = 0;
+
             std::string alphaMode = mat.alphaMode; // May be empty
             std::transform(alphaMode.begin(), alphaMode.end(), alphaMode.begin(), ::toupper);
 
-            if (alphaMode == "BLEND") {
-                return SHADER_TRANSPARENT_PBR;
-            }
-            else if (alphaMode == "MASK") {
-                return SHADER_MASKED_PBR;
-            }
+            //Normal map, emissive and vertex color stay off until the shaders read them, setting them would only
+            //split pipelines that run the same code
+            if (alphaMode == "MASK")
+                features |= 1u << Feature_AlphaMask;
+
+            return features;
+        }
+
+        Material ImportMaterial(int index, const tinygltf::Model& model, const tinygltf::Material& mat)
+        {
+            ZoneScoped;
 
-            // 3. Check for PBR-related textures
-            const auto& pbr = mat.pbrMetallicRoughness;
-            bool hasBaseColor = pbr.baseColorTexture.index >= 0;
-            bool hasMetalRough = pbr.metallicRoughnessTexture.index >= 0;
-            bool hasNormalMap = mat.normalTexture.index >= 0;
-            bool hasEmissive = mat.emissiveTexture.index >= 0;
+            Material material;
+            material.name = mat.name.empty() ? "Material" + std::to_string(index) : mat.name;
+            material.shader = SelectShaderFromMaterial(mat); // Decide shader based on presence of textures, etc.
 
-            if (hasBaseColor || hasMetalRough || hasNormalMap || hasEmissive) {
-                return SHADER_PBR;
+            std::string alphaMode = mat.alphaMode;
+            std::transform(alphaMode.begin(), alphaMode.end(), alphaMode.begin(), ::toupper);
+            bool blend = alphaMode == "BLEND";
+
+            // Hardcoded render state, blending is render state rather than a shader variant
+            material.state.Cull = CullMode::Back;
+            material.state.Front = FrontFace::CounterClockwise;
+            material.state.Polygon = PolygonMode::Fill;
+            material.state.Topology = PrimitiveTopology::TriangleList;
+            material.state.DepthTest = true;
+            material.state.DepthWrite = !blend;
+            material.state.BlendEnabled = blend;
+
+            material.features = GetMaterialFeatures(index, model, mat);
+
+            const auto& color = mat.pbrMetallicRoughness.baseColorFactor;
+            if (color.size() == 4)
+            {
+                material.config.baseColor = glm::vec4(color[0], color[1], color[2], color[3]);
             }
 
-            // 4. Fallback
-            return SHADER_DEFAULT_LIT;
+            material.config.alphaCutoff = static_cast<float>(mat.alphaCutoff);
+
+            return material;
         }
 
-        AssetHandle CreateMaterials(int index,const tinygltf::Model& model, const tinygltf::Material& mat, const AssetPath& outputPath)
+        AssetHandle CreateMaterials(int index, const tinygltf::Model& model, const tinygltf::Material& mat, const AssetPath& name)
         {
             ZoneScoped;
 
-            nlohmann::json materialJson;
-            materialJson["name"] = mat.name.empty() ? "Material" + std::to_string(index) : mat.name;
-            materialJson["shader"] = SelectShaderFromMaterial(mat); // Decide shader based on presence of textures, etc.
+            //Built in memory and registered directly, the cooked form for loads by path is written by the asset cooker
+            return AssetManager::AddMaterial(name, ImportMaterial(index, model, mat));
+        }
 
-            // Hardcoded render config
-            nlohmann::json config;
-            config["depthTest"] = true;
-            config["depthWrite"] = true;
-            config["blendEnabled"] = false;
-            config["cullMode"] = "VK_CULL_MODE_BACK_BIT";
-            config["frontFace"] = "VK_FRONT_FACE_COUNTER_CLOCKWISE";
-            config["polygonMode"] = "VK_POLYGON_MODE_FILL";
-            config["topology"] = "VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST";
-            materialJson["Config"] = config;
 
-            // Add material factors
-            if (mat.values.contains("baseColorFactor"))
+        static MeshBounds ComputeBounds(const tinygltf::Accessor& accessor, const GLTFVertexAttribute& position)
+        {
+            ZoneScoped;
+
+            MeshBounds bounds;
+
+            //glTF requires min and max on positions, only broken exporters make us scan the data
+            if (accessor.minValues.size() >= 3 && accessor.maxValues.size() >= 3)
             {
-                const auto& color = mat.values.at("baseColorFactor").ColorFactor();
-                materialJson["baseColorFactor"] = { color[0], color[1], color[2], color[3] };
+                bounds.Min = glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]);
+                bounds.Max = glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2]);
+                return bounds;
             }
 
-            if (mat.values.contains("metallicFactor"))
-                materialJson["metallicFactor"] = mat.values.at("metallicFactor").Factor();
+            if (accessor.count == 0 || position.ComponentType != VertexComponentType::Float || position.AttributeType != VertexAttributeType::Vec3)
+            {
+                LOG_WARN("Positions have no min/max and are not float vec3, the mesh has no bounds and is never culled");
+                return bounds;
+            }
 
-            if (mat.values.contains("roughnessFactor"))
-                materialJson["roughnessFactor"] = mat.values.at("roughnessFactor").Factor();
+            for (size_t i = 0; i < accessor.count; i++)
+            {
+                glm::vec3 value;
+                std::memcpy(&value, position.Data + i * position.SourceStride, sizeof(value));
+                bounds.Min = glm::min(bounds.Min, value);
+                bounds.Max = glm::max(bounds.Max, value);
+            }
 
-            // Textures section
-            nlohmann::json textures;
+            return bounds;
+        }
 
-            auto setTextureIfValid = [&](const char* name, const tinygltf::Parameter& param) {
-                if (param.TextureIndex() >= 0)
-                {
-                    int texIndex = param.TextureIndex();
-                    if (texIndex >= 0 && texIndex < model.textures.size())
-                    {
-                        int imageIndex = model.textures[texIndex].source;
-                        if (imageIndex >= 0 && imageIndex < model.images.size())
-                            textures[name] = model.images[imageIndex].uri;
-                    }
-                }
-                };
+        //Buffers are read without a copy in between, an accessor reaching past its buffer would read past the mapping
+        static bool AccessorFits(const tinygltf::Model& model, const GLTFBuffers& buffers, int accessorIndex)
+        {
+            if (accessorIndex < 0 || accessorIndex >= model.accessors.size())
+                return false;
 
-            if (mat.values.contains("baseColorTexture"))
-                setTextureIfValid("albedo", mat.values.at("baseColorTexture"));
+            const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+            if (accessor.bufferView < 0 || accessor.bufferView >= model.bufferViews.size())
+                return false;
 
-            if (mat.values.contains("metallicRoughnessTexture"))
-                setTextureIfValid("metallicRoughness", mat.values.at("metallicRoughnessTexture"));
+            const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
+            int elementSize = tinygltf::GetComponentSizeInBytes(accessor.componentType) * tinygltf::GetNumComponentsInType(accessor.type);
+            int stride = accessor.ByteStride(bufferView);
+            if (elementSize <= 0 || stride <= 0)
+                return false;
 
-            if (mat.additionalValues.contains("normalTexture"))
-                setTextureIfValid("normal", mat.additionalValues.at("normalTexture"));
+            size_t end = bufferView.byteOffset + accessor.byteOffset;
+            if (accessor.count > 0)
+                end += (accessor.count - 1) * stride + elementSize;
 
-            if (mat.additionalValues.contains("emissiveTexture"))
-                setTextureIfValid("emissive", mat.additionalValues.at("emissiveTexture"));
+            return end <= buffers.Get(bufferView.buffer).size();
+        }
 
-            if (mat.additionalValues.contains("occlusionTexture"))
-                setTextureIfValid("occlusion", mat.additionalValues.at("occlusionTexture"));
+        //Everything about a primitive except its data, enough to know how much storage it needs
+        static bool MeasurePrimitive(const tinygltf::Model& model, const GLTFBuffers& buffers, const tinygltf::Primitive& primitive, ImportedModelPrimitive& out)
+        {
+            ZoneScoped;
 
-            if (!textures.empty())
-                materialJson["Textures"] = textures;
+            auto it = primitive.attributes.find(std::string(VertexAttributesArray[0])); // POSITION
+            if (it == primitive.attributes.end())
+            {
+                return false;
+            }
 
-            // Write to disk
-            std::string fileName = materialJson["name"].get<std::string>() + ".json";
-            std::string outputPathStr = outputPath + "/" + fileName;
+            if (primitive.indices >= 0 && !AccessorFits(model, buffers, primitive.indices))
+            {
+                return false;
+            }
 
-            std::ofstream file(SOURCE_DIR + outputPathStr);
-            if (!file.is_open())
+            //Every attribute is read for as many vertices as POSITION has, a shorter one would be read past its end
+            for (auto& attrname : VertexAttributesArray)
             {
-                throw std::runtime_error("Failed to write material file: " + outputPathStr);
-                return {};
+                auto attribute = primitive.attributes.find(std::string(attrname));
+                if (attribute != primitive.attributes.end() && (!AccessorFits(model, buffers, attribute->second) ||
+                    model.accessors[attribute->second].count != model.accessors[it->second].count))
+                {
+                    return false;
+                }
             }
 
-            file << materialJson.dump(4);
-            file.close();
+            out.IndexCount = primitive.indices >= 0 ? model.accessors[primitive.indices].count : 0;
+
+            out.Layout.Count = model.accessors[it->second].count;
+            out.Layout.Layout = CreateBufferLayout(model, buffers, primitive);
+            FinalizeLayout(out.Layout.Layout);
+            out.MetaData = ConvertGLTFInfoToVertexInfo(out.Layout);
 
-            return AssetManager::AddMaterial(outputPathStr);
+            //POSITION is the first attribute the layout looks for
+            out.Bounds = ComputeBounds(model.accessors[it->second], out.Layout.Layout.VertexElements[0]);
+            return true;
         }
 
+        bool ImportPrimitive(const tinygltf::Model& model, const GLTFBuffers& buffers, const tinygltf::Primitive& primitive, ScratchScope& scratch, ImportedPrimitive& out)
+        {
+            ZoneScoped;
+
+            ImportedModelPrimitive measured;
+            if (!MeasurePrimitive(model, buffers, primitive, measured))
+            {
+                return false;
+            }
+
+            out.Indices = {};
+            if (measured.IndexCount > 0)
+            {
+                out.Indices = { scratch.Allocate<uint32_t>(measured.IndexCount), measured.IndexCount };
+                if (!CreateIndices(model, buffers, primitive, out.Indices, measured.Layout.Count))
+                {
+                    return false;
+                }
+            }
+
+            size_t dataSize = measured.GetVertexSize();
+            out.Vertices = { scratch.Allocate<uint8_t>(dataSize), dataSize };
+            out.MetaData = measured.MetaData;
 
-        bool ProcessModel(const tinygltf::Model& model, std::unordered_map<AssetHandle, AssetHandle>& meshMaterial)
+            //Utils::PrintVertexData(out.Vertices, measured.Layout); // Print vertex data for debugging
+            return CreateVertexData(measured.Layout, out.Vertices); // fill the data vector with vertex data
+        }
+
+        bool ImportModel(const tinygltf::Model& model, const GLTFBuffers& buffers, ImportedModel& out)
         {
             ZoneScoped;
-            GLTFVertexBufferMetaData layout;
-            AssetHandle materialHandle{};
-            AssetHandle meshHandle;
-            std::vector<uint8_t> data;
 
-            std::unordered_map<int, AssetHandle> materialCache;
+            out.Primitives.clear();
+            for (size_t meshIndex = 0; meshIndex < model.meshes.size(); meshIndex++)
+            {
+                const auto& mesh = model.meshes[meshIndex];
+                for (size_t primitiveIndex = 0; primitiveIndex < mesh.primitives.size(); primitiveIndex++)
+                {
+                    const auto& primitive = mesh.primitives[primitiveIndex];
+                    if (!primitive.attributes.contains(std::string(VertexAttributesArray[0]))) // POSITION
+                        continue;
+
+                    ImportedModelPrimitive& imported = out.Primitives.emplace_back();
+                    imported.MeshIndex = static_cast<uint32_t>(meshIndex);
+                    imported.PrimitiveIndex = static_cast<uint32_t>(primitiveIndex);
+                    imported.MaterialIndex = primitive.material;
+                }
+            }
 
-            bool success = true;
+            auto getPrimitive = [&](const ImportedModelPrimitive& imported) -> const tinygltf::Primitive&
+                {
+                    return model.meshes[imported.MeshIndex].primitives[imported.PrimitiveIndex];
+                };
+
+            //Layouts, counts and bounds first, after that every primitive knows where its slice of the shared storage starts
+            JobSystem::Dispatch(static_cast<uint32_t>(out.Primitives.size()), [&](uint32_t index)
+                {
+                    ImportedModelPrimitive& imported = out.Primitives[index];
+                    imported.Valid = MeasurePrimitive(model, buffers, getPrimitive(imported), imported);
+                }, JobPriority::Background);
 
-            for (const auto& node : model.meshes)
+            //Large primitives are split so one scanned mesh does not leave every other worker idle
+            constexpr uint64_t VerticesPerJob = 64 * 1024;
+            struct FillJob
             {
-                //if (node.mesh < 0)
-                //{
-                //    continue;
-                //}
+                uint32_t Primitive;
+                uint64_t FirstVertex;
+                uint64_t VertexCount;
+            };
+            std::vector<FillJob> jobs;
+
+            size_t vertexSize = 0;
+            size_t indexCount = 0;
+            for (uint32_t i = 0; i < out.Primitives.size(); i++)
+            {
+                ImportedModelPrimitive& imported = out.Primitives[i];
+                if (!imported.Valid)
+                    continue;
 
-                for (const auto& primitive : node.primitives)
+                imported.VertexOffset = vertexSize;
+                imported.IndexOffset = indexCount;
+                vertexSize += imported.GetVertexSize();
+                indexCount += imported.IndexCount;
+
+                //The first job of a primitive converts its indices as well
+                uint64_t first = 0;
+                do
                 {
-                    int materialIndex = primitive.material;
+                    uint64_t count = std::min<uint64_t>(VerticesPerJob, imported.Layout.Count - first);
+                    jobs.push_back({ i, first, count });
+                    first += count;
+                } while (first < imported.Layout.Count);
+            }
 
-                    if (materialIndex >= 0 && materialIndex < model.materials.size()) 
-                    {
-                        if (materialCache.find(materialIndex) == materialCache.end()) 
-                        {
-                            materialCache[materialIndex] = CreateMaterials(materialIndex, model, model.materials[materialIndex], "Materials/");
-                        }
-                        materialHandle = materialCache[materialIndex];
-                    }
-                    auto it = primitive.attributes.find(std::string(VertexAttributesArray[0])); // POSITION
-                    if (it == primitive.attributes.end()) continue;
+            //Sized once up front, the jobs only ever write into their own slices
+            out.Vertices.resize(vertexSize);
+            out.Indices.resize(indexCount);
 
-                    std::vector<uint32_t> indices;
-                    if (primitive.indices >= 0)
+            std::vector<uint8_t> jobResults(jobs.size(), 1);
+            JobSystem::Dispatch(static_cast<uint32_t>(jobs.size()), [&](uint32_t index)
+                {
+                    const FillJob& job = jobs[index];
+                    const ImportedModelPrimitive& imported = out.Primitives[job.Primitive];
+                    if (!imported.Valid)
+                        return;
+
+                    bool indicesValid = true;
+                    if (job.FirstVertex == 0 && imported.IndexCount > 0)
                     {
-                        indices = CreateIndices(model, primitive);
+                        indicesValid = CreateIndices(model, buffers, getPrimitive(imported), { out.Indices.data() + imported.IndexOffset, imported.IndexCount }, imported.Layout.Count);
                     }
 
-                    layout.Count = model.accessors[it->second].count;
-                    layout.Layout = CreateBufferLayout(model, primitive);
-                    FinalizeLayout(layout.Layout);
-                    
-                    if (!CreateVertexData(layout, data)) // fill the data vector with vertex data
+                    GLTFVertexBufferMetaData range = imported.Layout;
+                    range.Count = job.VertexCount;
+                    for (auto& attrib : range.Layout.VertexElements)
                     {
-                        success = false;
+                        attrib.Data += job.FirstVertex * attrib.SourceStride;
                     }
-					//Utils::PrintVertexData(data, layout); // Print vertex data for debugging
 
-                    meshHandle = AssetManager::AddMesh(Utils::ConvertGLTFInfoToVertexInfo(layout), data, indices); // add the mesh to the asset manager   
+                    std::span<uint8_t> vertices(out.Vertices.data() + imported.VertexOffset + job.FirstVertex * range.Layout.Stride, job.VertexCount * range.Layout.Stride);
+                    jobResults[index] = indicesValid && CreateVertexData(range, vertices);
+                }, JobPriority::Background);
+
+            for (size_t i = 0; i < jobs.size(); i++)
+            {
+                if (!jobResults[i])
+                    out.Primitives[jobs[i].Primitive].Valid = false;
+            }
 
-                    data.clear();
-                    data.shrink_to_fit();
-                    meshMaterial[meshHandle] = materialHandle;
+            bool success = true;
+            for (const auto& imported : out.Primitives)
+            {
+                if (!imported.Valid)
+                {
+                    LOG_WARN("Primitive " + std::to_string(imported.PrimitiveIndex) + " of mesh " + model.meshes[imported.MeshIndex].name + " does not import");
+                    success = false;
                 }
+            }
 
-                if (!success)
-                    break;
+            return success;
+        }
+
+        bool ProcessModel(const tinygltf::Model& model, const ImportedModel& imported, const AssetPath& sourcePath, std::unordered_map<AssetHandle, AssetHandle>& meshMaterial)
+        {
+            ZoneScoped;
+
+            //Materials first, so their own uploads never take room in the mesh batch
+            std::unordered_map<int, AssetHandle> materialCache;
+            for (const auto& primitive : imported.Primitives)
+            {
+                int materialIndex = primitive.MaterialIndex;
+                if (materialIndex >= 0 && materialIndex < model.materials.size() && !materialCache.contains(materialIndex))
+                {
+                    materialCache[materialIndex] = CreateMaterials(materialIndex, model, model.materials[materialIndex],
+                        sourcePath + "#material" + std::to_string(materialIndex));
+                }
+            }
+
+            //One staging buffer and one submit for every mesh of the model, submitted when the batch goes out of scope
+            UploadBatch batch(imported.Vertices.size() + imported.Indices.size() * sizeof(uint32_t));
+
+            AssetHandle materialHandle{};
+            bool success = true;
+            for (const auto& primitive : imported.Primitives)
+            {
+                auto it = materialCache.find(primitive.MaterialIndex);
+                if (it != materialCache.end())
+                {
+                    materialHandle = it->second;
+                }
+
+                if (!primitive.Valid)
+                {
+                    success = false;
+                    continue;
+                }
+
+                MeshSource source{ sourcePath, primitive.MeshIndex, primitive.PrimitiveIndex };
+                AssetHandle meshHandle = AssetManager::AddMesh(source, primitive.MetaData, imported.GetVertices(primitive), imported.GetIndices(primitive), primitive.Bounds);
+
+                meshMaterial[meshHandle] = materialHandle;
             }
 
             return success;
         }
 
 
-        GLTFVertexBufferLayout CreateBufferLayout(const tinygltf::Model& model, const tinygltf::Primitive& primitive)
+        GLTFVertexBufferLayout CreateBufferLayout(const tinygltf::Model& model, const GLTFBuffers& buffers, const tinygltf::Primitive& primitive)
         {
             ZoneScoped;
 
@@ -271,8 +453,9 @@ namespace CHIKU
 
                 const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
                 const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
-                const auto& buffer = model.buffers[bufferView.buffer];
-                vertexElements.Data = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
+                vertexElements.Data = buffers.Get(bufferView.buffer).data() + bufferView.byteOffset + accessor.byteOffset;
+                int byteStride = accessor.ByteStride(bufferView);
+                vertexElements.SourceStride = byteStride > 0 ? static_cast<uint32_t>(byteStride) : 0;
 
                 if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT)
                 {
@@ -318,14 +501,17 @@ namespace CHIKU
                 i++;
             }
 
+            //Attributes the engine does not know about have no slot
+            layout.VertexElements.resize(i);
             return layout;
         }
 
-        bool CreateVertexData(const GLTFVertexBufferMetaData& infoData, std::vector<uint8_t>& outBuffer)
+        bool CreateVertexData(const GLTFVertexBufferMetaData& infoData, std::span<uint8_t> outBuffer)
         {
             ZoneScoped;
 
-            outBuffer.resize(infoData.Count * infoData.Layout.Stride);
+            if (outBuffer.size() < infoData.Count * infoData.Layout.Stride)
+                return false;
 
             for (int i = 0; i < infoData.Count; ++i)
             {
@@ -333,7 +519,7 @@ namespace CHIKU
 
                 for (const auto& attrib : infoData.Layout.VertexElements)
                 {
-                    const uint8_t* src = attrib.Data + i * attrib.size;
+                    const uint8_t* src = attrib.Data + i * attrib.SourceStride;
                     uint8_t* dst = dstVertex + attrib.Offset;
                     std::memcpy(dst, src, attrib.size);
                 }
@@ -367,7 +553,7 @@ namespace CHIKU
             }
         }
 
-        void PrintVertexData(const std::vector<uint8_t>& buffer, const GLTFVertexBufferMetaData& infoData)
+        void PrintVertexData(std::span<const uint8_t> buffer, const GLTFVertexBufferMetaData& infoData)
         {
             ZoneScoped;
 
@@ -401,12 +587,11 @@ namespace CHIKU
         {
             ZoneScoped;
 
-            VertexBufferMetaData result;
-            result.Count = gltfInfo.Count;
-            result.Layout.Stride = gltfInfo.Layout.Stride;
-            result.Layout.Mask = gltfInfo.Layout.mask;
+            VertexBufferLayout layout;
+            layout.Stride = gltfInfo.Layout.Stride;
+            layout.Mask = gltfInfo.Layout.mask;
 
-            result.Layout.VertexElements.reserve(gltfInfo.Layout.VertexElements.size());
+            layout.VertexElements.reserve(gltfInfo.Layout.VertexElements.size());
             for (const auto& attr : gltfInfo.Layout.VertexElements)
             {
                 VertexAttribute convertedAttr;
@@ -415,9 +600,13 @@ namespace CHIKU
                 convertedAttr.ComponentType = attr.ComponentType;
                 convertedAttr.AttributeType = attr.AttributeType;
 
-                result.Layout.VertexElements.push_back(convertedAttr);
+                layout.VertexElements.push_back(convertedAttr);
             }
 
+            VertexBufferMetaData result;
+            result.Count = gltfInfo.Count;
+            result.LayoutID = VertexLayoutRegistry::Intern(layout);
+
             return result;
         }
 
@@ -439,14 +628,12 @@ namespace CHIKU
                 return modelAsset;
             }
 
-
-			auto modelpath = std::filesystem::path(modelAsset);
-            std::string stem = modelpath.stem().string();
-            AssetPath gltfPath = SOURCE_DIR + "Models/" + (stem + ".gltf");
+            //Written next to the source so models sharing a name in different folders never overwrite each other
+            AssetPath gltfPath = std::filesystem::path(modelAsset).replace_extension(".gltf").string();
 
             // Build the command
             std::string command = (SOURCE_DIR + "tools/FBX2glTF.exe")
-                + " --input \"" + SOURCE_DIR + modelAsset + "\""
+                + " --input \"" + modelAsset + "\""
                 + " --output \"" + gltfPath + "\"";
 
             int result = std::system(command.c_str());
@@ -467,5 +654,242 @@ namespace CHIKU
                 return "";
             }
         }
+
+        static bool FileSystemFileExists(const std::string& path, void*)
+        {
+            return FileSystem::Exists(path);
+        }
+
+        static bool FileSystemGetFileSize(size_t* size, std::string* err, const std::string& path, void*)
+        {
+            if (FileSystem::GetFileSize(path, *size))
+                return true;
+
+            if (err)
+                *err += "File not found: " + path + "\n";
+            return false;
+        }
+
+        static bool FileSystemReadWholeFile(std::vector<unsigned char>* data, std::string* err, const std::string& path, void*)
+        {
+            size_t size = 0;
+            if (!FileSystemGetFileSize(&size, err, path, nullptr))
+                return false;
+
+            data->resize(size);
+            if (FileSystem::ReadFile(path, *data))
+                return true;
+
+            if (err)
+                *err += "Failed to read: " + path + "\n";
+            return false;
+        }
+
+        void UseFileSystem(tinygltf::TinyGLTF& loader)
+        {
+            tinygltf::FsCallbacks callbacks{};
+            callbacks.FileExists = &FileSystemFileExists;
+            callbacks.ExpandFilePath = &tinygltf::ExpandFilePath;
+            callbacks.ReadWholeFile = &FileSystemReadWholeFile;
+            callbacks.WriteWholeFile = &tinygltf::WriteWholeFile;
+            callbacks.GetFileSizeInBytes = &FileSystemGetFileSize;
+            callbacks.user_data = nullptr;
+
+            loader.SetFsCallbacks(callbacks);
+        }
+
+        GLTFBuffers::GLTFBuffers(const tinygltf::Model& model)
+        {
+            m_Buffers.reserve(model.buffers.size());
+            for (const auto& buffer : model.buffers)
+            {
+                m_Buffers.emplace_back(buffer.data.data(), buffer.data.size());
+            }
+        }
+
+        std::span<const uint8_t> GLTFBuffers::Get(int buffer) const
+        {
+            if (buffer < 0 || buffer >= m_Buffers.size())
+                return {};
+
+            return m_Buffers[buffer];
+        }
+
+        bool GLTFBuffers::Open(const AssetPath& path, std::span<const uint8_t>& bytes)
+        {
+            ZoneScoped;
+
+            if (!FileSystem::IsPacked(path))
+            {
+                MappedFile file;
+                if (!file.Open(FileSystem::GetLoosePath(path)))
+                    return false;
+
+                bytes = file.GetSpan();
+                m_Files.push_back(std::move(file));
+                return true;
+            }
+
+            //Packs are block compressed, there is nothing to map
+            size_t size = 0;
+            if (!FileSystem::GetFileSize(path, size))
+                return false;
+
+            std::vector<uint8_t>& data = m_Unpacked.emplace_back(size);
+            if (!FileSystem::ReadFile(path, data))
+            {
+                m_Unpacked.pop_back();
+                return false;
+            }
+
+            bytes = data;
+            return true;
+        }
+
+        //Binary glTF container, a JSON chunk followed by an optional binary chunk
+        struct GLBHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t Length;
+        };
+
+        struct GLBChunkHeader
+        {
+            uint32_t Length;
+            uint32_t Type;
+        };
+
+        static constexpr uint32_t GLBMagic = 0x46546C67; //glTF
+        static constexpr uint32_t GLBChunkJSON = 0x4E4F534A;
+        static constexpr uint32_t GLBChunkBIN = 0x004E4942;
+
+        static bool SplitGLB(std::span<const uint8_t> file, std::span<const uint8_t>& json, std::span<const uint8_t>& bin)
+        {
+            GLBHeader header;
+            GLBChunkHeader chunk;
+            if (file.size() < sizeof(header) + sizeof(chunk))
+                return false;
+
+            std::memcpy(&header, file.data(), sizeof(header));
+            //The length is checked before anything is subtracted from it, a corrupt one would wrap around
+            if (header.Magic != GLBMagic || header.Version != 2 || header.Length < sizeof(header) + sizeof(chunk) || header.Length > file.size())
+                return false;
+
+            size_t offset = sizeof(header);
+            std::memcpy(&chunk, file.data() + offset, sizeof(chunk));
+            offset += sizeof(chunk);
+            if (chunk.Type != GLBChunkJSON || offset + chunk.Length > header.Length)
+                return false;
+
+            json = file.subspan(offset, chunk.Length);
+            offset += chunk.Length;
+
+            bin = {};
+            if (offset + sizeof(chunk) <= header.Length)
+            {
+                std::memcpy(&chunk, file.data() + offset, sizeof(chunk));
+                offset += sizeof(chunk);
+                if (chunk.Type == GLBChunkBIN && offset + chunk.Length <= header.Length)
+                    bin = file.subspan(offset, chunk.Length);
+            }
+
+            return true;
+        }
+
+        bool LoadGLTFMapped(const AssetPath& gltfPath, tinygltf::Model& model, GLTFBuffers& buffers)
+        {
+            ZoneScoped;
+
+            buffers = GLTFBuffers();
+
+            std::span<const uint8_t> file;
+            if (!buffers.Open(gltfPath, file))
+            {
+                LOG_WARN("Failed to open " + gltfPath);
+                return false;
+            }
+
+            std::span<const uint8_t> json = file;
+            std::span<const uint8_t> bin;
+            bool binary = file.size() >= sizeof(uint32_t) && std::memcmp(file.data(), &GLBMagic, sizeof(uint32_t)) == 0;
+            if (binary && !SplitGLB(file, json, bin))
+            {
+                LOG_WARN("Not a valid binary glTF: " + gltfPath);
+                return false;
+            }
+
+            nlohmann::json document = nlohmann::json::parse(json.begin(), json.end(), nullptr, false);
+            if (document.is_discarded() || !document.is_object())
+            {
+                LOG_WARN("glTF JSON does not parse: " + gltfPath);
+                return false;
+            }
+
+            //tinygltf only gets to see the JSON. Mapped buffers are swapped for a one byte embedded placeholder, tinygltf
+            //refuses empty data URIs. Small data URIs are left to it. Images are dropped so no pixels are read or decoded
+            nlohmann::json sourceBuffers = document.value("buffers", nlohmann::json::array());
+            nlohmann::json sourceImages = document.value("images", nlohmann::json::array());
+            document.erase("images");
+
+            std::filesystem::path directory = std::filesystem::path(gltfPath).parent_path();
+            buffers.m_Buffers.resize(sourceBuffers.size());
+            for (size_t i = 0; i < sourceBuffers.size(); i++)
+            {
+                nlohmann::json& buffer = document["buffers"][i];
+                std::string uri = buffer.value("uri", "");
+                if (uri.starts_with("data:"))
+                    continue;
+
+                size_t byteLength = buffer.value("byteLength", size_t(0));
+                std::span<const uint8_t> bytes = bin;
+                if (!uri.empty() && !buffers.Open((directory / DecodeURI(uri)).lexically_normal().generic_string(), bytes))
+                {
+                    LOG_WARN("Failed to open buffer " + uri + " of " + gltfPath);
+                    return false;
+                }
+
+                if (bytes.size() < byteLength)
+                {
+                    LOG_WARN("Buffer " + std::to_string(i) + " of " + gltfPath + " is shorter than its byteLength");
+                    return false;
+                }
+
+                buffers.m_Buffers[i] = bytes.first(byteLength);
+                buffer = { { "byteLength", 1 }, { "uri", "data:application/octet-stream;base64,AA==" } };
+            }
+
+            tinygltf::TinyGLTF loader;
+            UseFileSystem(loader);
+            std::string err, warn;
+            std::string text = document.dump();
+
+            bool ok = loader.LoadASCIIFromString(&model, &err, &warn, text.data(), static_cast<unsigned int>(text.size()), directory.string());
+            if (!warn.empty()) std::cout << "Warn: " << warn << "\n";
+            if (!err.empty()) std::cerr << "Err: " << err << "\n";
+            if (!ok)
+                return false;
+
+            //Where everything came from stays visible, the cooker tracks external files as inputs
+            for (size_t i = 0; i < sourceBuffers.size() && i < model.buffers.size(); i++)
+            {
+                model.buffers[i].uri = sourceBuffers[i].value("uri", "");
+                if (model.buffers[i].uri.starts_with("data:"))
+                    buffers.m_Buffers[i] = { model.buffers[i].data.data(), model.buffers[i].data.size() };
+                else
+                    model.buffers[i].data.clear();
+            }
+
+            for (const auto& source : sourceImages)
+            {
+                tinygltf::Image& image = model.images.emplace_back();
+                image.name = source.value("name", "");
+                image.uri = source.value("uri", "");
+                image.mimeType = source.value("mimeType", "");
+                image.bufferView = source.value("bufferView", -1);
+            }
+
+            return true;
+        }
     }
-}
\ No newline at end of file
+}
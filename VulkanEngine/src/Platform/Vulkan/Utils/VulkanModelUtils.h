@@ -1,11 +1,16 @@
 #pragma once
 #include "Renderer/Buffer/VertexBuffer.h"
 #include "Assets/Asset.h"
+#include "Assets/MeshAsset.h"
+#include "Renderer/ShaderFeatures.h"
+#include "IO/MappedFile.h"
 #include <tiny_gltf.h>
 
 namespace CHIKU
 {
 	struct VertexBufferMetaData;
+	struct Material;
+	class ScratchScope;
     
 	namespace Utils
 	{
@@ -16,7 +21,8 @@ namespace CHIKU
             uint8_t size;
             VertexComponentType ComponentType;
             VertexAttributeType AttributeType;
-            //1 byte can be squeezed in here 
+            //Bytes from one element to the next in the source, wider than size when the buffer view is interleaved
+            uint32_t SourceStride = 0;
         };
 
         struct GLTFVertexBufferLayout
@@ -32,21 +38,102 @@ namespace CHIKU
             GLTFVertexBufferLayout Layout;
         };
 
+        //CPU side of one primitive, the spans point into the ScratchScope it was imported with
+        struct ImportedPrimitive
+        {
+            VertexBufferMetaData MetaData;
+            std::span<uint8_t> Vertices;
+            std::span<uint32_t> Indices;
+        };
+
+        //One primitive of an ImportedModel, its vertices and indices are slices of the model's shared storage
+        struct ImportedModelPrimitive
+        {
+            uint32_t MeshIndex = 0;
+            uint32_t PrimitiveIndex = 0;
+            int MaterialIndex = -1;
+            GLTFVertexBufferMetaData Layout;
+            VertexBufferMetaData MetaData;
+            MeshBounds Bounds;
+            size_t VertexOffset = 0; // bytes into ImportedModel::Vertices
+            size_t IndexOffset = 0;  // elements into ImportedModel::Indices
+            size_t IndexCount = 0;
+            bool Valid = false;
+
+            size_t GetVertexSize() const { return Layout.Count * Layout.Layout.Stride; }
+        };
+
+        //CPU side of every primitive of a model, all vertices share one allocation and all indices another
+        struct ImportedModel
+        {
+            std::vector<ImportedModelPrimitive> Primitives;
+            std::vector<uint8_t> Vertices;
+            std::vector<uint32_t> Indices;
+
+            std::span<const uint8_t> GetVertices(const ImportedModelPrimitive& primitive) const { return { Vertices.data() + primitive.VertexOffset, primitive.GetVertexSize() }; }
+            std::span<const uint32_t> GetIndices(const ImportedModelPrimitive& primitive) const { return { Indices.data() + primitive.IndexOffset, primitive.IndexCount }; }
+        };
+
+        //Bytes behind every buffer of a model, accessors are read through this instead of tinygltf's buffer vectors.
+        //Built from a model it views tinygltf's copies, LoadGLTFMapped points it straight into the mapped files
+        class GLTFBuffers
+        {
+        public:
+            GLTFBuffers() = default;
+            explicit GLTFBuffers(const tinygltf::Model& model);
+
+            GLTFBuffers(GLTFBuffers&&) = default;
+            GLTFBuffers& operator=(GLTFBuffers&&) = default;
+
+            //Empty when the index is out of range
+            std::span<const uint8_t> Get(int buffer) const;
+
+        private:
+            friend bool LoadGLTFMapped(const AssetPath& gltfPath, tinygltf::Model& model, GLTFBuffers& buffers);
+            //Maps a loose file, a packed one is decompressed into memory
+            bool Open(const AssetPath& path, std::span<const uint8_t>& bytes);
+
+        private:
+            std::vector<std::span<const uint8_t>> m_Buffers;
+            std::vector<MappedFile> m_Files;
+            std::vector<std::vector<uint8_t>> m_Unpacked;
+        };
+
         void FinalizeLayout(GLTFVertexBufferLayout& layout);
 
-		std::vector<uint32_t> CreateIndices(const tinygltf::Model& model, const tinygltf::Primitive& primitive);
+		//Writes the primitive's indices widened to 32 bit, outIndices holds exactly the accessor count.
+		//False when an index is not below vertexCount, vertex pulling would read past the mesh on the GPU
+		bool CreateIndices(const tinygltf::Model& model, const GLTFBuffers& buffers, const tinygltf::Primitive& primitive, std::span<uint32_t> outIndices, size_t vertexCount);
 
         std::string SelectShaderFromMaterial(const tinygltf::Material& mat);
-        AssetHandle CreateMaterials(int index, const tinygltf::Model& model, const tinygltf::Material& mat, const AssetPath& outputPath);
-        bool ProcessModel(const tinygltf::Model& model, std::unordered_map<AssetHandle, AssetHandle>& meshMaterial);
+        ShaderFeatureMask GetMaterialFeatures(int index, const tinygltf::Model& model, const tinygltf::Material& mat);
+        //The material as the engine sees it, needs neither a device nor the asset manager
+        Material ImportMaterial(int index, const tinygltf::Model& model, const tinygltf::Material& mat);
+        AssetHandle CreateMaterials(int index, const tinygltf::Model& model, const tinygltf::Material& mat, const AssetPath& name);
+        //Interleaved vertices and 32 bit indices of a primitive, false when it has no positions or the vertex data failed
+        bool ImportPrimitive(const tinygltf::Model& model, const GLTFBuffers& buffers, const tinygltf::Primitive& primitive, ScratchScope& scratch, ImportedPrimitive& out);
+        //Imports every primitive with positions on the job workers, needs no device so it can run off the main thread.
+        //False when any primitive failed, the ones that did import are still usable
+        bool ImportModel(const tinygltf::Model& model, const GLTFBuffers& buffers, ImportedModel& out);
+        //Creates the materials and meshes of an imported model, the vertex and index buffers go up in one upload batch
+        bool ProcessModel(const tinygltf::Model& model, const ImportedModel& imported, const AssetPath& sourcePath, std::unordered_map<AssetHandle, AssetHandle>& meshMaterial);
         
-		GLTFVertexBufferLayout CreateBufferLayout(const tinygltf::Model& model, const tinygltf::Primitive& primitive);
+		GLTFVertexBufferLayout CreateBufferLayout(const tinygltf::Model& model, const GLTFBuffers& buffers, const tinygltf::Primitive& primitive);
 		
-        bool CreateVertexData(const GLTFVertexBufferMetaData& infoData, std::vector<uint8_t>& outBuffer);
-		void PrintVertexData(const std::vector<uint8_t>& buffer, const GLTFVertexBufferMetaData& infoData);
+        //outBuffer holds Count * Stride bytes
+        bool CreateVertexData(const GLTFVertexBufferMetaData& infoData, std::span<uint8_t> outBuffer);
+		void PrintVertexData(std::span<const uint8_t> buffer, const GLTFVertexBufferMetaData& infoData);
 
         VertexBufferMetaData ConvertGLTFInfoToVertexInfo(const GLTFVertexBufferMetaData& gltfInfo);
         bool IsGLTFFormat(const AssetPath& path);
+        //Runs FBX2glTF on non glTF sources and writes the result next to the source.
+        //Loaders go through AssetCooker::GetGLTFPath, which only converts when the source changed
         AssetPath ConvertToGLTF(const AssetPath& modelAsset);
+        //Routes the loader's file access through the FileSystem, whatever it still opens itself resolves inside mounted packs
+        void UseFileSystem(tinygltf::TinyGLTF& loader);
+        //Parses a .gltf or .glb from disk or a mounted pack without copying its vertex data. The .glb binary chunk and
+        //external .bin files are mapped and buffers point into them, model.buffers only keep their uri.
+        //Image pixels are not loaded, model.images only carry where the image is
+        bool LoadGLTFMapped(const AssetPath& gltfPath, tinygltf::Model& model, GLTFBuffers& buffers);
 	}
 }
\ No newline at end of file
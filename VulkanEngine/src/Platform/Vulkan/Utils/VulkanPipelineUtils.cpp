@@ -0,0 +1,146 @@
+#include "VulkanPipelineUtils.h"
+
+namespace CHIKU
+{
+	namespace Utils
+	{
+		VkCullModeFlags GetVkCullMode(const CullMode& cullMode)
+		{
+			switch (cullMode)
+			{
+			case CullMode::None:			return VK_CULL_MODE_NONE;
+			case CullMode::Front:			return VK_CULL_MODE_FRONT_BIT;
+			case CullMode::Back:			return VK_CULL_MODE_BACK_BIT;
+			case CullMode::FrontAndBack:	return VK_CULL_MODE_FRONT_AND_BACK;
+			}
+
+			return VK_CULL_MODE_BACK_BIT;
+		}
+
+		VkFrontFace GetVkFrontFace(const FrontFace& frontFace)
+		{
+			switch (frontFace)
+			{
+			case FrontFace::CounterClockwise:	return VK_FRONT_FACE_COUNTER_CLOCKWISE;
+			case FrontFace::Clockwise:			return VK_FRONT_FACE_CLOCKWISE;
+			}
+
+			return VK_FRONT_FACE_COUNTER_CLOCKWISE;
+		}
+
+		VkPolygonMode GetVkPolygonMode(const PolygonMode& polygonMode)
+		{
+			switch (polygonMode)
+			{
+			case PolygonMode::Fill:		return VK_POLYGON_MODE_FILL;
+			case PolygonMode::Line:		return VK_POLYGON_MODE_LINE;
+			case PolygonMode::Point:	return VK_POLYGON_MODE_POINT;
+			}
+
+			return VK_POLYGON_MODE_FILL;
+		}
+
+		VkPrimitiveTopology GetVkPrimitiveTopology(const PrimitiveTopology& topology)
+		{
+			switch (topology)
+			{
+			case PrimitiveTopology::PointList:		return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+			case PrimitiveTopology::LineList:		return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+			case PrimitiveTopology::LineStrip:		return VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+			case PrimitiveTopology::TriangleList:	return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+			case PrimitiveTopology::TriangleStrip:	return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+			case PrimitiveTopology::TriangleFan:	return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN;
+			}
+
+			return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+		}
+	
+		VkPipelineInputAssemblyStateCreateInfo GetInputAssemblyState(const RenderState& renderState)
+		{
+			VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+			inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+			inputAssembly.topology = GetVkPrimitiveTopology(renderState.Topology);
+			inputAssembly.primitiveRestartEnable = VK_FALSE;
+			return inputAssembly;
+		}
+
+		VkPipelineRasterizationStateCreateInfo GetRasterizationState(const RenderState& renderState)
+		{
+			VkPipelineRasterizationStateCreateInfo rasterizer{};
+			rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+			rasterizer.depthClampEnable = VK_FALSE;
+			rasterizer.rasterizerDiscardEnable = VK_FALSE;
+			rasterizer.polygonMode = GetVkPolygonMode(renderState.Polygon);
+			rasterizer.lineWidth = 1.0f;
+			rasterizer.cullMode = GetVkCullMode(renderState.Cull);
+			rasterizer.frontFace = GetVkFrontFace(renderState.Front);
+			rasterizer.depthBiasEnable = VK_FALSE;
+			return rasterizer;
+		}
+
+		VkPipelineMultisampleStateCreateInfo GetMultisampleState()
+		{
+			VkPipelineMultisampleStateCreateInfo multisampling{};
+			multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+			multisampling.sampleShadingEnable = VK_FALSE;
+			multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+			return multisampling;
+		}
+
+		VkPipelineDepthStencilStateCreateInfo GetDepthStencilState(const RenderState& renderState)
+		{
+			VkPipelineDepthStencilStateCreateInfo depthStencil{};
+			depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+			depthStencil.depthTestEnable = renderState.DepthTest;
+			depthStencil.depthWriteEnable = renderState.DepthWrite;
+			depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+			depthStencil.depthBoundsTestEnable = VK_FALSE;
+			depthStencil.minDepthBounds = 0.0f; // Optional
+			depthStencil.maxDepthBounds = 1.0f; // Optional
+			depthStencil.stencilTestEnable = VK_FALSE;
+			depthStencil.front = {}; // Optional
+			depthStencil.back = {}; // Optional
+			return depthStencil;
+		}
+
+		VkPipelineColorBlendAttachmentState GetColorBlendAttachmentState(const RenderState& renderState)
+		{
+			VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+			colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+			colorBlendAttachment.blendEnable = renderState.BlendEnabled ? VK_TRUE : VK_FALSE;
+			colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+			colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+			colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+			colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+			colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+			colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+			return colorBlendAttachment;
+		}
+
+		const VkSpecializationInfo* GetSpecializationInfo(const std::vector<SpecializationConstantInfo>& constants, ShaderStages stage, ShaderFeatureMask features, SpecializationData& data)
+		{
+			data.Entries.clear();
+			data.Values.clear();
+
+			for (const auto& constant : constants)
+			{
+				if (!constant.Stages.test(stage))
+					continue;
+
+				uint32_t offset = static_cast<uint32_t>(data.Values.size() * sizeof(VkBool32));
+				data.Entries.push_back({ constant.ConstantID, offset, sizeof(VkBool32) });
+				data.Values.push_back(HasFeature(features, constant.Feature) ? VK_TRUE : VK_FALSE);
+			}
+
+			if (data.Values.empty())
+				return nullptr;
+
+			data.Info.mapEntryCount = static_cast<uint32_t>(data.Entries.size());
+			data.Info.pMapEntries = data.Entries.data();
+			data.Info.dataSize = data.Values.size() * sizeof(VkBool32);
+			data.Info.pData = data.Values.data();
+
+			return &data.Info;
+		}
+	}
+}
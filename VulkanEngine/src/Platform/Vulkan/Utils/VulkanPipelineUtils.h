@@ -0,0 +1,33 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Renderer/RenderState.h"
+#include "Renderer/ShaderFeatures.h"
+
+namespace CHIKU
+{
+	//Backing storage for a stage's VkSpecializationInfo, must outlive pipeline creation
+	struct SpecializationData
+	{
+		std::vector<VkSpecializationMapEntry> Entries;
+		std::vector<VkBool32> Values;
+		VkSpecializationInfo Info{};
+	};
+
+	namespace Utils
+	{
+		VkCullModeFlags GetVkCullMode(const CullMode& cullMode);
+		VkFrontFace GetVkFrontFace(const FrontFace& frontFace);
+		VkPolygonMode GetVkPolygonMode(const PolygonMode& polygonMode);
+		VkPrimitiveTopology GetVkPrimitiveTopology(const PrimitiveTopology& topology);
+
+		//Fixed function state shared by monolithic pipelines and pipeline library parts
+		VkPipelineInputAssemblyStateCreateInfo GetInputAssemblyState(const RenderState& renderState);
+		VkPipelineRasterizationStateCreateInfo GetRasterizationState(const RenderState& renderState);
+		VkPipelineMultisampleStateCreateInfo GetMultisampleState();
+		VkPipelineDepthStencilStateCreateInfo GetDepthStencilState(const RenderState& renderState);
+		VkPipelineColorBlendAttachmentState GetColorBlendAttachmentState(const RenderState& renderState);
+
+		//Fills the feature constants read by the stage, returns nullptr when it declares none
+		const VkSpecializationInfo* GetSpecializationInfo(const std::vector<SpecializationConstantInfo>& constants, ShaderStages stage, ShaderFeatureMask features, SpecializationData& data);
+	}
+}
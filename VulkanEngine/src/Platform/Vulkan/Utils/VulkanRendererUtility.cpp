@@ -105,6 +105,16 @@ namespace CHIKU
 			return requiredExtensions.empty();
 		}
 
+		bool IsExtensionAvailable(const std::vector<VkExtensionProperties>& availableExtensions, const char* name)
+		{
+			for (const VkExtensionProperties& extension : availableExtensions)
+			{
+				if (strcmp(extension.extensionName, name) == 0)
+					return true;
+			}
+			return false;
+		}
+
 		SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface)
 		{
 			ZoneScoped;
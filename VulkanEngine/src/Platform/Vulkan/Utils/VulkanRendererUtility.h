@@ -20,6 +20,8 @@ namespace CHIKU
 
 		int RateDeviceSuitability(VkPhysicalDevice device);
 		bool CheckDeviceExtensionSupport(VkPhysicalDevice device, const std::vector<const char*>& deviceExtensions);
+		//Looks a name up in an already enumerated extension list
+		bool IsExtensionAvailable(const std::vector<VkExtensionProperties>& availableExtensions, const char* name);
 		SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface);
 		bool IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface, const std::vector<const char*>& deviceExtensions);
 	}
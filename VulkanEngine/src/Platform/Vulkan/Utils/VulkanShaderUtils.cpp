@@ -2,7 +2,9 @@
 #include "Assets/ShaderAsset.h"
 #include "Vulkan/Renderer/VulkanRenderer.h"
 #include "Vulkan/Renderer/DescriptorPool.h"
+#include "Vulkan/Renderer/LayoutCache.h"
 #include "Vulkan/Utils/VulkanBufferUtils.h"
+#include "IO/FileSystem.h"
 
 #include <fstream>
 #include <iostream>
@@ -141,23 +143,90 @@ namespace CHIKU
             return false;
         }
 
-        void ProcessSPIRV(const std::vector<AssetPath>& shaderCodes, UniformBufferDescription& uniformSets, std::bitset<ATTR_COUNT>& inputAttribute)
+        bool CompileShaderToSPIRV(const AssetPath& shaderPath, const AssetPath& outputPath)
         {
             ZoneScoped;
 
-            for (auto& shaderCode : shaderCodes)
+#ifdef PLT_WINDOWS
+            std::string compiler = "glslc.exe";
+#else
+            std::string compiler = "glslc";
+#endif
+            std::string command = compiler + " \"" + (SOURCE_DIR + shaderPath) + "\" -o \"" + (SOURCE_DIR + outputPath) + "\"";
+            int result = std::system(command.c_str());
+
+            if (result != 0)
+            {
+                std::cerr << "Shader compilation failed with exit code: " << result << std::endl;
+                return false;
+            }
+
+            std::cout << "Compiled successfully: " << outputPath << std::endl;
+            return true;
+        }
+
+        std::string GetShaderCompilerVersion()
+        {
+            //glslc lives in the SDK, whose folder carries its version
+            const char* sdk = std::getenv("VULKAN_SDK");
+            return std::string("glslc ") + (sdk ? sdk : "from PATH");
+        }
+
+        std::vector<AssetPath> GetShaderIncludes(const AssetPath& shaderPath)
+        {
+            ZoneScoped;
+
+            std::vector<AssetPath> includes;
+            std::vector<AssetPath> pending = { shaderPath };
+            while (!pending.empty())
             {
-                std::ifstream file(SOURCE_DIR + shaderCode, std::ios::binary | std::ios::ate);
+                AssetPath current = pending.back();
+                pending.pop_back();
 
-                if (!file.is_open())
+                std::ifstream file(SOURCE_DIR + current);
+                std::string line;
+                while (std::getline(file, line))
+                {
+                    size_t start = line.find_first_not_of(" \t");
+                    if (start == std::string::npos || line.compare(start, 8, "#include") != 0)
+                        continue;
+
+                    size_t open = line.find('"', start);
+                    size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+                    if (close == std::string::npos)
+                        continue;
+
+                    //Quoted includes resolve next to the including file, the same way glslc looks them up
+                    AssetPath include = (std::filesystem::path(current).parent_path() / line.substr(open + 1, close - open - 1)).lexically_normal().generic_string();
+                    if (std::find(includes.begin(), includes.end(), include) == includes.end())
+                    {
+                        includes.push_back(include);
+                        pending.push_back(include);
+                    }
+                }
+            }
+
+            return includes;
+        }
+
+        void ProcessSPIRV(const std::vector<AssetPath>& shaderCodes, UniformBufferDescription& uniformSets, PushConstantDescription& pushConstants, std::vector<UniformMemberInfo>& materialRecord, std::bitset<ATTR_COUNT>& inputAttribute, bool& vertexPulling, std::vector<SpecializationConstantInfo>& specializationConstants)
+        {
+            ZoneScoped;
+
+            for (auto& shaderCode : shaderCodes)
+            {
+                size_t size = 0;
+                if (!FileSystem::GetFileSize(shaderCode, size))
                 {
                     throw std::runtime_error("Failed to open SPIR-V file");
                 }
 
-                size_t size = file.tellg();
-                file.seekg(0);
+                //SPIR-V is a stream of words, read straight into word aligned storage
                 std::vector<uint32_t> spirv(size / sizeof(uint32_t));
-                file.read(reinterpret_cast<char*>(spirv.data()), size);
+                if (!FileSystem::ReadFile(shaderCode, std::span<uint8_t>(reinterpret_cast<uint8_t*>(spirv.data()), spirv.size() * sizeof(uint32_t))))
+                {
+                    throw std::runtime_error("Failed to read SPIR-V file");
+                }
 
                 SpvReflectShaderModule module;
                 SpvReflectResult result = spvReflectCreateShaderModule(spirv.size() * sizeof(uint32_t), spirv.data(), &module);
@@ -167,10 +236,16 @@ namespace CHIKU
                 }
 
 				GetUniformDescription(uniformSets, module);
+				GetPushConstantDescription(pushConstants, module);
+				GetMaterialRecord(materialRecord, module);
+				GetSpecializationConstants(specializationConstants, module);
 
                 if(module.shader_stage & SPV_REFLECT_SHADER_STAGE_VERTEX_BIT)
                 {
                     GetInputAttributes(inputAttribute, module);
+
+                    SpvReflectResult setResult;
+                    vertexPulling = spvReflectGetDescriptorSet(&module, VERTEX_PULLING_DESCRIPTOR_SET, &setResult) != nullptr;
 				}
 
                 spvReflectDestroyShaderModule(&module);
@@ -216,6 +291,16 @@ namespace CHIKU
 						continue; // skip the reserved binding 0 in set 0
                     }
 
+                    if (set->set == VERTEX_PULLING_DESCRIPTOR_SET)
+                    {
+                        continue; // owned by VertexPulling, not by the material
+                    }
+
+                    if (set->set == MATERIAL_TABLE_DESCRIPTOR_SET && binding->binding == 0)
+                    {
+                        continue; // the shared material table, see GetMaterialRecord
+                    }
+
                     if(uniformBufferSet[set->set].find(bindingIndex) != uniformBufferSet[set->set].end())
                     {
                         uniformBufferSet[set->set][bindingIndex].Stages.set(MapReflectStage(spirv.shader_stage));
@@ -258,6 +343,135 @@ namespace CHIKU
             }
         }
 
+        void GetMaterialRecord(std::vector<UniformMemberInfo>& materialRecord, const SpvReflectShaderModule& spirv)
+        {
+            ZoneScoped;
+
+            SpvReflectResult result;
+            const SpvReflectDescriptorBinding* binding = spvReflectGetDescriptorBinding(&spirv, 0, MATERIAL_TABLE_DESCRIPTOR_SET, &result);
+            if (binding == nullptr)
+                return;
+
+            //The table is declared as a runtime array of MaterialRecord, its element is the record
+            if (binding->descriptor_type != SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER || binding->block.member_count != 1)
+            {
+                throw std::runtime_error("Material table must be a storage buffer holding a single MaterialRecord array");
+            }
+
+            const SpvReflectBlockVariable& records = binding->block.members[0];
+            if (records.array.stride != MATERIAL_RECORD_STRIDE)
+            {
+                throw std::runtime_error("MaterialRecord must be padded to MATERIAL_RECORD_STRIDE bytes");
+            }
+
+            //Stages declare the same record, the first one seen describes it
+            if (!materialRecord.empty())
+                return;
+
+            for (uint32_t i = 0; i < records.member_count; ++i)
+            {
+                const SpvReflectBlockVariable& member = records.members[i];
+
+                UniformMemberInfo info;
+                info.Offset = member.offset;
+                info.Size = member.size;
+                info.Type = GetSPIRVDataType(member);
+                materialRecord.push_back(info);
+            }
+        }
+
+        void GetPushConstantDescription(PushConstantDescription& pushConstants, const SpvReflectShaderModule& spirv)
+        {
+            ZoneScoped;
+
+            uint32_t blockCount = 0;
+            if (spvReflectEnumeratePushConstantBlocks(&spirv, &blockCount, nullptr) != SPV_REFLECT_RESULT_SUCCESS)
+            {
+                throw std::runtime_error("Failed to enumerate push constant blocks");
+            }
+
+            std::vector<SpvReflectBlockVariable*> blocks(blockCount);
+            spvReflectEnumeratePushConstantBlocks(&spirv, &blockCount, blocks.data());
+
+            for (const SpvReflectBlockVariable* block : blocks)
+            {
+                if (block->member_count == 0)
+                    continue;
+
+                PushConstantRange range{};
+                range.Offset = UINT32_MAX;
+
+                //A stage only sees the members it declares, the range spans exactly those bytes
+                uint32_t end = 0;
+                for (uint32_t i = 0; i < block->member_count; ++i)
+                {
+                    const SpvReflectBlockVariable& member = block->members[i];
+
+                    UniformMemberInfo info;
+                    info.Offset = member.offset;
+                    info.Size = member.size;
+                    info.Type = GetSPIRVDataType(member);
+                    range.Members.push_back(info);
+
+                    range.Offset = std::min(range.Offset, member.offset);
+                    end = std::max(end, member.offset + member.size);
+                }
+                range.Size = end - range.Offset;
+
+                auto it = std::find_if(pushConstants.begin(), pushConstants.end(),
+                    [&](const PushConstantRange& other) { return other.Offset == range.Offset && other.Size == range.Size; });
+
+                if (it == pushConstants.end())
+                {
+                    pushConstants.push_back(std::move(range));
+                    it = pushConstants.end() - 1;
+                }
+
+                it->Stages.set(MapReflectStage(spirv.shader_stage));
+            }
+        }
+
+        void GetSpecializationConstants(std::vector<SpecializationConstantInfo>& specializationConstants, const SpvReflectShaderModule& spirv)
+        {
+            ZoneScoped;
+
+            uint32_t constantCount = 0;
+            if (spvReflectEnumerateSpecializationConstants(&spirv, &constantCount, nullptr) != SPV_REFLECT_RESULT_SUCCESS)
+            {
+                throw std::runtime_error("Failed to enumerate specialization constants");
+            }
+
+            std::vector<SpvReflectSpecializationConstant*> constants(constantCount);
+            spvReflectEnumerateSpecializationConstants(&spirv, &constantCount, constants.data());
+
+            for (const SpvReflectSpecializationConstant* constant : constants)
+            {
+                const char* name = constant->name ? constant->name : "";
+                ShaderFeature feature = ShaderFeatureFromConstantName(name);
+                if (feature == Feature_Count)
+                {
+                    LOG_WARN("Specialization constant {} is not a material feature, keeping its default", name);
+                    continue;
+                }
+
+                //Constants read by several stages are declared in each of them, keep one entry for all
+                auto it = std::find_if(specializationConstants.begin(), specializationConstants.end(),
+                    [&](const SpecializationConstantInfo& info) { return info.ConstantID == constant->constant_id; });
+
+                if (it == specializationConstants.end())
+                {
+                    specializationConstants.push_back({ constant->constant_id, feature, {} });
+                    it = specializationConstants.end() - 1;
+                }
+                else if (it->Feature != feature)
+                {
+                    throw std::runtime_error("constant_id is used for different features across stages");
+                }
+
+                it->Stages.set(MapReflectStage(spirv.shader_stage));
+            }
+        }
+
         void GetInputAttributes(std::bitset<ATTR_COUNT>& attribute, const SpvReflectShaderModule& spirv)
         {
             ZoneScoped;
@@ -312,6 +526,19 @@ namespace CHIKU
             return flags;
         }
 
+        std::vector<VkPushConstantRange> GetVkPushConstantRanges(const PushConstantDescription& pushConstants)
+        {
+            std::vector<VkPushConstantRange> ranges;
+            ranges.reserve(pushConstants.size());
+
+            for (const auto& range : pushConstants)
+            {
+                ranges.push_back({ MapToVulkanShaderStageFlags(range.Stages), range.Offset, range.Size });
+            }
+
+            return ranges;
+        }
+
 
         std::map<uint32_t, UniformSetStorage>  CreateDescriptorSetLayout(const UniformBufferDescription& bufferDescription)
         {
@@ -365,17 +592,8 @@ namespace CHIKU
                 if (bindings.empty())
                     continue;
 
-                VkDescriptorSetLayoutCreateInfo layoutInfo{};
-                layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-                layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-                layoutInfo.pBindings = bindings.data();
-
-                VkDescriptorSetLayout layout;
-                if (vkCreateDescriptorSetLayout(VulkanRenderer::GetVulkanDevice(), &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
-                    throw std::runtime_error("failed to create descriptor set layout!");
-                }
-
-                setStorage[setIndex].DescriptorSetLayout = layout;
+                // Layouts are owned by the cache, identical binding descriptions share one VkDescriptorSetLayout
+                setStorage[setIndex].DescriptorSetLayout = LayoutCache::GetDescriptorSetLayout(bindings);
             }
 
             return setStorage;
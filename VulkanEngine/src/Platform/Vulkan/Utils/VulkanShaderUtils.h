@@ -2,6 +2,7 @@
 #include "Assets/Asset.h"
 #include "Vulkan/Buffer/VulkanUniformBuffer.h"
 #include "Vulkan/Buffer/VulkanVertexBuffer.h"
+#include "Renderer/ShaderFeatures.h"
 #include <spirv_reflect.h>
 #include <bitset>
 
@@ -14,11 +15,21 @@ namespace CHIKU
 		UniformOpaqueDataType ConvertToOpaqueType(const SpvReflectDescriptorBinding* binding);
 
 		bool IsVertexShader(const AssetPath& shaderPath);
-		void ProcessSPIRV(const std::vector<AssetPath>& shaderCodes, UniformBufferDescription& description, std::bitset<ATTR_COUNT>& inputAttribute);
+		//Runs glslc on a GLSL source, both paths relative to the source directory. Needs no device, the cooker uses it too
+		bool CompileShaderToSPIRV(const AssetPath& shaderPath, const AssetPath& outputPath);
+		//What the cook database records as the compiler, a different one compiles every shader again
+		std::string GetShaderCompilerVersion();
+		//Every file a shader pulls in through quoted #include directives, nested ones included
+		std::vector<AssetPath> GetShaderIncludes(const AssetPath& shaderPath);
+		void ProcessSPIRV(const std::vector<AssetPath>& shaderCodes, UniformBufferDescription& description, PushConstantDescription& pushConstants, std::vector<UniformMemberInfo>& materialRecord, std::bitset<ATTR_COUNT>& inputAttribute, bool& vertexPulling, std::vector<SpecializationConstantInfo>& specializationConstants);
 		void GetUniformDescription(UniformBufferDescription& uniformBufferSet, const SpvReflectShaderModule& spirv);
+		void GetPushConstantDescription(PushConstantDescription& pushConstants, const SpvReflectShaderModule& spirv);
+		void GetMaterialRecord(std::vector<UniformMemberInfo>& materialRecord, const SpvReflectShaderModule& spirv);
 		void GetInputAttributes(std::bitset<ATTR_COUNT>& inputAttribute, const SpvReflectShaderModule& spirv);
+		void GetSpecializationConstants(std::vector<SpecializationConstantInfo>& specializationConstants, const SpvReflectShaderModule& spirv);
 
 		VkShaderStageFlags MapToVulkanShaderStageFlags(const ShaderStageBits& stageBits);
+		std::vector<VkPushConstantRange> GetVkPushConstantRanges(const PushConstantDescription& pushConstants);
 
 		std::map<uint32_t, UniformSetStorage> CreateDescriptorSetLayout(const UniformBufferDescription& bufferDescription);
 		void CreateDescriptorSets(const UniformBufferDescription& bufferDescription, std::map<uint32_t, UniformSetStorage>& setStorage);
@@ -6,15 +6,17 @@ namespace CHIKU
 	class IndexBuffer
 	{
     public:
-        virtual void CreateIndexBuffer(const std::vector<uint32_t>& indices) = 0;
+        virtual void CreateIndexBuffer(std::span<const uint32_t> indices) = 0;
         virtual void Bind() const = 0;
         virtual void CleanUp() = 0;
 
         virtual uint32_t GetCount() const final { return count; }
+        //Bytes held on the GPU, 0 while the buffer is not created
+        virtual uint64_t GetSize() const = 0;
 
 		static std::shared_ptr<IndexBuffer> Create();
 
     protected:
-        uint32_t count;
+        uint32_t count = 0;
 	};
 }
\ No newline at end of file
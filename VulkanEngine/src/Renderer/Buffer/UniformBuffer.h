@@ -111,6 +111,17 @@ namespace CHIKU
 	using UniformBufferSet = std::map<uint32_t, UniformBuffer>; // Key is the binding number
     using UniformBufferDescription = std::map<uint32_t, UniformBufferSet>; //Key is the set number
 
+    //Byte range of a push_constant block, stages declaring the exact same range share one entry
+    struct PushConstantRange
+    {
+        uint32_t Offset;
+        uint32_t Size;
+        std::vector<UniformMemberInfo> Members;
+        std::bitset<ShaderStages::Stage_Count> Stages;
+    };
+
+    using PushConstantDescription = std::vector<PushConstantRange>;
+
     struct TextureData;
     struct UniformBufferDescriptorInfo;
 
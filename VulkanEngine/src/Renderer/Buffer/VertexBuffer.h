@@ -55,10 +55,13 @@ namespace CHIKU
         std::vector<VertexAttribute> VertexElements;
     };
 
+    using VertexLayoutID = uint32_t;
+    constexpr VertexLayoutID InvalidVertexLayoutID = std::numeric_limits<VertexLayoutID>::max();
+
     struct VertexBufferMetaData
     {
         uint64_t Count;            // number of vertices
-        VertexBufferLayout Layout;
+        VertexLayoutID LayoutID = InvalidVertexLayoutID; // interned in VertexLayoutRegistry
     };
 
     inline bool operator==(const VertexAttribute& a, const VertexAttribute& b) {
@@ -76,13 +79,13 @@ namespace CHIKU
 
     inline bool operator==(const VertexBufferMetaData& a, const VertexBufferMetaData& b) {
         return a.Count == b.Count &&
-            a.Layout == b.Layout;
+            a.LayoutID == b.LayoutID;
     }
 
 	class VertexBuffer
 	{
     public:
-        virtual void CreateVertexBuffer(const std::vector<uint8_t>& vertices) = 0;
+        virtual void CreateVertexBuffer(std::span<const uint8_t> vertices) = 0;
         virtual void Bind() const = 0;
         virtual void CleanUp() = 0;
 
@@ -94,7 +97,10 @@ namespace CHIKU
         }
 
         inline virtual uint64_t GetCount() const final { return m_MetaData.Count; }
-		inline virtual VertexBufferMetaData GetMetaData() const final { return m_MetaData; }
+        //Bytes held on the GPU, 0 while the buffer is not created
+        virtual uint64_t GetSize() const = 0;
+        inline virtual VertexLayoutID GetLayoutID() const final { return m_MetaData.LayoutID; }
+		inline virtual const VertexBufferMetaData& GetMetaData() const final { return m_MetaData; }
 
 		static std::shared_ptr<VertexBuffer> Create();
 
@@ -135,7 +141,7 @@ namespace std {
         size_t operator()(const CHIKU::VertexBufferMetaData& meta) const {
             size_t seed = 0;
             CHIKU::Utils::hash_combine(seed, std::hash<uint64_t>()(meta.Count));
-            CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::VertexBufferLayout>()(meta.Layout));
+            CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::VertexLayoutID>()(meta.LayoutID));
             return seed;
         }
     };
@@ -0,0 +1,39 @@
+#include "VertexLayoutRegistry.h"
+
+namespace CHIKU
+{
+    std::deque<VertexBufferLayout> VertexLayoutRegistry::m_Layouts;
+    std::unordered_map<VertexBufferLayout, VertexLayoutID> VertexLayoutRegistry::m_LayoutIDs;
+    std::mutex VertexLayoutRegistry::m_Mutex;
+
+    VertexLayoutID VertexLayoutRegistry::Intern(const VertexBufferLayout& layout)
+    {
+        ZoneScoped;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_LayoutIDs.find(layout);
+        if (it != m_LayoutIDs.end())
+        {
+            return it->second;
+        }
+
+        VertexLayoutID id = static_cast<VertexLayoutID>(m_Layouts.size());
+        m_Layouts.push_back(layout);
+        m_LayoutIDs[layout] = id;
+
+        return id;
+    }
+
+    const VertexBufferLayout& VertexLayoutRegistry::GetLayout(VertexLayoutID id)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Layouts[id];
+    }
+
+    uint32_t VertexLayoutRegistry::GetLayoutCount()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return static_cast<uint32_t>(m_Layouts.size());
+    }
+}
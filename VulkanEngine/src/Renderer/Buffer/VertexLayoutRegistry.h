@@ -0,0 +1,26 @@
+#pragma once
+#include "VertexBuffer.h"
+#include <deque>
+#include <mutex>
+
+namespace CHIKU
+{
+    //Every distinct VertexBufferLayout is interned once at import time and referred to
+    //by its index afterwards. Meshes, pipelines and the backend vertex input
+    //descriptions only ever carry the ID, resolving it is a plain array index.
+    class VertexLayoutRegistry
+    {
+    public:
+        static VertexLayoutID Intern(const VertexBufferLayout& layout);
+
+        //IDs are only handed out by Intern so they are always in range. Indexing takes the lock because
+        //workers intern while others read, the deque keeps the returned reference stable afterwards
+        static const VertexBufferLayout& GetLayout(VertexLayoutID id);
+        static uint32_t GetLayoutCount();
+
+    private:
+        static std::deque<VertexBufferLayout> m_Layouts; //index is the VertexLayoutID
+        static std::unordered_map<VertexBufferLayout, VertexLayoutID> m_LayoutIDs;
+        static std::mutex m_Mutex;
+    };
+}
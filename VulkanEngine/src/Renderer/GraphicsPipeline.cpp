@@ -26,10 +26,8 @@ namespace CHIKU
 		return s_Instance->mCreatePipeline(materialAsset, meshAsset);
 	}
 
-	void GraphicsPipeline::BindPipeline(
-		const std::shared_ptr<MaterialAsset>& materialAsset,
-		const std::shared_ptr<MeshAsset>& meshAsset)
+	void GraphicsPipeline::BindPipeline(uint32_t pipelineID, const MaterialAsset& materialAsset, const MeshAsset& meshAsset)
 	{
-		return s_Instance->mBindPipeline(materialAsset, meshAsset);
+		return s_Instance->mBindPipeline(pipelineID, materialAsset, meshAsset);
 	}
 }
\ No newline at end of file
@@ -2,18 +2,26 @@
 #include "Assets/MaterialAsset.h"
 #include "Assets/MeshAsset.h"
 #include "Renderer/Buffer/VertexBuffer.h"
+#include "Renderer/RenderState.h"
 
 namespace CHIKU
 {
+	//A pipeline only depends on the shader, its specialized features, the fixed function state
+	//and the vertex layout. Material parameters live in descriptors and the vertex count is per draw,
+	//so neither of them takes part in the identity of a pipeline.
 	struct PipelineKey
 	{
-		AssetHandle MaterialAssetHandle;
-		VertexBufferMetaData PipelineVertexBufferMetaData;
+		AssetHandle ShaderAssetHandle;
+		RenderState PipelineRenderState;
+		VertexLayoutID VertexLayout;
+		ShaderFeatureMask Features; //Only the features the shader declares
 
 		bool operator==(const PipelineKey& other) const
 		{
-			return MaterialAssetHandle == other.MaterialAssetHandle &&
-				PipelineVertexBufferMetaData == other.PipelineVertexBufferMetaData;
+			return ShaderAssetHandle == other.ShaderAssetHandle &&
+				PipelineRenderState == other.PipelineRenderState &&
+				VertexLayout == other.VertexLayout &&
+				Features == other.Features;
 		}
 	};
 }
@@ -25,8 +33,10 @@ namespace std {
 		std::size_t operator()(const CHIKU::PipelineKey& key) const
 		{
 			std::size_t seed = 0;
-			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::AssetHandle>()(key.MaterialAssetHandle));
-			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::VertexBufferMetaData>()(key.PipelineVertexBufferMetaData));
+			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::AssetHandle>()(key.ShaderAssetHandle));
+			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::RenderState>()(key.PipelineRenderState));
+			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::VertexLayoutID>()(key.VertexLayout));
+			CHIKU::Utils::hash_combine(seed, std::hash<CHIKU::ShaderFeatureMask>()(key.Features));
 			return seed;
 		}
 	};
@@ -36,6 +46,20 @@ namespace CHIKU
 {
 	struct PipelineData;
 
+	//Mirrors the set 0 binding 0 camera block, written once per frame
+	struct CameraUniformData
+	{
+		glm::mat4 View;
+		glm::mat4 Proj;
+	};
+
+	//Mirrors the push_constant block of the engine shaders, pushed per draw
+	struct ObjectPushConstants
+	{
+		glm::mat4 Model;
+		uint32_t MaterialID;
+	};
+
 	class GraphicsPipeline
 	{
 	public:
@@ -46,6 +70,7 @@ namespace CHIKU
 
 		static void Init() { s_Instance->mInit(); }
 		static void CleanUp() { s_Instance->mCleanUp(); }
+		static void Update() { s_Instance->mUpdate(); }
 
 		static PipelineData GetPipeline(
 			const std::shared_ptr<MaterialAsset>& materialAsset,
@@ -55,14 +80,23 @@ namespace CHIKU
 			const std::shared_ptr<MaterialAsset>& materialAsset,
 			const std::shared_ptr<MeshAsset>& meshAsset);
 
-		static void BindPipeline(
-			const std::shared_ptr<MaterialAsset>& materialAsset,
-			const std::shared_ptr<MeshAsset>& meshAsset);
+		//Per draw path, takes the ID GetPipeline resolved so nothing is hashed or reference counted
+		static void BindPipeline(uint32_t pipelineID, const MaterialAsset& materialAsset, const MeshAsset& meshAsset);
+
+		//Writes per draw data into the push constants of the pipeline bound last
+		template<typename T>
+		static void PushConstants(const T& data, uint32_t offset = 0)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "push constant data must be trivially copyable");
+			static_assert(sizeof(T) <= 128, "only 128 bytes of push constants are guaranteed");
+			s_Instance->mPushConstants(&data, static_cast<uint32_t>(sizeof(T)), offset);
+		}
 
 	private:
 		
 		virtual void mInit() = 0;
 		virtual void mCleanUp() = 0;
+		virtual void mUpdate() = 0;
 
 		virtual PipelineData mGetPipeline(
 			const std::shared_ptr<MaterialAsset>& materialAsset, 
@@ -72,8 +106,9 @@ namespace CHIKU
 			const std::shared_ptr<MaterialAsset>& materialAsset, 
 			const std::shared_ptr<MeshAsset>& meshAsset) = 0;
 
-		virtual void mBindPipeline(const std::shared_ptr<MaterialAsset>& materialAsset, 
-			const std::shared_ptr<MeshAsset>& meshAsset) = 0;
+		virtual void mBindPipeline(uint32_t pipelineID, const MaterialAsset& materialAsset, const MeshAsset& meshAsset) = 0;
+
+		virtual void mPushConstants(const void* data, uint32_t size, uint32_t offset) = 0;
 		
 	protected:
 		std::array<UniformSetStorage, DEFAULT_DESCRIPTOR_SET_LAYOUT_BINDING_COUNT> m_GlobalUniformSetStorage; //Key is the set Index>
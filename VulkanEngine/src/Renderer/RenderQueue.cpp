@@ -0,0 +1,259 @@
+#include "RenderQueue.h"
+#include "GraphicsPipeline.h"
+#include "Jobs/JobSystem.h"
+#include "Memory/AllocationTracker.h"
+#include "Memory/Memory.h"
+#include "Assets/ResidencyManager.h"
+
+#include <Vulkan/Renderer/VulkanGraphicsPipelineData.h>
+
+namespace CHIKU
+{
+	//Below this the dispatch overhead outweighs sorting on one thread
+	static constexpr uint32_t ParallelSortThreshold = 4096;
+	static constexpr uint32_t MaxSortChunks = 16;
+	static constexpr uint32_t RadixBuckets = 256;
+
+	static constexpr uint64_t DepthBits = 24;
+	static constexpr uint64_t MaterialBits = 16;
+	static constexpr uint64_t PipelineBits = 20;
+	static constexpr uint64_t PassShift = 60;
+
+	std::vector<DrawPacket> RenderQueue::m_Packets;
+	std::vector<DrawCommand> RenderQueue::m_Commands;
+	RenderQueueStats RenderQueue::m_Stats;
+	glm::mat4 RenderQueue::m_View = glm::mat4(1.0f);
+	float RenderQueue::m_NearPlane = 0.0f;
+	float RenderQueue::m_FarPlane = 1.0f;
+	uint32_t RenderQueue::m_CulledCount = 0;
+
+	void RenderQueue::SetView(const glm::mat4& view, float nearPlane, float farPlane)
+	{
+		m_View = view;
+		m_NearPlane = nearPlane;
+		m_FarPlane = farPlane;
+	}
+
+	void RenderQueue::Submit(const SHARED<MeshAsset>& mesh, const SHARED<MaterialAsset>& material, const glm::mat4& transform)
+	{
+		ZoneScoped;
+
+		//Evicted meshes are restored in the background, their draws are skipped until they are back
+		ResidencyManager::Touch(*mesh);
+		ResidencyManager::Touch(*material);
+		if (!mesh->IsGPUResident())
+			return;
+
+		//Camera looks down -Z in view space
+		glm::mat4 modelView = m_View * transform;
+		float depth = -modelView[3].z;
+
+		const MeshBounds& bounds = mesh->GetBounds();
+		if (bounds.IsValid())
+		{
+			glm::vec3 center = (bounds.Min + bounds.Max) * 0.5f;
+			glm::vec3 extent = (bounds.Max - bounds.Min) * 0.5f;
+
+			//How far the box reaches along the view axis on either side of its center
+			float centerDepth = -(modelView * glm::vec4(center, 1.0f)).z;
+			float depthExtent = glm::dot(glm::abs(glm::vec3(modelView[0].z, modelView[1].z, modelView[2].z)), extent);
+
+			//Boxes that end before the near plane or start past the far plane would be clipped entirely, the same planes as the projection
+			if (centerDepth + depthExtent < m_NearPlane || centerDepth - depthExtent > m_FarPlane)
+			{
+				m_CulledCount++;
+				return;
+			}
+
+			depth = centerDepth;
+		}
+
+		depth /= m_FarPlane;
+
+		//Resolving the pipeline here also creates it, so recording never stalls on a new one
+		uint32_t pipelineID = GraphicsPipeline::GetPipeline(material, mesh).ID;
+
+		RenderPassType pass = material->GetRenderState().BlendEnabled ? Pass_Transparent : Pass_Opaque;
+
+		if (m_Packets.size() == m_Packets.capacity())
+			Grow();
+
+		m_Packets.push_back({ MakeSortKey(pass, pipelineID, material->GetMaterialID(), depth), static_cast<uint32_t>(m_Commands.size()) });
+		m_Commands.push_back({ mesh.get(), material.get(), transform, pipelineID });
+	}
+
+	void RenderQueue::Grow()
+	{
+		ZoneScoped;
+
+		//Capacity is kept across frames, so this only runs while the scene grows
+		AllocationTracker::AllowScope allow;
+
+		size_t capacity = std::max<size_t>(256, m_Packets.capacity() * 2);
+		m_Packets.reserve(capacity);
+		m_Commands.reserve(capacity);
+	}
+
+	uint64_t RenderQueue::MakeSortKey(RenderPassType pass, uint32_t pipelineID, uint32_t materialID, float depth)
+	{
+		const uint64_t depthMax = (1ull << DepthBits) - 1;
+		uint64_t quantizedDepth = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>(depthMax));
+
+		uint64_t pipeline = pipelineID & ((1ull << PipelineBits) - 1);
+		uint64_t material = materialID & ((1ull << MaterialBits) - 1);
+		uint64_t key = static_cast<uint64_t>(pass) << PassShift;
+
+		if (pass == Pass_Transparent)
+		{
+			//Blending needs back to front, state coherence only matters between equal depths
+			key |= (depthMax - quantizedDepth) << (PipelineBits + MaterialBits);
+			key |= pipeline << MaterialBits;
+			key |= material;
+		}
+		else
+		{
+			key |= pipeline << (MaterialBits + DepthBits);
+			key |= material << DepthBits;
+			key |= quantizedDepth;
+		}
+
+		return key;
+	}
+
+	DrawPacket* RenderQueue::RadixSort(DrawPacket* packets, DrawPacket* scratch, uint32_t count)
+	{
+		ZoneScoped;
+
+		if (count < 2)
+			return packets;
+
+		const uint32_t chunkCount = count < ParallelSortThreshold ? 1 : std::min(JobSystem::GetWorkerCount() + 1, MaxSortChunks);
+		const uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+		std::array<std::array<uint32_t, RadixBuckets>, MaxSortChunks> histograms;
+
+		DrawPacket* source = packets;
+		DrawPacket* destination = scratch;
+
+		//LSD, one byte per pass. Chunks are scattered in order so every pass stays stable.
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			JobSystem::Dispatch(chunkCount, [&](uint32_t chunk)
+				{
+					auto& histogram = histograms[chunk];
+					histogram.fill(0);
+
+					uint32_t end = std::min(count, (chunk + 1) * chunkSize);
+					for (uint32_t i = chunk * chunkSize; i < end; i++)
+						histogram[(source[i].SortKey >> shift) & 0xFF]++;
+				});
+
+			//Most high bytes are shared by every key, those passes would only copy
+			bool uniform = false;
+			uint32_t offset = 0;
+			for (uint32_t bucket = 0; bucket < RadixBuckets; bucket++)
+			{
+				uint32_t bucketCount = 0;
+				for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+				{
+					uint32_t chunkBucketCount = histograms[chunk][bucket];
+					histograms[chunk][bucket] = offset;
+					offset += chunkBucketCount;
+					bucketCount += chunkBucketCount;
+				}
+
+				uniform |= bucketCount == count;
+			}
+
+			if (uniform)
+				continue;
+
+			JobSystem::Dispatch(chunkCount, [&](uint32_t chunk)
+				{
+					auto& histogram = histograms[chunk];
+
+					uint32_t end = std::min(count, (chunk + 1) * chunkSize);
+					for (uint32_t i = chunk * chunkSize; i < end; i++)
+						destination[histogram[(source[i].SortKey >> shift) & 0xFF]++] = source[i];
+				});
+
+			std::swap(source, destination);
+		}
+
+		return source;
+	}
+
+	void RenderQueue::CountUnsortedChanges()
+	{
+		const DrawCommand* previous = nullptr;
+		for (const auto& command : m_Commands)
+		{
+			if (!previous || previous->PipelineID != command.PipelineID)
+				m_Stats.PipelineChangesUnsorted++;
+
+			if (!previous || previous->Material != command.Material)
+				m_Stats.MaterialChangesUnsorted++;
+
+			previous = &command;
+		}
+	}
+
+	void RenderQueue::Flush()
+	{
+		ZoneScoped;
+
+		//Culling happens on submit, before the stats of this flush are reset
+		m_Stats = {};
+		m_Stats.DrawCount = static_cast<uint32_t>(m_Packets.size());
+		m_Stats.Culled = m_CulledCount;
+		m_CulledCount = 0;
+
+		CountUnsortedChanges();
+
+		//The ping pong buffer only lives for this flush, the frame arena hands it out without a heap allocation
+		const uint32_t count = m_Stats.DrawCount;
+		DrawPacket* scratch = Memory::GetFrameArena().Allocate<DrawPacket>(count);
+		const DrawPacket* sorted = RadixSort(m_Packets.data(), scratch, count);
+
+		const DrawCommand* previous = nullptr;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const DrawCommand& command = m_Commands[sorted[i].Index];
+
+			bool pipelineChanged = !previous || previous->PipelineID != command.PipelineID;
+			bool materialChanged = !previous || previous->Material != command.Material;
+			bool meshChanged = !previous || previous->Mesh != command.Mesh;
+
+			//Pulled vertices come from a per mesh set, so for those a new mesh means new sets
+			bool setsChanged = materialChanged || (meshChanged && command.Material->GetShader()->UsesVertexPulling());
+
+			if (pipelineChanged || setsChanged)
+			{
+				GraphicsPipeline::BindPipeline(command.PipelineID, *command.Material, *command.Mesh);
+				m_Stats.PipelineChanges += pipelineChanged;
+				m_Stats.MaterialChanges += materialChanged;
+			}
+
+			GraphicsPipeline::PushConstants(ObjectPushConstants{ command.Transform, command.Material->GetMaterialID() });
+
+			if (meshChanged)
+			{
+				command.Mesh->Bind();
+				m_Stats.MeshChanges++;
+			}
+
+			command.Mesh->Draw();
+			previous = &command;
+		}
+
+		TracyPlot("Draws", static_cast<int64_t>(m_Stats.DrawCount));
+		TracyPlot("Culled", static_cast<int64_t>(m_Stats.Culled));
+		TracyPlot("Pipeline Changes Unsorted", static_cast<int64_t>(m_Stats.PipelineChangesUnsorted));
+		TracyPlot("Pipeline Changes", static_cast<int64_t>(m_Stats.PipelineChanges));
+		TracyPlot("Material Changes Unsorted", static_cast<int64_t>(m_Stats.MaterialChangesUnsorted));
+		TracyPlot("Material Changes", static_cast<int64_t>(m_Stats.MaterialChanges));
+
+		m_Packets.clear();
+		m_Commands.clear();
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "Assets/MeshAsset.h"
+#include "Assets/MaterialAsset.h"
+
+namespace CHIKU
+{
+	enum RenderPassType : uint32_t
+	{
+		Pass_Opaque,
+		Pass_Transparent,
+		Pass_Count
+	};
+
+	//What gets sorted, the key alone decides the order and Index points at the draw it stands for.
+	//Opaque:      pass(4) | pipeline(20) | material(16) | depth(24), front to back inside a material
+	//Transparent: pass(4) | inverted depth(24) | pipeline(20) | material(16), back to front
+	struct DrawPacket
+	{
+		uint64_t SortKey;
+		uint32_t Index;
+	};
+
+	//Plain handles only, the assets are owned by the AssetManager and outlive the frame
+	struct DrawCommand
+	{
+		const MeshAsset* Mesh;
+		const MaterialAsset* Material;
+		glm::mat4 Transform;
+		uint32_t PipelineID;
+	};
+
+	//Binds the recorder would have issued in submission order versus the ones it issued after sorting.
+	//Culled counts the draws dropped on submit because their bounds lie outside the near and far planes
+	struct RenderQueueStats
+	{
+		uint32_t DrawCount = 0;
+		uint32_t Culled = 0;
+		uint32_t PipelineChangesUnsorted = 0;
+		uint32_t MaterialChangesUnsorted = 0;
+		uint32_t PipelineChanges = 0;
+		uint32_t MaterialChanges = 0;
+		uint32_t MeshChanges = 0;
+	};
+
+	class RenderQueue
+	{
+	public:
+		//View and the projection's clip planes, used for the depth part of the key and to cull draws outside the depth range
+		static void SetView(const glm::mat4& view, float nearPlane, float farPlane);
+
+		static void Submit(const SHARED<MeshAsset>& mesh, const SHARED<MaterialAsset>& material, const glm::mat4& transform);
+
+		//Sorts the packets of this frame, records them and empties the queue
+		static void Flush();
+
+		static const RenderQueueStats& GetStats() { return m_Stats; }
+
+	private:
+		static uint64_t MakeSortKey(RenderPassType pass, uint32_t pipelineID, uint32_t materialID, float depth);
+		//Returns whichever of the two arrays ended up holding the sorted packets
+		static DrawPacket* RadixSort(DrawPacket* packets, DrawPacket* scratch, uint32_t count);
+		static void CountUnsortedChanges();
+		static void Grow();
+
+	private:
+		static std::vector<DrawPacket> m_Packets;
+		static std::vector<DrawCommand> m_Commands;
+		static RenderQueueStats m_Stats;
+		static glm::mat4 m_View;
+		static float m_NearPlane;
+		static float m_FarPlane;
+		static uint32_t m_CulledCount;
+	};
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "Utils/Utils.h"
+
+namespace CHIKU
+{
+	enum class CullMode : uint8_t
+	{
+		None,
+		Front,
+		Back,
+		FrontAndBack
+	};
+
+	enum class FrontFace : uint8_t
+	{
+		CounterClockwise,
+		Clockwise
+	};
+
+	enum class PolygonMode : uint8_t
+	{
+		Fill,
+		Line,
+		Point
+	};
+
+	enum class PrimitiveTopology : uint8_t
+	{
+		PointList,
+		LineList,
+		LineStrip,
+		TriangleList,
+		TriangleStrip,
+		TriangleFan
+	};
+
+	//Fixed function state a material asks for, resolved once from the material
+	//config strings so pipeline lookups never touch a string
+	struct RenderState
+	{
+		CullMode Cull = CullMode::Back;
+		FrontFace Front = FrontFace::CounterClockwise;
+		PolygonMode Polygon = PolygonMode::Fill;
+		PrimitiveTopology Topology = PrimitiveTopology::TriangleList;
+		bool DepthTest = true;
+		bool DepthWrite = true;
+		bool BlendEnabled = false;
+
+		bool operator==(const RenderState& other) const
+		{
+			return Cull == other.Cull &&
+				Front == other.Front &&
+				Polygon == other.Polygon &&
+				Topology == other.Topology &&
+				DepthTest == other.DepthTest &&
+				DepthWrite == other.DepthWrite &&
+				BlendEnabled == other.BlendEnabled;
+		}
+
+		//Every field fits in a byte, packing them gives a cheap hash and sort key
+		uint64_t Pack() const
+		{
+			return  static_cast<uint64_t>(Cull)
+				| (static_cast<uint64_t>(Front) << 8)
+				| (static_cast<uint64_t>(Polygon) << 16)
+				| (static_cast<uint64_t>(Topology) << 24)
+				| (static_cast<uint64_t>(DepthTest) << 32)
+				| (static_cast<uint64_t>(DepthWrite) << 40)
+				| (static_cast<uint64_t>(BlendEnabled) << 48);
+		}
+	};
+
+	inline CullMode CullModeFromString(const std::string& str)
+	{
+		if (str == "VK_CULL_MODE_NONE"			)	return CullMode::None;
+		if (str == "VK_CULL_MODE_FRONT_BIT"		)	return CullMode::Front;
+		if (str == "VK_CULL_MODE_BACK_BIT"		)	return CullMode::Back;
+		if (str == "VK_CULL_MODE_FRONT_AND_BACK")	return CullMode::FrontAndBack;
+
+		return CullMode::Back;
+	}
+
+	inline FrontFace FrontFaceFromString(const std::string& str)
+	{
+		if (str == "VK_FRONT_FACE_COUNTER_CLOCKWISE")	return FrontFace::CounterClockwise;
+		if (str == "VK_FRONT_FACE_CLOCKWISE"		)	return FrontFace::Clockwise;
+
+		return FrontFace::CounterClockwise;
+	}
+
+	inline PolygonMode PolygonModeFromString(const std::string& str)
+	{
+		if (str == "VK_POLYGON_MODE_FILL"	)	return PolygonMode::Fill;
+		if (str == "VK_POLYGON_MODE_LINE"	)	return PolygonMode::Line;
+		if (str == "VK_POLYGON_MODE_POINT"	)	return PolygonMode::Point;
+
+		return PolygonMode::Fill;
+	}
+
+	inline PrimitiveTopology PrimitiveTopologyFromString(const std::string& str)
+	{
+		if (str == "VK_PRIMITIVE_TOPOLOGY_POINT_LIST"		)	return PrimitiveTopology::PointList;
+		if (str == "VK_PRIMITIVE_TOPOLOGY_LINE_LIST"		)	return PrimitiveTopology::LineList;
+		if (str == "VK_PRIMITIVE_TOPOLOGY_LINE_STRIP"		)	return PrimitiveTopology::LineStrip;
+		if (str == "VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST"	)	return PrimitiveTopology::TriangleList;
+		if (str == "VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP"	)	return PrimitiveTopology::TriangleStrip;
+		if (str == "VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN"		)	return PrimitiveTopology::TriangleFan;
+
+		return PrimitiveTopology::TriangleList;
+	}
+}
+
+namespace std
+{
+	template<>
+	struct hash<CHIKU::RenderState>
+	{
+		size_t operator()(const CHIKU::RenderState& state) const
+		{
+			return std::hash<uint64_t>()(state.Pack());
+		}
+	};
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "Window.h"
+#include "Memory/AllocationTracker.h"
+#include "Memory/Memory.h"
 
 #define VULKAN_RENDERER "VulkanRenderer"
 #define OPENXR_RENDERER "OpenXRVulkanRenderer"
@@ -30,8 +32,18 @@ namespace CHIKU
 		static void CleanUp() { s_Instance->mCleanUp(); }
 		static void Wait() { s_Instance->mWait(); }
 
-		static void BeginFrame() { s_Instance->mBeginFrame(); }
-		static void EndFrame() { s_Instance->mEndFrame(); }
+		//Everything recorded between these two has to stay off the heap, see AllocationTracker
+		static void BeginFrame() 
+		{ 
+			s_Instance->mBeginFrame(); 
+			Memory::ResetFrameArena();
+			AllocationTracker::BeginFrame();
+		}
+		static void EndFrame() 
+		{ 
+			AllocationTracker::EndFrame();
+			s_Instance->mEndFrame(); 
+		}
 		static void RecreateSwapChain() { s_Instance->mRecreateSwapChain(); }
 
 		static void* GetGraphicsBinding() { return s_Instance->mGetGraphicsBinding(); }
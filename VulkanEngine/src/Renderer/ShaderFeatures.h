@@ -0,0 +1,54 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Renderer/Buffer/UniformBuffer.h"
+#include <string_view>
+
+namespace CHIKU
+{
+	//Material features a shader can be specialized on. Each one is a bool specialization
+	//constant in the shader, so one source covers every variant and the driver drops dead branches.
+	enum ShaderFeature : uint32_t
+	{
+		Feature_NormalMap,
+		Feature_AlphaMask,
+		Feature_Emissive,
+		Feature_VertexColor,
+		Feature_Count
+	};
+
+	using ShaderFeatureMask = uint32_t;
+
+	//Name of the specialization constant in GLSL
+	constexpr std::array<std::string_view, Feature_Count> ShaderFeatureConstantNames = {
+		"HAS_NORMAL_MAP", "HAS_ALPHA_MASK", "HAS_EMISSIVE", "HAS_VERTEX_COLOR"
+	};
+
+	//Key in the "Features" object of a material file
+	constexpr std::array<std::string_view, Feature_Count> ShaderFeatureMaterialNames = {
+		"normalMap", "alphaMask", "emissive", "vertexColor"
+	};
+
+	//Reflected constant_id of a feature and the stages that declare it
+	struct SpecializationConstantInfo
+	{
+		uint32_t ConstantID;
+		ShaderFeature Feature;
+		ShaderStageBits Stages;
+	};
+
+	inline ShaderFeature ShaderFeatureFromConstantName(std::string_view name)
+	{
+		for (uint32_t i = 0; i < Feature_Count; i++)
+		{
+			if (ShaderFeatureConstantNames[i] == name)
+				return static_cast<ShaderFeature>(i);
+		}
+
+		return Feature_Count;
+	}
+
+	inline bool HasFeature(ShaderFeatureMask mask, ShaderFeature feature)
+	{
+		return (mask & (1u << feature)) != 0;
+	}
+}
@@ -0,0 +1,80 @@
+#include "UploadQueue.h"
+#include <chrono>
+
+namespace CHIKU
+{
+	ScheduledJob* UploadQueue::m_Head = nullptr;
+	ScheduledJob* UploadQueue::m_Tail = nullptr;
+	uint32_t UploadQueue::m_PendingCount = 0;
+	std::mutex UploadQueue::m_Mutex;
+
+	void UploadQueue::Schedule(ScheduledJob* job)
+	{
+		job->Next = nullptr;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Tail)
+			m_Tail->Next = job;
+		else
+			m_Head = job;
+		m_Tail = job;
+		m_PendingCount++;
+	}
+
+	void UploadQueue::Pump(float budgetMilliseconds)
+	{
+		ZoneScoped;
+
+		//Detach what is queued right now, a resumed load that queues itself again has to wait a frame
+		ScheduledJob* job = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			job = m_Head;
+			m_Head = nullptr;
+			m_Tail = nullptr;
+			m_PendingCount = 0;
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+		uint32_t uploads = 0;
+
+		while (job)
+		{
+			ScheduledJob* next = job->Next;
+			job->Run(job);
+			job = next;
+			uploads++;
+
+			float elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			if (elapsed >= budgetMilliseconds)
+				break;
+		}
+
+		TracyPlot("Upload Queue Jobs", static_cast<int64_t>(uploads));
+
+		if (!job)
+			return;
+
+		//Out of budget, whatever is left goes back in front of work queued since
+		ScheduledJob* last = job;
+		uint32_t remaining = 1;
+		while (last->Next)
+		{
+			last = last->Next;
+			remaining++;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		last->Next = m_Head;
+		m_Head = job;
+		if (!m_Tail)
+			m_Tail = last;
+		m_PendingCount += remaining;
+	}
+
+	uint32_t UploadQueue::GetPendingCount()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_PendingCount;
+	}
+}
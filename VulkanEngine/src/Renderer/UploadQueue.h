@@ -0,0 +1,30 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Jobs/Async.h"
+#include <mutex>
+
+namespace CHIKU
+{
+	//Work that has to touch the GPU from the main thread, mostly the tail end of asset loads.
+	//Anything can queue into it, it only drains when the main thread pumps it once per frame outside of recording.
+	class UploadQueue
+	{
+	public:
+		static void Schedule(ScheduledJob* job);
+
+		//Runs queued work until the queue is empty or the budget is spent, at least one job always runs.
+		//Work queued while pumping waits for the next pump.
+		static void Pump(float budgetMilliseconds = 2.0f);
+
+		static uint32_t GetPendingCount();
+
+	private:
+		static ScheduledJob* m_Head;
+		static ScheduledJob* m_Tail;
+		static uint32_t m_PendingCount;
+		static std::mutex m_Mutex;
+	};
+
+	//co_await ResumeOnUploadQueue() moves the rest of the coroutine onto the main thread at the next pump
+	inline ScheduleAwaiter<UploadQueue> ResumeOnUploadQueue() { return {}; }
+}
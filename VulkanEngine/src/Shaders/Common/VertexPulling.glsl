@@ -0,0 +1,69 @@
+//Vertex fetch for shaders that read their vertices from storage buffers.
+//Must match VertexLayoutEntry and VERTEX_PULLING_DESCRIPTOR_SET on the engine side.
+
+#define VERTEX_COMPONENT_FLOAT 0u
+#define VERTEX_COMPONENT_INT   1u
+#define VERTEX_COMPONENT_BYTE  2u
+#define VERTEX_COMPONENT_SHORT 3u
+
+layout(std430, set = 2, binding = 0) readonly buffer VertexLayout {
+    uint ElementCount;
+    uint Stride;
+    uint Offsets[8];
+    uint Formats[8];
+} vertexLayout;
+
+layout(std430, set = 2, binding = 1) readonly buffer VertexData {
+    uint Words[];
+} vertexData;
+
+uint LoadByte(uint address)
+{
+    return (vertexData.Words[address >> 2] >> ((address & 3u) * 8u)) & 0xFFu;
+}
+
+uint LoadShort(uint address)
+{
+    return LoadByte(address) | (LoadByte(address + 1u) << 8);
+}
+
+//Short components are signed (R16_SINT on the input assembler path), so widen with the sign bit
+int LoadSignedShort(uint address)
+{
+    return bitfieldExtract(int(LoadShort(address)), 0, 16);
+}
+
+uint LoadWord(uint address)
+{
+    if ((address & 3u) == 0u)
+        return vertexData.Words[address >> 2];
+
+    return LoadShort(address) | (LoadShort(address + 2u) << 16);
+}
+
+//Returns the attribute at the given location widened to a vec4, missing components default to (0,0,0,1)
+vec4 FetchAttribute(uint location, uint vertexIndex)
+{
+    vec4 value = vec4(0.0, 0.0, 0.0, 1.0);
+    if (location >= vertexLayout.ElementCount)
+        return value;
+
+    uint format = vertexLayout.Formats[location];
+    uint componentType = format & 0xFFu;
+    uint componentCount = (format >> 8) & 0xFFu;
+    uint address = vertexIndex * vertexLayout.Stride + vertexLayout.Offsets[location];
+
+    for (uint i = 0u; i < componentCount; i++)
+    {
+        if (componentType == VERTEX_COMPONENT_FLOAT)
+            value[i] = uintBitsToFloat(LoadWord(address + i * 4u));
+        else if (componentType == VERTEX_COMPONENT_INT)
+            value[i] = float(int(LoadWord(address + i * 4u)));
+        else if (componentType == VERTEX_COMPONENT_BYTE)
+            value[i] = float(LoadByte(address + i)) / 255.0;
+        else if (componentType == VERTEX_COMPONENT_SHORT)
+            value[i] = float(LoadSignedShort(address + i * 2u));
+    }
+
+    return value;
+}
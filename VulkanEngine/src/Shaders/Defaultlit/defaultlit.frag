@@ -3,13 +3,35 @@
 
 #version 450
 
-layout(set = 1, binding = 0) uniform MeshColor
+//Material features, set per pipeline from the material so disabled paths are compiled out.
+//Only features the shader reads are declared, every declared one splits the pipelines built from it.
+layout(constant_id = 0) const bool HAS_ALPHA_MASK = false;
+
+//Padded to MATERIAL_RECORD_STRIDE, shared by every material in the table
+struct MaterialRecord
 {
     vec4 u_Color;
-} fragColor;
+    float u_AlphaCutoff;
+    float u_Reserved0[3];
+    vec4 u_Reserved[2];
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer MaterialTable
+{
+    MaterialRecord records[];
+} materials;
+
+layout(push_constant) uniform ObjectPushConstants
+{
+    layout(offset = 64) uint u_MaterialID;
+} object;
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = fragColor.u_Color;
+    MaterialRecord record = materials.records[object.u_MaterialID];
+    outColor = record.u_Color;
+
+    if (HAS_ALPHA_MASK && outColor.a < record.u_AlphaCutoff)
+        discard;
 }
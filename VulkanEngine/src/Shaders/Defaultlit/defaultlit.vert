@@ -6,11 +6,14 @@
 layout(location = 0) in vec3 inPosition;
 
 layout(set = 0,binding = 0) uniform UniformBufferObject {
-    mat4 u_Model;
     mat4 u_View;
     mat4 u_Proj;
 } ubo;
 
+layout(push_constant) uniform ObjectPushConstants {
+    mat4 u_Model;
+} object;
+
 void main() {
-    gl_Position = ubo.u_Proj * ubo.u_View * ubo.u_Model * vec4(inPosition, 1.0);
+    gl_Position = ubo.u_Proj * ubo.u_View * object.u_Model * vec4(inPosition, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+//Name: Defaultlit
+//Type: Vertex
+
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "../Common/VertexPulling.glsl"
+
+layout(set = 0,binding = 0) uniform UniformBufferObject {
+    mat4 u_View;
+    mat4 u_Proj;
+} ubo;
+
+layout(push_constant) uniform ObjectPushConstants {
+    mat4 u_Model;
+} object;
+
+void main() {
+    vec3 inPosition = FetchAttribute(0u, uint(gl_VertexIndex)).xyz;
+    gl_Position = ubo.u_Proj * ubo.u_View * object.u_Model * vec4(inPosition, 1.0);
+}
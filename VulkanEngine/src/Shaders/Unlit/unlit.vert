@@ -4,11 +4,14 @@
 #version 450
 
 layout(set = 0,binding = 0) uniform UniformBufferObject {
-    mat4 u_Model;
     mat4 u_View;
     mat4 u_Proj;
 } ubo;
 
+layout(push_constant) uniform ObjectPushConstants {
+    mat4 u_Model;
+} object;
+
 layout (set = 0,binding = 1) uniform Color {
    vec3 inColor;
 } cor;
@@ -20,7 +23,7 @@ layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 
 void main() {
-    gl_Position = ubo.u_Proj * ubo.u_View * ubo.u_Model * vec4(inPosition, 1.0);
+    gl_Position = ubo.u_Proj * ubo.u_View * object.u_Model * vec4(inPosition, 1.0);
     fragColor = cor.inColor;
     fragTexCoord = vec2(inTexCoord.x,inTexCoord.y);
 }
\ No newline at end of file
@@ -2,21 +2,64 @@
 #include "EngineHeader.h"
 #include <random>
 #include <cstdint>
+#include <string>
+#include <string_view>
 
 namespace CHIKU
 {
 	namespace Utils
 	{
-		static std::random_device  m_RandomDevice;
-		static std::mt19937_64 m_Range;
+		//One engine per thread, seeded once. Being an inline function every translation unit shares it
+		inline std::mt19937_64& GetRandomEngine()
+		{
+			static thread_local std::mt19937_64 engine(std::random_device{}());
+			return engine;
+		}
 
 		template<typename T>
 		T GetRandomNumber()
 		{
 			ZoneScoped;
 
-			std::uniform_int_distribution<uint64_t> dist;
-			return dist(m_Range);
+			std::uniform_int_distribution<T> dist;
+			return dist(GetRandomEngine());
+		}
+
+		//64 bit FNV-1a, stable across runs and platforms so it can be written to disk
+		inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			uint64_t hash = seed;
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		inline uint64_t HashString(std::string_view str, uint64_t seed = 14695981039346656037ull)
+		{
+			return HashBytes(str.data(), str.size(), seed);
+		}
+
+		//glTF URIs are percent encoded, the files on disk are not
+		inline std::string DecodeURI(const std::string& uri)
+		{
+			std::string decoded;
+			for (size_t i = 0; i < uri.size(); i++)
+			{
+				if (uri[i] == '%' && i + 2 < uri.size())
+				{
+					decoded.push_back(static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16)));
+					i += 2;
+				}
+				else
+				{
+					decoded.push_back(uri[i]);
+				}
+			}
+			return decoded;
 		}
 
 		// hash_combine helper